@@ -21,10 +21,13 @@
     #endif /* SLIC3R_GUI */
 #endif /* WIN32 */
 
+#include <chrono>
 #include <cstdio>
+#include <sstream>
 #include <string>
 #include <cstring>
 #include <iostream>
+#include <optional>
 #include <math.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
@@ -36,6 +39,8 @@
 #include <boost/nowide/iostream.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 #include "unix/fhs.hpp"  // Generated by CMake from ../platform/unix/fhs.hpp.in
 
@@ -354,6 +359,8 @@ int CLI::run(int argc, char **argv)
     m_print_config.apply(m_extra_config, true);
     // Normalizing after importing the 3MFs / AMFs
     m_print_config.normalize_fdm();
+    // Batch jobs compose their configs from the one given on the command line, before it is completed by the defaults.
+    const DynamicPrintConfig print_config_cli = m_print_config;
 
     if (printer_technology == ptUnknown)
         printer_technology = std::find(m_actions.begin(), m_actions.end(), "export_sla") == m_actions.end() ? ptFFF : ptSLA;
@@ -618,6 +625,13 @@ int CLI::run(int argc, char **argv)
         } else if (opt_key == "export_3mf") {
             if (! this->export_models(IO::TMF))
                 return 1;
+        } else if (opt_key == "batch") {
+            if (printer_technology != ptFFF) {
+                boost::nowide::cerr << "error: batch slicing is supported for FFF configurations only" << std::endl;
+                return 1;
+            }
+            if (! this->process_batch(m_config.opt_string("batch"), print_config_cli))
+                return 1;
         } else if (opt_key == "export_gcode" || opt_key == "export_sla" || opt_key == "slice") {
             if (opt_key == "export_gcode" && printer_technology == ptSLA) {
                 boost::nowide::cerr << "error: cannot export G-code for an FFF configuration" << std::endl;
@@ -661,6 +675,8 @@ int CLI::run(int argc, char **argv)
                 if (printer_technology == ptFFF) {
                     for (auto* mo : model.objects)
                         fff_print.auto_assign_extruders(mo);
+                    if (const ConfigOptionString *opt_slice_cache = m_config.opt<ConfigOptionString>("slice_cache"); opt_slice_cache != nullptr)
+                        fff_print.set_slice_cache_dir(opt_slice_cache->value);
                 }
                 print->apply(model, m_print_config);
                 std::string err = print->validate();
@@ -673,6 +689,16 @@ int CLI::run(int argc, char **argv)
                 else
                     try {
                         std::string outfile_final;
+                        // Write the SLA archive while rasterizing rather than keeping all the layers in memory,
+                        // unless its name depends on the print statistics, which are only known after processing.
+                        std::string outfile_streamed;
+                        if (printer_technology == ptSLA) {
+                            outfile_streamed = sla_print.output_filepath(outfile);
+                            if (sla_print.print_statistics().finalize_output_path(outfile_streamed) == outfile_streamed)
+                                sla_print.set_streaming_export(outfile_streamed);
+                            else
+                                outfile_streamed.clear();
+                        }
                         print->process();
                         if (printer_technology == ptFFF) {
 
@@ -738,9 +764,10 @@ int CLI::run(int argc, char **argv)
                             outfile = fff_print.export_gcode(outfile, nullptr, thumbnail_generator_cli);
                             outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
                         } else {
-                            outfile = sla_print.output_filepath(outfile);
+                            outfile = outfile_streamed.empty() ? sla_print.output_filepath(outfile) : outfile_streamed;
                             // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
                             outfile_final = sla_print.print_statistics().finalize_output_path(outfile);
+                            // No-op if the archive was already streamed into outfile_final.
                             sla_print.export_print(outfile_final);
                         }
                         if (outfile != outfile_final) {
@@ -1037,6 +1064,195 @@ bool CLI::export_models(IO::ExportFormat format)
     return true;
 }
 
+bool CLI::process_batch(const std::string &jobs_path, const DynamicPrintConfig &print_config_cli)
+{
+    namespace pt = boost::property_tree;
+
+    // The transform options are applied by CLI::run() to the input files of the command line only.
+    // Reject them rather than slicing the jobs differently than one by one.
+    for (const std::string &opt_key : m_transforms)
+        if (opt_key != "dont_arrange" && opt_key != "ensure_on_bed") {
+            boost::nowide::cerr << "error: transform option \"" << opt_key << "\" is not supported by batch slicing" << std::endl;
+            return false;
+        }
+
+    const ForwardCompatibilitySubstitutionRule config_substitution_rule = m_config.option<ConfigOptionEnum<ForwardCompatibilitySubstitutionRule>>("config_compatibility", true)->value;
+    // As in CLI::run(), the config embedded in the input files is ignored if the config is given by profiles.
+    const bool has_config_from_profiles = m_profiles_sharing.empty() &&
+                                          (! m_config.opt_string("print-profile").empty()                             ||
+                                           ! m_config.option<ConfigOptionStrings>("material-profile")->values.empty() ||
+                                           ! m_config.opt_string("printer-profile").empty());
+
+    // A single Print is reused by all the jobs, so that Print::apply() keeps whatever is not invalidated by the next job.
+    Print fff_print;
+    if (const ConfigOptionString *opt_slice_cache = m_config.opt<ConfigOptionString>("slice_cache"); opt_slice_cache != nullptr)
+        fff_print.set_slice_cache_dir(opt_slice_cache->value);
+    // Model of the last job. If the next job slices the same input files, the model is reused and the sliced objects
+    // are kept by Print::apply() unless invalidated by the configuration of the next job.
+    Model                    model;
+    std::vector<std::string> model_input_files;
+    // Config embedded in the 3MF / AMF input files of the model.
+    DynamicPrintConfig       model_config;
+    // The model was loaded from a 3MF, its objects are placed already.
+    bool                     model_placed = false;
+    // Bed shape and object distance the model was arranged for. Jobs may load another printer or print profile,
+    // then the reused model is arranged again.
+    std::optional<std::pair<Points, double>> model_arrangement;
+
+    // Value of a job parameter, which is either a single string or an array of strings.
+    auto job_strings = [](const pt::ptree &job, const std::string &key) {
+        std::vector<std::string> out;
+        const pt::ptree &value = job.get_child(key, pt::ptree());
+        if (value.empty()) {
+            if (! value.data().empty())
+                out.emplace_back(value.data());
+        } else
+            for (const auto &kvp : value)
+                out.emplace_back(kvp.second.data());
+        return out;
+    };
+
+    size_t num_jobs   = 0;
+    size_t num_failed = 0;
+    auto process_job = [&](const pt::ptree &job) {
+        const size_t job_idx = ++ num_jobs;
+        auto t_start = std::chrono::steady_clock::now();
+        try {
+            std::vector<std::string> input_files = job_strings(job, "input");
+            if (input_files.empty())
+                throw Slic3r::RuntimeError("No input file");
+            std::string outfile = job.get<std::string>("output", m_config.opt_string("output"));
+
+            if (input_files != model_input_files) {
+                model.clear_objects();
+                model_input_files.clear();
+                model_config.clear();
+                model_placed = false;
+                for (const std::string &file : input_files) {
+                    Model loaded;
+                    if (has_config_from_profiles)
+                        loaded = Model::read_from_file(file, nullptr, nullptr, Model::LoadAttribute::AddDefaultInstances);
+                    else {
+                        DynamicPrintConfig        file_config;
+                        ConfigSubstitutionContext file_substitutions(config_substitution_rule);
+                        loaded = Model::read_from_file(file, &file_config, &file_substitutions, Model::LoadAttribute::AddDefaultInstances);
+                        if (get_printer_technology(file_config) == ptSLA)
+                            throw Slic3r::RuntimeError(file + ": batch slicing is supported for FFF configurations only");
+                        // The config of an input file is overridden by the ones of the input files before it, as in CLI::run().
+                        file_config += std::move(model_config);
+                        model_config = std::move(file_config);
+                    }
+                    if (boost::algorithm::iends_with(file, ".3mf") || boost::algorithm::iends_with(file, ".zip"))
+                        model_placed = true;
+                    for (ModelObject *o : loaded.objects)
+                        model.add_object(*o);
+                }
+                if (model.objects.empty())
+                    throw Slic3r::RuntimeError("Nothing to slice");
+                if (m_config.opt_bool("ensure_on_bed"))
+                    for (ModelObject *o : model.objects)
+                        o->ensure_on_bed();
+                for (ModelObject *o : model.objects)
+                    fff_print.auto_assign_extruders(o);
+                model_input_files = input_files;
+                model_arrangement.reset();
+            }
+
+            // Job configuration, composed as by CLI::run(): the config embedded in the input files, overridden by the configuration
+            // of the command line, by the job's config files and key / value pairs, and completed by the defaults.
+            DynamicPrintConfig config = model_config;
+            config += print_config_cli;
+            for (const std::string &file : job_strings(job, "load")) {
+                DynamicPrintConfig loaded;
+                loaded.load(file, config_substitution_rule);
+                loaded.normalize_fdm();
+                config.apply(loaded);
+            }
+            ConfigSubstitutionContext config_substitutions(config_substitution_rule);
+            for (const auto &kvp : job.get_child("config", pt::ptree()))
+                config.set_deserialize(kvp.first, kvp.second.data(), config_substitutions);
+            config.normalize_fdm();
+            config.option<ConfigOptionEnum<PrinterTechnology>>("printer_technology", true)->value = ptFFF;
+            {
+                FullPrintConfig fff_print_config;
+                fff_print_config.apply(config, true);
+                config.apply(fff_print_config, true);
+            }
+            if (std::string validity = config.validate(); ! validity.empty())
+                throw Slic3r::RuntimeError("The composite configation is not valid: " + validity);
+
+            // The geometry of a 3MF is placed already, it is not arranged, as in CLI::run().
+            if (! m_config.opt_bool("dont_arrange") && ! model_placed) {
+                std::pair<Points, double> arrangement{ get_bed_shape(config), min_object_distance(config) };
+                if (model_arrangement != arrangement) {
+                    arrange_objects(model, config);
+                    model_arrangement = std::move(arrangement);
+                }
+            }
+
+            fff_print.apply(model, config);
+            if (std::string err = fff_print.validate(); ! err.empty())
+                throw Slic3r::RuntimeError(err);
+            if (fff_print.empty())
+                throw Slic3r::RuntimeError("Nothing to print. Either the print is empty or no object is fully inside the print volume.");
+            fff_print.process();
+            // The outfile is processed by a PlaceholderParser.
+            outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
+            std::string outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
+            if (outfile != outfile_final) {
+                if (Slic3r::rename_file(outfile, outfile_final))
+                    throw Slic3r::RuntimeError("Renaming file " + outfile + " to " + outfile_final + " failed");
+                outfile = outfile_final;
+            }
+            // Run the post-processing scripts if defined.
+            run_post_process_scripts(outfile, fff_print.full_print_config());
+            boost::nowide::cout << "Job " << job_idx << ": Slicing result exported to " << outfile << " in " <<
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() << " s" << std::endl;
+        } catch (const std::exception &ex) {
+            boost::nowide::cerr << "Job " << job_idx << " failed: " << ex.what() << std::endl;
+            ++ num_failed;
+            // Don't let a failing job influence the next one.
+            model.clear_objects();
+            model_input_files.clear();
+            model_config.clear();
+        }
+    };
+
+    if (jobs_path == "-") {
+        // Line protocol: one job in JSON format per line, until an empty line or end of file.
+        std::string line;
+        while (std::getline(boost::nowide::cin, line) && ! line.empty()) {
+            pt::ptree job;
+            try {
+                std::istringstream iss(line);
+                pt::read_json(iss, job);
+            } catch (const std::exception &ex) {
+                boost::nowide::cerr << "Job " << ++ num_jobs << " is invalid: " << ex.what() << std::endl;
+                ++ num_failed;
+                continue;
+            }
+            process_job(job);
+        }
+    } else {
+        pt::ptree jobs;
+        try {
+            boost::nowide::ifstream ifs(jobs_path);
+            if (! ifs)
+                throw Slic3r::RuntimeError("Cannot open file");
+            pt::read_json(ifs, jobs);
+        } catch (const std::exception &ex) {
+            boost::nowide::cerr << "Error while reading batch file \"" << jobs_path << "\": " << ex.what() << std::endl;
+            return false;
+        }
+        // Either an array of jobs or an object containing "jobs" array.
+        for (const auto &kvp : jobs.get_child("jobs", jobs))
+            process_job(kvp.second);
+    }
+
+    boost::nowide::cout << "Batch finished: " << num_jobs - num_failed << " of " << num_jobs << " jobs succeeded." << std::endl;
+    return num_failed == 0;
+}
+
 std::string CLI::output_filepath(const Model &model, IO::ExportFormat format) const
 {
     std::string ext;
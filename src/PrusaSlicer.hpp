@@ -37,6 +37,11 @@ private:
     
     /// Exports loaded models to a file of the specified format, according to the options affecting output filename.
     bool export_models(IO::ExportFormat format);
+
+    /// Slices jobs listed in a JSON file (or read from stdin line by line) by a single Print, which is reused between the jobs.
+    /// The job configs are composed from print_config_cli, the print config of the command line not completed by the defaults.
+    /// Returns false if any of the jobs failed.
+    bool process_batch(const std::string &jobs_path, const DynamicPrintConfig &print_config_cli);
     
     bool has_print_action() const { return m_config.opt_bool("export_gcode") || m_config.opt_bool("export_sla"); }
 
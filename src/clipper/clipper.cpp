@@ -766,8 +766,8 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1))
     return false;
 
-  // Allocate a new edge array.
-  Edges edges(highI + 1);
+  // Allocate a new edge array or reuse one released by Clear().
+  Edges edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
@@ -956,9 +956,30 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 }
 //------------------------------------------------------------------------------
 
+ClipperBase::Edges ClipperBase::AllocateEdges(size_t num_edges)
+{
+  Edges edges;
+  if (! m_edgesFree.empty()) {
+    edges = std::move(m_edgesFree.back());
+    m_edgesFree.pop_back();
+    edges.clear();
+  }
+  edges.resize(num_edges);
+  return edges;
+}
+
 void ClipperBase::Clear()
 {
   m_MinimaList.clear();
+  // Retain the edge vectors for reuse, but don't hold more than MaxRetainedEdges.
+  size_t num_retained = 0;
+  for (const Edges &edges : m_edgesFree)
+    num_retained += edges.capacity();
+  for (Edges &edges : m_edges)
+    if (num_retained + edges.capacity() <= MaxRetainedEdges) {
+      num_retained += edges.capacity();
+      m_edgesFree.emplace_back(std::move(edges));
+    }
   m_edges.clear();
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
@@ -1041,6 +1062,7 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunksUsed(0),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkLast(m_OutPtsChunkSize),
   m_ActiveEdges(nullptr),
@@ -1059,7 +1081,7 @@ Clipper::Clipper(int initOptions) :
 void Clipper::Reset()
 {
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt, cInts>{};
+  m_Scanbeam.clear();
   m_Maxima.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
@@ -1174,19 +1196,23 @@ OutPt* Clipper::AllocateOutPt()
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
     // Get a point from the last chunk.
-    pt = &m_OutPts.back()[m_OutPtsChunkLast ++];
+    pt = &m_OutPts[m_OutPtsChunksUsed - 1][m_OutPtsChunkLast ++];
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.emplace_back();
+    // The last chunk is full. Take a chunk retained from the previous operation or allocate a new one.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.emplace_back();
     m_OutPtsChunkLast = 1;
-    pt = &m_OutPts.back().front();
+    pt = &m_OutPts[m_OutPtsChunksUsed ++].front();
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  m_OutPts.clear();
+  // Keep the chunks of output points for the following operation, but don't hold more than m_OutPtsMaxRetainedChunks.
+  if (m_OutPts.size() > m_OutPtsMaxRetainedChunks)
+    m_OutPts.resize(m_OutPtsMaxRetainedChunks);
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
@@ -3359,20 +3385,47 @@ DoublePoint GetUnitNormal(const IntPoint &pt1, const IntPoint &pt2)
 // ClipperOffset class
 //------------------------------------------------------------------------------
 
+ClipperOffset::~ClipperOffset()
+{
+  Clear();
+  for (PolyNode *node : m_polyNodesFree)
+    delete node;
+}
+//------------------------------------------------------------------------------
+
 void ClipperOffset::Clear()
 {
-  for (int i = 0; i < m_polyNodes.ChildCount(); ++i)
-    delete m_polyNodes.Childs[i];
+  // Keep the nodes and their contours for reuse by AddPath(), but don't hold more than MaxRetainedPoints.
+  size_t num_retained = 0;
+  for (const PolyNode *node : m_polyNodesFree)
+    num_retained += node->Contour.capacity();
+  for (PolyNode *node : m_polyNodes.Childs)
+    if (num_retained + node->Contour.capacity() <= MaxRetainedPoints) {
+      num_retained += node->Contour.capacity();
+      m_polyNodesFree.emplace_back(node);
+    } else
+      delete node;
   m_polyNodes.Childs.clear();
   m_lowest.x() = -1;
 }
 //------------------------------------------------------------------------------
 
+PolyNode* ClipperOffset::AllocateNode()
+{
+  if (m_polyNodesFree.empty())
+    return new PolyNode();
+  PolyNode *node = m_polyNodesFree.back();
+  m_polyNodesFree.pop_back();
+  node->Contour.clear();
+  return node;
+}
+//------------------------------------------------------------------------------
+
 void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType)
 {
   int highI = (int)path.size() - 1;
   if (highI < 0) return;
-  PolyNode* newNode = new PolyNode();
+  PolyNode* newNode = AllocateNode();
   newNode->m_jointype = joinType;
   newNode->m_endtype = endType;
 
@@ -3412,7 +3465,7 @@ void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType
   }
   if (endType == etClosedPolygon && j < 2)
   {
-    delete newNode;
+    m_polyNodesFree.emplace_back(newNode);
     return;
   }
   m_polyNodes.AddChild(*newNode);
@@ -3465,7 +3518,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3486,6 +3541,8 @@ void ClipperOffset::Execute(Paths& solution, double delta)
     if (! solution.empty())
       solution.erase(solution.begin());
   }
+  // Release the edges for the next Execute().
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3496,7 +3553,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3517,6 +3576,8 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
     //remove the outer PolyNode rectangle ...
     solution.RemoveOutermostPolygon();
   }
+  // Release the edges for the next Execute().
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -115,9 +115,14 @@ using DoublePoint = Eigen::Matrix<double, 2, 1, Eigen::DontAlign>;
 
 //------------------------------------------------------------------------------
 
+#ifdef CLIPPERLIB_ALLOCATOR
+template<typename BaseType>
+using Allocator = CLIPPERLIB_ALLOCATOR<BaseType>;
+#else // CLIPPERLIB_ALLOCATOR
 template<typename BaseType>
 using Allocator = tbb::scalable_allocator<BaseType>;
 //using Allocator = std::allocator<BaseType>;
+#endif // CLIPPERLIB_ALLOCATOR
 using Path      = std::vector<IntPoint, Allocator<IntPoint>>;
 using Paths     = std::vector<Path, Allocator<Path>>;
 
@@ -357,8 +362,8 @@ public:
     if (num_edges_total == 0)
       return false;
 
-    // Allocate a new edge array.
-    std::vector<TEdge, Allocator<TEdge>> edges(num_edges_total);
+    // Allocate a new edge array or reuse one released by Clear().
+    Edges edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -379,6 +384,7 @@ public:
     return result;
   }
 
+  // Remove all the paths. The memory allocated for the edges is retained for the following operations up to MaxRetainedEdges.
   void Clear();
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
@@ -392,6 +398,8 @@ protected:
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
   TEdge* DescendToMin(TEdge *&E);
   void AscendToMax(TEdge *&E, bool Appending, bool IsClosed);
+  using Edges = std::vector<TEdge, Allocator<TEdge>>;
+  Edges AllocateEdges(size_t num_edges);
 
   // Local minima (Y, left edge, right edge) sorted by ascending Y.
   std::vector<LocalMinimum, Allocator<LocalMinimum>> m_MinimaList;
@@ -405,8 +413,12 @@ protected:
 #endif // CLIPPERLIB_INT32
 
   // A vector of edges per each input path.
-  using Edges = std::vector<TEdge, Allocator<TEdge>>;
   std::vector<Edges, Allocator<Edges>> m_edges;
+  // Edge vectors released by Clear() to be reused by AddPath() / AddPaths(),
+  // so that a Clipper object reused for multiple operations does not allocate the edges again.
+  std::vector<Edges, Allocator<Edges>> m_edgesFree;
+  // Maximum number of edges retained in m_edgesFree to limit the memory held by a reused Clipper object.
+  static constexpr const size_t        MaxRetainedEdges = 32768;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -453,7 +465,11 @@ private:
   std::deque<OutRec, Allocator<OutRec>>  m_PolyOuts;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
   static constexpr const size_t m_OutPtsChunkSize = 32;
+  // Maximum number of chunks of output points retained by DisposeAllOutRecs() for the following operations.
+  static constexpr const size_t m_OutPtsMaxRetainedChunks = 1024;
   std::deque<std::array<OutPt, m_OutPtsChunkSize>, Allocator<std::array<OutPt, m_OutPtsChunkSize>>> m_OutPts;
+  // Number of chunks of m_OutPts in use, the chunks above are retained from the previous operations.
+  size_t                m_OutPtsChunksUsed;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkLast;
@@ -464,7 +480,11 @@ private:
   ClipType              m_ClipType;
   // A priority queue (a binary heap) of Y coordinates.
   using cInts = std::vector<cInt, Allocator<cInt>>;
-  std::priority_queue<cInt, cInts> m_Scanbeam;
+  struct Scanbeam : public std::priority_queue<cInt, cInts> {
+    // Unlike assigning an empty priority_queue, clear() keeps the memory of the underlying vector.
+    void clear() { this->c.clear(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   cInts                 m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -540,7 +560,7 @@ class ClipperOffset
 public:
   ClipperOffset(double miterLimit = 2.0, double roundPrecision = 0.25, double shortestEdgeLength = 0.) :
     MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0) {}
-  ~ClipperOffset() { Clear(); }
+  ~ClipperOffset();
   void AddPath(const Path& path, JoinType joinType, EndType endType);
   template<typename PathsProvider>
   void AddPaths(PathsProvider &&paths, JoinType joinType, EndType endType) {
@@ -549,6 +569,7 @@ public:
   }
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
+  // Remove all the paths. The memory allocated for the paths and for the final union is retained for the following operations.
   void Clear();
   double MiterLimit;
   double ArcTolerance;
@@ -565,6 +586,14 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Nodes released by Clear() to be reused by AddPath().
+  PolyNodes m_polyNodesFree;
+  // Maximum number of contour points of m_polyNodesFree to limit the memory held by a reused ClipperOffset object.
+  static constexpr const size_t MaxRetainedPoints = 32768;
+  // Clipper for the final union of the offsetted paths, reused by the following calls to Execute().
+  Clipper   m_clipper;
+
+  PolyNode* AllocateNode();
 
   void FixOrientations();
   void DoOffset(double delta);
@@ -17,9 +17,21 @@
 
 #include <Eigen/Geometry>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_invoke.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/task_arena.h>
+
 #include "BoundingBox.hpp"
 #include "Utils.hpp" // for next_highest_power_of_2()
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    // Vectorized bounding box tests of ray packets, see intersect_rays_first_hit().
+    #define SLIC3R_AABB_RAY_PACKET_SSE2
+    #include <emmintrin.h>
+#endif
+
 // Definition of the ray intersection hit structure.
 #include <igl/Hit.h>
 
@@ -101,7 +113,11 @@ public:
 		else {
 			// Allocate enough memory for a full binary tree.
             m_nodes.assign(next_highest_power_of_2(input.size()) * 2 - 1, Node());
-            build_recursive(input, 0, 0, input.size() - 1);
+            if (input.size() < parallel_build_threshold)
+                build_recursive(input, 0, 0, input.size() - 1);
+            else
+                // The tree may be built lazily by a TBB task holding a lock, don't let the waiting thread steal unrelated tasks.
+                tbb::this_task_arena::isolate([this, &input]() { build_recursive(input, 0, 0, input.size() - 1); });
 		}
 	}
 
@@ -123,6 +139,10 @@ public:
 	}
 
 private:
+	// Subtrees over at least this many input entities are built by TBB tasks in parallel.
+	// As the subtrees are stored into disjoint ranges of m_nodes, the resulting tree does not depend on the number of threads.
+	static constexpr size_t parallel_build_threshold = 16384;
+
 	// Build a balanced tree by splitting the input sequence by an axis aligned plane at a dimension.
 	template<typename SourceNode>
 	void build_recursive(std::vector<SourceNode> &input, size_t node, const size_t left, const size_t right)
@@ -138,8 +158,17 @@ private:
 
 		// Calculate bounding box of the input.
         BoundingBox bbox(input[left].bbox());
-        for (size_t i = left + 1; i <= right; ++ i)
-            bbox.extend(input[i].bbox());
+        if (right - left < parallel_build_threshold) {
+            for (size_t i = left + 1; i <= right; ++ i)
+                bbox.extend(input[i].bbox());
+        } else
+            bbox = tbb::parallel_reduce(tbb::blocked_range<size_t>(left + 1, right + 1, parallel_build_threshold / 4), bbox,
+                [&input](const tbb::blocked_range<size_t> &range, BoundingBox bbox) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i)
+                        bbox.extend(input[i].bbox());
+                    return bbox;
+                },
+                [](const BoundingBox &l, const BoundingBox &r) { return l.merged(r); });
         int dimension = -1;
         bbox.diagonal().maxCoeff(&dimension);
 
@@ -149,8 +178,13 @@ private:
 		// Insert an inner node into the tree. Inner node does not reference any input entity (triangle, line segment etc).
 		m_nodes[node].idx  = inner;
 		m_nodes[node].bbox = bbox;
-        build_recursive(input, node * 2 + 1, left, center);
-		build_recursive(input, node * 2 + 2, center + 1, right);
+        if (right - left < parallel_build_threshold) {
+            build_recursive(input, node * 2 + 1, left, center);
+		    build_recursive(input, node * 2 + 2, center + 1, right);
+        } else
+            tbb::parallel_invoke(
+                [this, &input, node, left, center]() { build_recursive(input, node * 2 + 1, left, center); },
+                [this, &input, node, center, right]() { build_recursive(input, node * 2 + 2, center + 1, right); });
 	}
 
 	// Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
@@ -474,6 +508,180 @@ namespace detail {
 		}
 	}
 
+    // Packet of up to PacketSize rays traversing the AABB tree together, see intersect_rays_first_hit().
+    template<int PacketSize, typename AVectorType>
+    struct RayPacket {
+        using VectorType = AVectorType;
+        using Scalar     = typename VectorType::Scalar;
+
+        // Ray origins and inverse directions stored per axis for the vectorized bounding box tests.
+        alignas(16) Scalar origin[3][PacketSize];
+        alignas(16) Scalar invdir[3][PacketSize];
+        // Rays for the triangle tests.
+        VectorType         origins[PacketSize];
+        VectorType         dirs[PacketSize];
+        // Bit mask of rays of this packet in use.
+        uint32_t           active;
+    };
+
+    // Vectorized ray_box_intersect_invdir() with t0 = 0 and t1 = min_t, returning a bit mask of the active rays intersecting the box.
+    // All the implementations follow the comparisons of ray_box_intersect_invdir() exactly
+    // to produce the same results even for rays parallel to the box faces.
+    template<int PacketSize, typename Scalar>
+    static inline uint32_t ray_packet_box_intersect_invdir(
+        const Scalar (&origin)[3][PacketSize], const Scalar (&invdir)[3][PacketSize],
+        const uint32_t active, const Eigen::AlignedBox<Scalar, 3> &box, const Scalar *min_t)
+    {
+        uint32_t out = 0;
+        for (int i = 0; i < PacketSize; ++ i) {
+            auto slab = [&origin, &invdir, &box, i](int axis, Scalar &t_near, Scalar &t_far) {
+                const Scalar t_min = (box.min()(axis) - origin[axis][i]) * invdir[axis][i];
+                const Scalar t_max = (box.max()(axis) - origin[axis][i]) * invdir[axis][i];
+                const bool   swap  = invdir[axis][i] < 0;
+                t_near = swap ? t_max : t_min;
+                t_far  = swap ? t_min : t_max;
+            };
+            Scalar tmin, tmax, tymin, tymax, tzmin, tzmax;
+            slab(0, tmin, tmax);
+            slab(1, tymin, tymax);
+            slab(2, tzmin, tzmax);
+            bool hit = ! (tmin > tymax) && ! (tymin > tmax);
+            tmin = tymin > tmin ? tymin : tmin;
+            tmax = tymax < tmax ? tymax : tmax;
+            hit = hit && ! (tzmin > tmax) && ! (tmin > tzmax);
+            tmin = tzmin > tmin ? tzmin : tmin;
+            tmax = tzmax < tmax ? tzmax : tmax;
+            if (hit && tmin < min_t[i] && tmax > Scalar(0))
+                out |= uint32_t(1) << i;
+        }
+        return out & active;
+    }
+
+#ifdef SLIC3R_AABB_RAY_PACKET_SSE2
+    // SSE2 implementations of ray_packet_box_intersect_invdir(), 4 float resp. 2 double rays at once.
+    // _mm_max_ps(a, b) returns (a > b ? a : b) and _mm_min_ps(a, b) returns (a < b ? a : b), thus they behave
+    // as the conditional assignments of ray_box_intersect_invdir() even for NaNs.
+    template<int PacketSize>
+    static inline uint32_t ray_packet_box_intersect_invdir(
+        const float (&origin)[3][PacketSize], const float (&invdir)[3][PacketSize],
+        const uint32_t active, const Eigen::AlignedBox<float, 3> &box, const float *min_t)
+    {
+        uint32_t out = 0;
+        for (int i = 0; i < PacketSize; i += 4) {
+            __m128 tmin, tmax, tymin, tymax, tzmin, tzmax;
+            auto slab = [&origin, &invdir, &box, i](int axis, __m128 &t_near, __m128 &t_far) {
+                const __m128 o      = _mm_load_ps(&origin[axis][i]);
+                const __m128 id     = _mm_load_ps(&invdir[axis][i]);
+                const __m128 t_min  = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min()(axis)), o), id);
+                const __m128 t_max  = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max()(axis)), o), id);
+                const __m128 swap   = _mm_cmplt_ps(id, _mm_setzero_ps());
+                t_near = _mm_or_ps(_mm_and_ps(swap, t_max), _mm_andnot_ps(swap, t_min));
+                t_far  = _mm_or_ps(_mm_and_ps(swap, t_min), _mm_andnot_ps(swap, t_max));
+            };
+            slab(0, tmin, tmax);
+            slab(1, tymin, tymax);
+            slab(2, tzmin, tzmax);
+            __m128 miss = _mm_or_ps(_mm_cmpgt_ps(tmin, tymax), _mm_cmpgt_ps(tymin, tmax));
+            tmin = _mm_max_ps(tymin, tmin);
+            tmax = _mm_min_ps(tymax, tmax);
+            miss = _mm_or_ps(miss, _mm_or_ps(_mm_cmpgt_ps(tzmin, tmax), _mm_cmpgt_ps(tmin, tzmax)));
+            tmin = _mm_max_ps(tzmin, tmin);
+            tmax = _mm_min_ps(tzmax, tmax);
+            const __m128 hit = _mm_andnot_ps(miss, _mm_and_ps(_mm_cmplt_ps(tmin, _mm_loadu_ps(min_t + i)), _mm_cmpgt_ps(tmax, _mm_setzero_ps())));
+            out |= uint32_t(_mm_movemask_ps(hit)) << i;
+        }
+        return out & active;
+    }
+
+    template<int PacketSize>
+    static inline uint32_t ray_packet_box_intersect_invdir(
+        const double (&origin)[3][PacketSize], const double (&invdir)[3][PacketSize],
+        const uint32_t active, const Eigen::AlignedBox<double, 3> &box, const double *min_t)
+    {
+        uint32_t out = 0;
+        for (int i = 0; i < PacketSize; i += 2) {
+            __m128d tmin, tmax, tymin, tymax, tzmin, tzmax;
+            auto slab = [&origin, &invdir, &box, i](int axis, __m128d &t_near, __m128d &t_far) {
+                const __m128d o      = _mm_load_pd(&origin[axis][i]);
+                const __m128d id     = _mm_load_pd(&invdir[axis][i]);
+                const __m128d t_min  = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(box.min()(axis)), o), id);
+                const __m128d t_max  = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(box.max()(axis)), o), id);
+                const __m128d swap   = _mm_cmplt_pd(id, _mm_setzero_pd());
+                t_near = _mm_or_pd(_mm_and_pd(swap, t_max), _mm_andnot_pd(swap, t_min));
+                t_far  = _mm_or_pd(_mm_and_pd(swap, t_min), _mm_andnot_pd(swap, t_max));
+            };
+            slab(0, tmin, tmax);
+            slab(1, tymin, tymax);
+            slab(2, tzmin, tzmax);
+            __m128d miss = _mm_or_pd(_mm_cmpgt_pd(tmin, tymax), _mm_cmpgt_pd(tymin, tmax));
+            tmin = _mm_max_pd(tymin, tmin);
+            tmax = _mm_min_pd(tymax, tmax);
+            miss = _mm_or_pd(miss, _mm_or_pd(_mm_cmpgt_pd(tzmin, tmax), _mm_cmpgt_pd(tmin, tzmax)));
+            tmin = _mm_max_pd(tzmin, tmin);
+            tmax = _mm_min_pd(tzmax, tmax);
+            const __m128d hit = _mm_andnot_pd(miss, _mm_and_pd(_mm_cmplt_pd(tmin, _mm_loadu_pd(min_t + i)), _mm_cmpgt_pd(tmax, _mm_setzero_pd())));
+            out |= uint32_t(_mm_movemask_pd(hit)) << i;
+        }
+        return out & active;
+    }
+#endif // SLIC3R_AABB_RAY_PACKET_SSE2
+
+    // Packet traversal equivalent to intersect_ray_recursive_first_hit() of the individual rays:
+    // The tree is traversed depth first, left child first, while each ray tests the bounding boxes against its own closest hit.
+    // The triangles are tested by intersect_triangle() for the rays of the packet reaching a leaf only.
+    template<int PacketSize, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+	static inline void intersect_ray_packet_first_hit(
+        const std::vector<VertexType>           &vertices,
+        const std::vector<IndexedFaceType>      &faces,
+        const TreeType                          &tree,
+        const RayPacket<PacketSize, VectorType> &packet,
+        const double                             eps,
+        igl::Hit                                *hits)
+	{
+        using Scalar = typename VectorType::Scalar;
+        struct StackItem {
+            size_t   node_idx;
+            // Bit mask of the rays intersecting the bounding box of the parent node.
+            uint32_t active;
+        };
+        // Depth first traversal of a balanced tree stores at most one sibling per tree level.
+        StackItem stack[std::numeric_limits<size_t>::digits + 1];
+        int       stack_size = 0;
+        stack[stack_size ++] = { size_t(0), packet.active };
+
+        alignas(16) Scalar min_t[PacketSize];
+        for (int i = 0; i < PacketSize; ++ i) {
+            min_t[i] = std::numeric_limits<Scalar>::infinity();
+            hits[i]  = igl::Hit { -1, -1, 0.f, 0.f, 0.f };
+        }
+
+        while (stack_size > 0) {
+            const StackItem item   = stack[-- stack_size];
+            const auto     &node   = tree.node(item.node_idx);
+            assert(node.is_valid());
+            const uint32_t  active = ray_packet_box_intersect_invdir(packet.origin, packet.invdir, item.active, node.bbox.template cast<Scalar>(), min_t);
+            if (active == 0)
+                continue;
+            if (node.is_leaf()) {
+                const auto face = faces[node.idx];
+                for (int i = 0; i < PacketSize; ++ i)
+                    if (active & (uint32_t(1) << i)) {
+                        double t, u, v;
+                        if (intersect_triangle(packet.origins[i], packet.dirs[i], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+                            t > 0. && Scalar(float(t)) < min_t[i]) {
+                            min_t[i] = Scalar(float(t));
+                            hits[i]  = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+                        }
+                    }
+            } else {
+                // Push the right child first to process the left child first.
+                const size_t left = item.node_idx * 2 + 1;
+                stack[stack_size ++] = { left + 1, active };
+                stack[stack_size ++] = { left, active };
+            }
+        }
+	}
+
     // Real-time collision detection, Ericson, Chapter 5
     template<typename Vector>
     static inline Vector closest_point_to_triangle(const Vector &p, const Vector &a, const Vector &b, const Vector &c)
@@ -696,24 +904,29 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
         VectorType 	m_centroid;
 	};
 
-	std::vector<InputType> input;
-	input.reserve(faces.size());
+	std::vector<InputType> input(faces.size());
     const VectorType veps(eps, eps, eps);
-	for (size_t i = 0; i < faces.size(); ++ i) {
-        const IndexedFaceType &face = faces[i];
-		const VertexType &v1 = vertices[face(0)];
-		const VertexType &v2 = vertices[face(1)];
-		const VertexType &v3 = vertices[face(2)];
-		InputType n;
-        n.m_idx      = i;
-        n.m_centroid = (1./3.) * (v1 + v2 + v3);
-        n.m_bbox = BoundingBox(v1, v1);
-        n.m_bbox.extend(v2);
-        n.m_bbox.extend(v3);
-        n.m_bbox.min() -= veps;
-        n.m_bbox.max() += veps;
-        input.emplace_back(n);
-	}
+    auto fill_input = [&vertices, &faces, &input, &veps](size_t begin, size_t end) {
+	    for (size_t i = begin; i < end; ++ i) {
+            const IndexedFaceType &face = faces[i];
+		    const VertexType &v1 = vertices[face(0)];
+		    const VertexType &v2 = vertices[face(1)];
+		    const VertexType &v3 = vertices[face(2)];
+		    InputType &n = input[i];
+            n.m_idx      = i;
+            n.m_centroid = (1./3.) * (v1 + v2 + v3);
+            n.m_bbox = BoundingBox(v1, v1);
+            n.m_bbox.extend(v2);
+            n.m_bbox.extend(v3);
+            n.m_bbox.min() -= veps;
+            n.m_bbox.max() += veps;
+	    }
+    };
+    if (faces.size() < 16384)
+        fill_input(0, faces.size());
+    else
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, faces.size(), 4096),
+            [&fill_input](const tbb::blocked_range<size_t> &range) { fill_input(range.begin(), range.end()); });
 
 	TreeType out;
 	out.build(std::move(input));
@@ -750,6 +963,65 @@ inline bool intersect_ray_first_hit(
         ray_intersector, size_t(0), std::numeric_limits<Scalar>::infinity(), hit);
 }
 
+// Find first intersections of a batch of rays with indexed triangle set.
+// The rays are traversed through the AABB tree in packets of PacketSize rays (4 or 8), testing each bounding box
+// and triangle against all the rays of a packet at once, while the packets are processed in parallel.
+// The packet traversal pays off if the rays of a packet are coherent, for example rays shot from a single origin
+// in similar directions or rays shot from neighbor points of a grid.
+// hits[i] is set to the same hit intersect_ray_first_hit() returns for origins[i], dirs[i], or hits[i].id is set to -1
+// if the ray does not hit the indexed triangle set.
+// Returns number of rays hitting the indexed triangle set.
+template<int PacketSize = 4, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline size_t intersect_rays_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const std::vector<VectorType>		&origins,
+	// Directions of the rays.
+	const std::vector<VectorType>		&dirs,
+	// First intersections of the rays with the indexed triangle set, resized to origins.size().
+	std::vector<igl::Hit>				&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    static_assert(PacketSize == 4 || PacketSize == 8, "Packets of 4 or 8 rays are supported");
+    using Packet = detail::RayPacket<PacketSize, VectorType>;
+    assert(origins.size() == dirs.size());
+
+    hits.assign(origins.size(), igl::Hit { -1, -1, 0.f, 0.f, 0.f });
+    if (tree.empty())
+        return 0;
+
+    const size_t num_packets = (origins.size() + PacketSize - 1) / PacketSize;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_packets, 16), [&](const tbb::blocked_range<size_t> &range) {
+        Packet packet;
+        for (size_t ipacket = range.begin(); ipacket < range.end(); ++ ipacket) {
+            const size_t first = ipacket * PacketSize;
+            const size_t count = std::min(origins.size() - first, size_t(PacketSize));
+            // Fill the unused rays with the first ray, they are masked out by packet.active.
+            for (int i = 0; i < PacketSize; ++ i) {
+                const size_t iray = first + (size_t(i) < count ? size_t(i) : 0);
+                packet.origins[i] = origins[iray];
+                packet.dirs[i]    = dirs[iray];
+                const VectorType invdir = dirs[iray].cwiseInverse();
+                for (int axis = 0; axis < 3; ++ axis) {
+                    packet.origin[axis][i] = origins[iray](axis);
+                    packet.invdir[axis][i] = invdir(axis);
+                }
+            }
+            packet.active = (uint32_t(1) << count) - 1;
+            igl::Hit packet_hits[PacketSize];
+            detail::intersect_ray_packet_first_hit(vertices, faces, tree, packet, eps, packet_hits);
+            std::copy(packet_hits, packet_hits + count, hits.begin() + first);
+        }
+    });
+    return size_t(std::count_if(hits.begin(), hits.end(), [](const igl::Hit &hit) { return hit.id >= 0; }));
+}
+
 // Find all intersections of a ray with indexed triangle set.
 // Intersection test is calculated with the accuracy of VectorType::Scalar
 // even if the triangle mesh and the AABB Tree are built with floats.
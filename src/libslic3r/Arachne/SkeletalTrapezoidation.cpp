@@ -13,6 +13,8 @@
 #include <utility>
 #include <cassert>
 #include <cstdlib>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 
 #include "libslic3r/Geometry/VoronoiUtils.hpp"
 #include "ankerl/unordered_dense.h"
@@ -1466,36 +1468,45 @@ void SkeletalTrapezoidation::generateSegments()
 
     ptr_vector_t<BeadingPropagation> node_beadings;
     { // Store beading
+        // Beadings of the nodes only depend on the node itself, thus they are calculated in parallel.
+        std::vector<node_t*> beading_nodes;
         for (node_t& node : graph.nodes)
         {
-            if (node.data.bead_count <= 0)
+            if (node.data.bead_count > 0)
             {
-                continue;
+                beading_nodes.emplace_back(&node);
             }
-            if (node.data.transition_ratio == 0)
+        }
+        node_beadings.assign(beading_nodes.size(), nullptr);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, beading_nodes.size()), [this, &beading_nodes, &node_beadings](const tbb::blocked_range<size_t> &range) {
+            for (size_t node_idx = range.begin(); node_idx < range.end(); ++ node_idx)
             {
-                node_beadings.emplace_back(new BeadingPropagation(beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count)));
-                node.data.setBeading(node_beadings.back());
-                assert(node_beadings.back()->beading.total_thickness == node.data.distance_to_boundary * 2);
-                if(node_beadings.back()->beading.total_thickness != node.data.distance_to_boundary * 2)
+                node_t& node = *beading_nodes[node_idx];
+                if (node.data.transition_ratio == 0)
                 {
-                    BOOST_LOG_TRIVIAL(warning) << "If transitioning to an endpoint (ratio 0), the node should be exactly in the middle.";
+                    node_beadings[node_idx] = std::make_shared<BeadingPropagation>(beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count));
+                    node.data.setBeading(node_beadings[node_idx]);
+                    assert(node_beadings[node_idx]->beading.total_thickness == node.data.distance_to_boundary * 2);
+                    if(node_beadings[node_idx]->beading.total_thickness != node.data.distance_to_boundary * 2)
+                    {
+                        BOOST_LOG_TRIVIAL(warning) << "If transitioning to an endpoint (ratio 0), the node should be exactly in the middle.";
+                    }
                 }
-            }
-            else
-            {
-                Beading low_count_beading = beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count);
-                Beading high_count_beading = beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count + 1);
-                Beading merged = interpolate(low_count_beading, 1.0 - node.data.transition_ratio, high_count_beading);
-                node_beadings.emplace_back(new BeadingPropagation(merged));
-                node.data.setBeading(node_beadings.back());
-                assert(merged.total_thickness == node.data.distance_to_boundary * 2);
-                if(merged.total_thickness != node.data.distance_to_boundary * 2)
+                else
                 {
-                    BOOST_LOG_TRIVIAL(warning) << "If merging two beads, the new bead must be exactly in the middle.";
+                    Beading low_count_beading = beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count);
+                    Beading high_count_beading = beading_strategy.compute(node.data.distance_to_boundary * 2, node.data.bead_count + 1);
+                    Beading merged = interpolate(low_count_beading, 1.0 - node.data.transition_ratio, high_count_beading);
+                    node_beadings[node_idx] = std::make_shared<BeadingPropagation>(merged);
+                    node.data.setBeading(node_beadings[node_idx]);
+                    assert(merged.total_thickness == node.data.distance_to_boundary * 2);
+                    if(merged.total_thickness != node.data.distance_to_boundary * 2)
+                    {
+                        BOOST_LOG_TRIVIAL(warning) << "If merging two beads, the new bead must be exactly in the middle.";
+                    }
                 }
             }
-        }
+        });
     }
 
 #ifdef ARACHNE_DEBUG
@@ -8,6 +8,9 @@
 #include <cinttypes>
 #include <cmath>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 #include "WallToolPaths.hpp"
 #include "SkeletalTrapezoidation.hpp"
 #include "utils/linearAlg2D.hpp"
@@ -548,98 +551,101 @@ void WallToolPaths::stitchToolPaths(std::vector<VariableWidthLines> &toolpaths,
 {
     const coord_t stitch_distance = bead_width_x - 1; //In 0-width contours, junctions can cause up to 1-line-width gaps. Don't stitch more than 1 line width.
 
-    for (unsigned int wall_idx = 0; wall_idx < toolpaths.size(); wall_idx++) {
-        VariableWidthLines& wall_lines = toolpaths[wall_idx];
+    // Walls are stitched independently of each other.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, toolpaths.size(), 1), [&toolpaths, stitch_distance](const tbb::blocked_range<size_t> &range) {
+        for (size_t wall_idx = range.begin(); wall_idx < range.end(); ++ wall_idx) {
+            VariableWidthLines& wall_lines = toolpaths[wall_idx];
 
-        VariableWidthLines stitched_polylines;
-        VariableWidthLines closed_polygons;
-        PolylineStitcher<VariableWidthLines, ExtrusionLine, ExtrusionJunction>::stitch(wall_lines, stitched_polylines, closed_polygons, stitch_distance);
+            VariableWidthLines stitched_polylines;
+            VariableWidthLines closed_polygons;
+            PolylineStitcher<VariableWidthLines, ExtrusionLine, ExtrusionJunction>::stitch(wall_lines, stitched_polylines, closed_polygons, stitch_distance);
 #ifdef ARACHNE_STITCH_PATCH_DEBUG
-        for (const ExtrusionLine& line : stitched_polylines) {
-            if ( ! line.is_odd && line.polylineLength() > 3 * stitch_distance && line.size() > 3) {
-                BOOST_LOG_TRIVIAL(error) << "Some even contour lines could not be closed into polygons!";
-                assert(false && "Some even contour lines could not be closed into polygons!");
-                BoundingBox aabb;
-                for (auto line2 : wall_lines)
-                    for (auto j : line2)
-                        aabb.merge(j.p);
-                {
-                    static int iRun = 0;
-                    SVG svg(debug_out_path("contours_before.svg-%d.png", iRun), aabb);
-                    std::array<const char *, 8> colors    = {"gray", "black", "blue", "green", "lime", "purple", "red", "yellow"};
-                    size_t                      color_idx = 0;
-                    for (auto& inset : toolpaths)
-                        for (auto& line2 : inset) {
-                            // svg.writePolyline(line2.toPolygon(), col);
-
+            for (const ExtrusionLine& line : stitched_polylines) {
+                if ( ! line.is_odd && line.polylineLength() > 3 * stitch_distance && line.size() > 3) {
+                    BOOST_LOG_TRIVIAL(error) << "Some even contour lines could not be closed into polygons!";
+                    assert(false && "Some even contour lines could not be closed into polygons!");
+                    BoundingBox aabb;
+                    for (auto line2 : wall_lines)
+                        for (auto j : line2)
+                            aabb.merge(j.p);
+                    {
+                        static int iRun = 0;
+                        SVG svg(debug_out_path("contours_before.svg-%d.png", iRun), aabb);
+                        std::array<const char *, 8> colors    = {"gray", "black", "blue", "green", "lime", "purple", "red", "yellow"};
+                        size_t                      color_idx = 0;
+                        for (auto& inset : toolpaths)
+                            for (auto& line2 : inset) {
+                                // svg.writePolyline(line2.toPolygon(), col);
+
+                                Polygon poly = line2.toPolygon();
+                                Point last = poly.front();
+                                for (size_t idx = 1 ; idx < poly.size(); idx++) {
+                                    Point here = poly[idx];
+                                    svg.draw(Line(last, here), colors[color_idx]);
+//                                svg.draw_text((last + here) / 2, std::to_string(line2.junctions[idx].region_id).c_str(), "black");
+                                    last = here;
+                                }
+                                svg.draw(poly[0], colors[color_idx]);
+                                // svg.nextLayer();
+                                // svg.writePoints(poly, true, 0.1);
+                                // svg.nextLayer();
+                                color_idx = (color_idx + 1) % colors.size();
+                            }
+                    }
+                    {
+                        static int iRun = 0;
+                        SVG svg(debug_out_path("contours-%d.svg", iRun), aabb);
+                        for (auto& inset : toolpaths)
+                            for (auto& line2 : inset)
+                                svg.draw_outline(line2.toPolygon(), "gray");
+                        for (auto& line2 : stitched_polylines) {
+                            const char *col = line2.is_odd ? "gray" : "red";
+                            if ( ! line2.is_odd)
+                                std::cerr << "Non-closed even wall of size: " << line2.size()  << " at " << line2.front().p << "\n";
+                            if ( ! line2.is_odd)
+                                svg.draw(line2.front().p);
                             Polygon poly = line2.toPolygon();
                             Point last = poly.front();
-                            for (size_t idx = 1 ; idx < poly.size(); idx++) {
+                            for (size_t idx = 1 ; idx < poly.size(); idx++)
+                            {
                                 Point here = poly[idx];
-                                svg.draw(Line(last, here), colors[color_idx]);
-//                                svg.draw_text((last + here) / 2, std::to_string(line2.junctions[idx].region_id).c_str(), "black");
+                                svg.draw(Line(last, here), col);
                                 last = here;
                             }
-                            svg.draw(poly[0], colors[color_idx]);
-                            // svg.nextLayer();
-                            // svg.writePoints(poly, true, 0.1);
-                            // svg.nextLayer();
-                            color_idx = (color_idx + 1) % colors.size();
-                        }
-                }
-                {
-                    static int iRun = 0;
-                    SVG svg(debug_out_path("contours-%d.svg", iRun), aabb);
-                    for (auto& inset : toolpaths)
-                        for (auto& line2 : inset)
-                            svg.draw_outline(line2.toPolygon(), "gray");
-                    for (auto& line2 : stitched_polylines) {
-                        const char *col = line2.is_odd ? "gray" : "red";
-                        if ( ! line2.is_odd)
-                            std::cerr << "Non-closed even wall of size: " << line2.size()  << " at " << line2.front().p << "\n";
-                        if ( ! line2.is_odd)
-                            svg.draw(line2.front().p);
-                        Polygon poly = line2.toPolygon();
-                        Point last = poly.front();
-                        for (size_t idx = 1 ; idx < poly.size(); idx++)
-                        {
-                            Point here = poly[idx];
-                            svg.draw(Line(last, here), col);
-                            last = here;
                         }
+                        for (auto line2 : closed_polygons)
+                            svg.draw(line2.toPolygon());
                     }
-                    for (auto line2 : closed_polygons)
-                        svg.draw(line2.toPolygon());
                 }
             }
-        }
 #endif // ARACHNE_STITCH_PATCH_DEBUG
-        wall_lines = stitched_polylines; // replace input toolpaths with stitched polylines
+            wall_lines = stitched_polylines; // replace input toolpaths with stitched polylines
 
-        for (ExtrusionLine& wall_polygon : closed_polygons)
-        {
-            if (wall_polygon.junctions.empty())
+            for (ExtrusionLine& wall_polygon : closed_polygons)
             {
-                continue;
-            }
+                if (wall_polygon.junctions.empty())
+                {
+                    continue;
+                }
 
-            // PolylineStitcher, in some cases, produced closed extrusion (polygons),
-            // but the endpoints differ by a small distance. So we reconnect them.
-            // FIXME Lukas H.: Investigate more deeply why it is happening.
-            if (wall_polygon.junctions.front().p != wall_polygon.junctions.back().p &&
-                (wall_polygon.junctions.back().p - wall_polygon.junctions.front().p).cast<double>().norm() < stitch_distance) {
-                wall_polygon.junctions.emplace_back(wall_polygon.junctions.front());
+                // PolylineStitcher, in some cases, produced closed extrusion (polygons),
+                // but the endpoints differ by a small distance. So we reconnect them.
+                // FIXME Lukas H.: Investigate more deeply why it is happening.
+                if (wall_polygon.junctions.front().p != wall_polygon.junctions.back().p &&
+                    (wall_polygon.junctions.back().p - wall_polygon.junctions.front().p).cast<double>().norm() < stitch_distance) {
+                    wall_polygon.junctions.emplace_back(wall_polygon.junctions.front());
+                }
+                wall_polygon.is_closed = true;
+                wall_lines.emplace_back(std::move(wall_polygon)); // add stitched polygons to result
             }
-            wall_polygon.is_closed = true;
-            wall_lines.emplace_back(std::move(wall_polygon)); // add stitched polygons to result
-        }
 #ifdef DEBUG
-        for (ExtrusionLine& line : wall_lines)
-        {
-            assert(line.inset_idx == wall_idx);
-        }
+            for (ExtrusionLine& line : wall_lines)
+            {
+                assert(line.inset_idx == wall_idx);
+            }
 #endif // DEBUG
-    }
+        }
+    });
 }
 
 template<typename T> bool shorterThan(const T &shape, const coord_t check_length)
@@ -674,15 +680,16 @@ void WallToolPaths::removeSmallLines(std::vector<VariableWidthLines> &toolpaths)
 
 void WallToolPaths::simplifyToolPaths(std::vector<VariableWidthLines> &toolpaths)
 {
+    const int64_t maximum_resolution = Slic3r::Arachne::meshfix_maximum_resolution;
+    const int64_t maximum_deviation = Slic3r::Arachne::meshfix_maximum_deviation;
+    const int64_t maximum_extrusion_area_deviation = Slic3r::Arachne::meshfix_maximum_extrusion_area_deviation; // unit: μm²
     for (size_t toolpaths_idx = 0; toolpaths_idx < toolpaths.size(); ++toolpaths_idx)
     {
-        const int64_t maximum_resolution = Slic3r::Arachne::meshfix_maximum_resolution;
-        const int64_t maximum_deviation = Slic3r::Arachne::meshfix_maximum_deviation;
-        const int64_t maximum_extrusion_area_deviation = Slic3r::Arachne::meshfix_maximum_extrusion_area_deviation; // unit: μm²
-        for (auto& line : toolpaths[toolpaths_idx])
-        {
-            line.simplify(maximum_resolution * maximum_resolution, maximum_deviation * maximum_deviation, maximum_extrusion_area_deviation);
-        }
+        VariableWidthLines &lines = toolpaths[toolpaths_idx];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, lines.size()), [&lines, maximum_resolution, maximum_deviation, maximum_extrusion_area_deviation](const tbb::blocked_range<size_t> &range) {
+            for (size_t line_idx = range.begin(); line_idx < range.end(); ++ line_idx)
+                lines[line_idx].simplify(maximum_resolution * maximum_resolution, maximum_deviation * maximum_deviation, maximum_extrusion_area_deviation);
+        });
     }
 }
 
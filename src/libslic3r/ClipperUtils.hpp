@@ -10,6 +10,7 @@
 
 #include <assert.h>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <utility>
 #include <vector>
@@ -544,6 +545,13 @@ Slic3r::Polygons union_pt_chained_outside_in(const Slic3r::Polygons &subject);
 // However, performing the union operation incrementally can be significantly faster in such cases.
 Slic3r::Polygons union_parallel_reduce(const Slic3r::Polygons &subject);
 
+namespace ClipperUtils {
+    // Run many independent Clipper operations in one call: operation(i) is called for i in <0, num_operations) in parallel.
+    // Each task runs a continuous range of operations, thus the Clipper objects retained by a worker thread for the first operation
+    // are reused by the following ones. The operations must not write to shared data.
+    void batch(size_t num_operations, const std::function<void(size_t)> &operation);
+}
+
 ClipperLib::PolyNodes order_nodes(const ClipperLib::PolyNodes &nodes);
 
 // Implementing generalized loop (foreach) over a list of nodes which can be
@@ -8,6 +8,10 @@
 #include <utility>
 #include <cassert>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
@@ -18,6 +22,7 @@
 #include "libslic3r/Fill/Lightning/Layer.hpp"
 #include "libslic3r/Flow.hpp"
 #include "libslic3r/LayerRegion.hpp"
+#include "libslic3r/ParallelPipeline.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Surface.hpp"
@@ -38,6 +43,24 @@
 
 namespace Slic3r::FillLightning {
 
+// Union of the internal infill areas of each layer of the object.
+static std::vector<Polygons> infill_outlines_per_layer(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+{
+    std::vector<Polygons> out(print_object.layers().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.size()), [&print_object, &out, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            Polygons infill_area;
+            for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                for (const Surface &surface : layerm->fill_surfaces())
+                    if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                        append(infill_area, to_polygons(surface.expolygon));
+            out[layer_id] = union_(infill_area);
+        }
+    });
+    return out;
+}
+
 Generator::Generator(const PrintObject &print_object, const coordf_t fill_density, const std::function<void()> &throw_on_cancel_callback)
 {
     const PrintConfig         &print_config         = print_object.print()->config();
@@ -62,33 +85,29 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    const std::vector<Polygons> infill_outlines = infill_outlines_per_layer(print_object, throw_on_cancel_callback);
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(infill_outlines, throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
-
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    m_overhang_per_layer.assign(infill_outlines.size(), Polygons());
+
+    // Subtract the infill area above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
+    // The infill areas are known for all layers in advance, thus the layers are processed independently.
+    const Polygons no_infill_area;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()), [this, &infill_outlines, &no_infill_area, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            const Polygons &infill_area_here  = infill_outlines[layer_id];
+            const Polygons &infill_area_above = layer_id + 1 < infill_outlines.size() ? infill_outlines[layer_id + 1] : no_infill_area;
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
+            // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+            m_overhang_per_layer[layer_id] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+        }
+    });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -97,60 +116,81 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
+    m_lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
+        return;
 
     // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
+    const size_t top_layer_id = infill_outlines.size() - 1;
     EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
     outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
 
-    // For-each layer from top to bottom:
-    for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        Layer             &current_lightning_layer = m_lightning_layers[layer_id];
-        const Polygons    &current_outlines        = infill_outlines[layer_id];
-        const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
-
-        // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
-
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
-
-        // Initialize trees for next lower layer from the current one.
-        if (layer_id == 0)
-            return;
+    // Overhang of a layer sampled into a distance field, waiting for the trees of the layer above to be propagated.
+    struct SampledLayer {
+        int                             layer_id;
+        BoundingBox                     outlines_bbox;
+        std::unique_ptr<DistanceField>  distance_field;
+    };
 
-        const Polygons &below_outlines      = infill_outlines[layer_id - 1];
-        BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
-        if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
-            below_outlines_bbox.merge(outlines_locator_bbox);
-
-        if (!current_lightning_layer.tree_roots.empty())
-            below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
-
-        outlines_locator.set_bbox(below_outlines_bbox);
-        outlines_locator.create(below_outlines, locator_cell_size);
-
-        std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
-    }
+    // For-each layer from top to bottom:
+    int next_layer_id = int(top_layer_id);
+    const auto layer_source = tbb::make_filter<void, int>(slic3r_tbb_filtermode::serial_in_order,
+        [&next_layer_id](tbb::flow_control &fc) -> int {
+            if (next_layer_id < 0) {
+                fc.stop();
+                return -1;
+            }
+            return next_layer_id --;
+        });
+    // Sampling of the overhang does not depend on the trees, thus it runs ahead of the tree growth for multiple layers in parallel.
+    const auto sample_overhang = tbb::make_filter<int, std::shared_ptr<SampledLayer>>(slic3r_tbb_filtermode::parallel,
+        [this, &infill_outlines, &throw_on_cancel_callback](int layer_id) -> std::shared_ptr<SampledLayer> {
+            throw_on_cancel_callback();
+            auto out = std::make_shared<SampledLayer>();
+            out->layer_id       = layer_id;
+            out->outlines_bbox  = get_extents(infill_outlines[layer_id]);
+            out->distance_field = std::make_unique<DistanceField>(m_supporting_radius, infill_outlines[layer_id], out->outlines_bbox, m_overhang_per_layer[layer_id]);
+            return out;
+        });
+    // Trees of a layer are propagated into the layer below, thus the layers are grown one by one.
+    const auto grow_trees = tbb::make_filter<std::shared_ptr<SampledLayer>, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &infill_outlines, &outlines_locator, &throw_on_cancel_callback](std::shared_ptr<SampledLayer> sampled) {
+            throw_on_cancel_callback();
+            const int          layer_id                = sampled->layer_id;
+            Layer             &current_lightning_layer = m_lightning_layers[layer_id];
+            const Polygons    &current_outlines        = infill_outlines[layer_id];
+            const BoundingBox &current_outlines_bbox   = sampled->outlines_bbox;
+
+            // register all trees propagated from the previous layer as to-be-reconnected
+            std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
+
+            current_lightning_layer.generateNewTrees(*sampled->distance_field, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+            sampled->distance_field.reset();
+            current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+
+            // Initialize trees for next lower layer from the current one.
+            if (layer_id == 0)
+                return;
+
+            const Polygons &below_outlines      = infill_outlines[layer_id - 1];
+            BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
+            if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
+                below_outlines_bbox.merge(outlines_locator_bbox);
+
+            if (!current_lightning_layer.tree_roots.empty())
+                below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
+
+            outlines_locator.set_bbox(below_outlines_bbox);
+            outlines_locator.create(below_outlines, locator_cell_size);
+
+            std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
+            for (auto& tree : current_lightning_layer.tree_roots)
+                tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        });
+
+    tbb::parallel_pipeline(parallel_pipeline_max_tokens(), layer_source & sample_overhang & grow_trees);
 }
 
 } // namespace Slic3r::FillLightning
@@ -50,7 +50,7 @@ void Layer::fillLocator(SparseNodeGrid &tree_node_locator, const BoundingBox& cu
 
 void Layer::generateNewTrees
 (
-    const Polygons& current_overhang,
+    DistanceField& distance_field,
     const Polygons& current_outlines,
     const BoundingBox& current_outlines_bbox,
     const EdgeGrid::Grid& outlines_locator,
@@ -59,9 +59,6 @@ void Layer::generateNewTrees
     const std::function<void()> &throw_on_cancel_callback
 )
 {
-    DistanceField distance_field(supporting_radius, current_outlines, current_outlines_bbox, current_overhang);
-    throw_on_cancel_callback();
-
     SparseNodeGrid tree_node_locator;
     fillLocator(tree_node_locator, current_outlines_bbox);
 
@@ -22,6 +22,7 @@ namespace Slic3r::FillLightning
 {
 
 class Node;
+class DistanceField;
 
 using NodeSPtr = std::shared_ptr<Node>;
 using SparseNodeGrid = std::unordered_multimap<Point, std::weak_ptr<Node>, PointHash>;
@@ -43,9 +44,13 @@ class Layer
 public:
     std::vector<NodeSPtr> tree_roots;
 
+    /*!
+     * Grow new trees until all the unsupported points of the distance field are supported.
+     * \param distance_field Sampled overhang of this layer, it is consumed by this call.
+     */
     void generateNewTrees
     (
-        const Polygons& current_overhang,
+        DistanceField& distance_field,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
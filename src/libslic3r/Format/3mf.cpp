@@ -11,13 +11,16 @@
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "libslic3r/Semver.hpp"
+#include "libslic3r/Thread.hpp"
 #include "libslic3r/Time.hpp"
 
 #include "libslic3r/I18N.hpp"
 
 #include "3mf.hpp"
 
+#include <atomic>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <optional>
 #include <string_view>
@@ -48,8 +51,11 @@ namespace pt = boost::property_tree;
 #include "libslic3r/NSVGUtils.hpp"
 
 #include "libslic3r/MultipleBeds.hpp"
+#include "libslic3r/ParallelPipeline.hpp"
 
 #include <fast_float.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 // Slightly faster than sprintf("%.9g"), but there is an issue with the karma floating point formatter,
 // https://github.com/boostorg/spirit/pull/586
@@ -640,7 +646,17 @@ namespace Slic3r {
         bool _handle_start_config_metadata(const char** attributes, unsigned int num_attributes);
         bool _handle_end_config_metadata();
 
-        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions);
+        // Mesh of a single volume split out of the object geometry. Meshes are built in parallel before the ModelVolumes are created.
+        struct VolumeMesh
+        {
+            TriangleMesh mesh;
+            // Error message if the mesh could not be built.
+            std::string  error;
+        };
+        // Thread safe, does not modify the importer.
+        void _build_volume_mesh(const ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadata& volume_data, bool transform_by_instance, VolumeMesh& out) const;
+        // If meshes are provided, they were built by _build_volume_mesh() for the volumes, otherwise they are built here.
+        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions, std::vector<VolumeMesh>* meshes = nullptr);
 
         // callbacks to parse the .rels file
         static void XMLCALL _handle_start_relationships_element(void *userData, const char *name, const char **attributes);
@@ -920,7 +936,51 @@ namespace Slic3r {
             }
         }
 
+        // Volumes of an object, for which no volume metadata was found. The object was not saved by PrusaSlicer,
+        // the entire geometry is a single volume.
+        auto default_volumes = [](const Geometry &geometry) {
+            return ObjectMetadata::VolumeMetadataList(1, { 0, (unsigned int)geometry.triangles.size() - 1 });
+        };
+
+        // Split the geometries into volume meshes in parallel, the meshes are indexed in the order of m_objects.
+        // Objects with missing geometry or model object are skipped here, they are reported below.
+        std::vector<std::vector<VolumeMesh>> object_meshes(m_objects.size());
+        {
+            struct MeshTask {
+                const ModelObject                        *model_object;
+                const Geometry                           *geometry;
+                const ObjectMetadata::VolumeMetadata     *volume_data;
+                bool                                      transform_by_instance;
+                VolumeMesh                               *out;
+            };
+            std::vector<MeshTask>                                 tasks;
+            std::vector<std::unique_ptr<ObjectMetadata::VolumeMetadataList>> object_default_volumes;
+            size_t object_idx = 0;
+            for (const IdToModelObjectMap::value_type& object : m_objects) {
+                std::vector<VolumeMesh> &meshes = object_meshes[object_idx ++];
+                IdToGeometryMap::const_iterator obj_geometry = m_geometries.find(object.first);
+                if (object.second >= int(m_model->objects.size()) || obj_geometry == m_geometries.end())
+                    continue;
+                const ObjectMetadata::VolumeMetadataList *volumes_ptr = nullptr;
+                if (IdToMetadataMap::iterator obj_metadata = m_objects_metadata.find(object.first.second); obj_metadata != m_objects_metadata.end())
+                    volumes_ptr = &obj_metadata->second.volumes;
+                else
+                    volumes_ptr = object_default_volumes.emplace_back(std::make_unique<ObjectMetadata::VolumeMetadataList>(default_volumes(obj_geometry->second))).get();
+                meshes.resize(volumes_ptr->size());
+                for (size_t i = 0; i < volumes_ptr->size(); ++ i)
+                    tasks.push_back({ m_model->objects[object.second], &obj_geometry->second, &(*volumes_ptr)[i], i == 0, &meshes[i] });
+            }
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size(), 1), [this, &tasks](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
+                    const MeshTask &task = tasks[i];
+                    this->_build_volume_mesh(*task.model_object, *task.geometry, *task.volume_data, task.transform_by_instance, *task.out);
+                }
+            });
+        }
+
+        size_t object_idx = 0;
         for (const IdToModelObjectMap::value_type& object : m_objects) {
+            std::vector<VolumeMesh> &meshes = object_meshes[object_idx ++];
             if (object.second >= int(m_model->objects.size())) {
                 add_error("Unable to find object");
                 return false;
@@ -976,13 +1036,13 @@ namespace Slic3r {
                 // config data not found, this model was not saved using slic3r pe
 
                 // add the entire geometry as the single volume to generate
-                volumes.emplace_back(0, (int)obj_geometry->second.triangles.size() - 1);
+                volumes = default_volumes(obj_geometry->second);
 
                 // select as volumes
                 volumes_ptr = &volumes;
             }
 
-            if (!_generate_volumes(*model_object, obj_geometry->second, *volumes_ptr, config_substitutions))
+            if (!_generate_volumes(*model_object, obj_geometry->second, *volumes_ptr, config_substitutions, &meshes))
                 return false;
 
             // Apply cut information for object if any was loaded
@@ -1114,31 +1174,56 @@ namespace Slic3r {
         XML_SetElementHandler(m_xml_parser, _3MF_Importer::_handle_start_model_xml_element, _3MF_Importer::_handle_end_model_xml_element);
         XML_SetCharacterDataHandler(m_xml_parser, _3MF_Importer::_handle_model_xml_characters);
 
-        struct CallbackData
-        {
-            XML_Parser& parser;
-            _3MF_Importer& importer;
-            const mz_zip_archive_file_stat& stat;
+        // Inflate the model file by blocks and parse the blocks while the next ones are being inflated.
+        // Both the decompression and the XML parsing are sequential, they run in two stages of a pipeline.
+        struct IterDeleter { void operator()(mz_zip_reader_extract_iter_state *state) const { mz_zip_reader_extract_iter_free(state); } };
+        std::unique_ptr<mz_zip_reader_extract_iter_state, IterDeleter> iter(mz_zip_reader_extract_iter_new(&archive, stat.m_file_index, 0));
+        if (! iter) {
+            add_error("Error while extracting model data from ZIP archive");
+            return false;
+        }
 
-            CallbackData(XML_Parser& parser, _3MF_Importer& importer, const mz_zip_archive_file_stat& stat) : parser(parser), importer(importer), stat(stat) {}
+        struct Block
+        {
+            std::vector<char> data;
+            bool              last { false };
         };
-
-        CallbackData data(m_xml_parser, *this, stat);
-
-        mz_bool res = 0;
+        static constexpr const size_t block_size = 1024 * 1024;
+        mz_uint64 file_ofs = 0;
+        bool      res      = true;
 
         try
         {
-            res = mz_zip_reader_extract_to_callback(&archive, stat.m_file_index, [](void* pOpaque, mz_uint64 file_ofs, const void* pBuf, size_t n)->size_t {
-                CallbackData* data = (CallbackData*)pOpaque;
-                if (!XML_Parse(data->parser, (const char*)pBuf, (int)n, (file_ofs + n == data->stat.m_uncomp_size) ? 1 : 0) || data->importer.parse_error()) {
-                    char error_buf[1024];
-                    ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", data->importer.parse_error_message(), data->stat.m_filename, (int)XML_GetCurrentLineNumber(data->parser));
-                    throw Slic3r::FileIOError(error_buf);
-                }
-
-                return n;
-                }, &data, 0);
+            TBBLocalesSetter locales_setter;
+            tbb::parallel_pipeline(4,
+                tbb::make_filter<void, std::shared_ptr<Block>>(slic3r_tbb_filtermode::serial_in_order,
+                    [&iter, &stat, &file_ofs, &res](tbb::flow_control &fc) -> std::shared_ptr<Block> {
+                        if (! res || file_ofs >= stat.m_uncomp_size) {
+                            fc.stop();
+                            return {};
+                        }
+                        auto block = std::make_shared<Block>();
+                        block->data.resize(size_t(std::min<mz_uint64>(block_size, stat.m_uncomp_size - file_ofs)));
+                        if (mz_zip_reader_extract_iter_read(iter.get(), block->data.data(), block->data.size()) != block->data.size()) {
+                            res = false;
+                            fc.stop();
+                            return {};
+                        }
+                        file_ofs += block->data.size();
+                        block->last = file_ofs == stat.m_uncomp_size;
+                        return block;
+                    }) &
+                tbb::make_filter<std::shared_ptr<Block>, void>(slic3r_tbb_filtermode::serial_in_order,
+                    [this, &stat](std::shared_ptr<Block> block) {
+                        if (!XML_Parse(m_xml_parser, block->data.data(), (int)block->data.size(), block->last ? 1 : 0) || parse_error()) {
+                            char error_buf[1024];
+                            ::sprintf(error_buf, "Error (%s) while parsing '%s' at line %d", parse_error_message(), stat.m_filename, (int)XML_GetCurrentLineNumber(m_xml_parser));
+                            throw Slic3r::FileIOError(error_buf);
+                        }
+                    }));
+            // Verifies the CRC of the inflated data.
+            if (! mz_zip_reader_extract_iter_free(iter.release()))
+                res = false;
         }
         catch (const version_error& e)
         {
@@ -1151,7 +1236,7 @@ namespace Slic3r {
             return false;
         }
 
-        if (res == 0) {
+        if (! res) {
             add_error("Error while extracting model data from ZIP archive");
             return false;
         }
@@ -2528,19 +2613,85 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions)
+    void _3MF_Importer::_build_volume_mesh(const ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadata& volume_data, bool transform_by_instance, VolumeMesh& out) const
+    {
+        unsigned int geo_tri_count = (unsigned int)geometry.triangles.size();
+        if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id) {
+            out.error = "Found invalid triangle id";
+            return;
+        }
+
+        // splits volume out of imported geometry
+        indexed_triangle_set its;
+        its.indices.assign(geometry.triangles.begin() + volume_data.first_triangle_id, geometry.triangles.begin() + volume_data.last_triangle_id + 1);
+        const size_t triangles_count = its.indices.size();
+        if (triangles_count == 0) {
+            out.error = "An empty triangle mesh found";
+            return;
+        }
+
+        {
+            int min_id = its.indices.front()[0];
+            int max_id = min_id;
+            for (const Vec3i& face : its.indices) {
+                for (const int tri_id : face) {
+                    if (tri_id < 0 || tri_id >= int(geometry.vertices.size())) {
+                        out.error = "Found invalid vertex id";
+                        return;
+                    }
+                    min_id = std::min(min_id, tri_id);
+                    max_id = std::max(max_id, tri_id);
+                }
+            }
+            its.vertices.assign(geometry.vertices.begin() + min_id, geometry.vertices.begin() + max_id + 1);
+
+            // rebase indices to the current vertices list
+            for (Vec3i& face : its.indices)
+                for (int& tri_id : face)
+                    tri_id -= min_id;
+        }
+
+        if (m_prusaslicer_generator_version && 
+            *m_prusaslicer_generator_version >= *Semver::parse("2.4.0-alpha1") &&
+            *m_prusaslicer_generator_version < *Semver::parse("2.4.0-alpha3"))
+            // PrusaSlicer 2.4.0-alpha2 contained a bug, where all vertices of a single object were saved for each volume the object contained.
+            // Remove the vertices, that are not referenced by any face.
+            its_compactify_vertices(its, true);
+
+        out.mesh = TriangleMesh(std::move(its), volume_data.mesh_stats);
+
+        if (m_version == 0) {
+            // if the 3mf was not produced by PrusaSlicer and there is only one instance,
+            // bake the transformation into the geometry to allow the reload from disk command
+            // to work properly. The instance transformation is reset by _generate_volumes()
+            // when the first volume is created, therefore only the first volume is transformed.
+            if (transform_by_instance && object.instances.size() == 1) {
+                out.mesh.transform(object.instances.front()->get_transformation().get_matrix(), false);
+                //FIXME do the mesh fixing?
+            }
+        }
+        if (out.mesh.volume() < 0)
+            out.mesh.flip_triangles();
+    }
+
+    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions, std::vector<VolumeMesh>* meshes)
     {
         if (!object.volumes.empty()) {
             add_error("Found invalid volumes count");
             return false;
         }
 
-        unsigned int geo_tri_count = (unsigned int)geometry.triangles.size();
         unsigned int renamed_volumes_count = 0;
 
-        for (const ObjectMetadata::VolumeMetadata& volume_data : volumes) {
-            if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id) {
-                add_error("Found invalid triangle id");
+        for (size_t volume_idx = 0; volume_idx < volumes.size(); ++ volume_idx) {
+            const ObjectMetadata::VolumeMetadata& volume_data = volumes[volume_idx];
+            VolumeMesh volume_mesh;
+            if (meshes != nullptr && volume_idx < meshes->size())
+                volume_mesh = std::move((*meshes)[volume_idx]);
+            else
+                _build_volume_mesh(object, geometry, volume_data, volume_idx == 0, volume_mesh);
+            if (! volume_mesh.error.empty()) {
+                add_error(volume_mesh.error);
                 return false;
             }
 
@@ -2555,59 +2706,12 @@ namespace Slic3r {
                 }
             }
 
-            // splits volume out of imported geometry
-            indexed_triangle_set its;
-            its.indices.assign(geometry.triangles.begin() + volume_data.first_triangle_id, geometry.triangles.begin() + volume_data.last_triangle_id + 1);
-            const size_t triangles_count = its.indices.size();
-            if (triangles_count == 0) {
-                add_error("An empty triangle mesh found");
-                return false;
-            }
-
-            {
-                int min_id = its.indices.front()[0];
-                int max_id = min_id;
-                for (const Vec3i& face : its.indices) {
-                    for (const int tri_id : face) {
-                        if (tri_id < 0 || tri_id >= int(geometry.vertices.size())) {
-                            add_error("Found invalid vertex id");
-                            return false;
-                        }
-                        min_id = std::min(min_id, tri_id);
-                        max_id = std::max(max_id, tri_id);
-                    }
-                }
-                its.vertices.assign(geometry.vertices.begin() + min_id, geometry.vertices.begin() + max_id + 1);
+            // The transformation of a single instance of a 3mf not produced by PrusaSlicer was baked into the mesh.
+            if (m_version == 0 && object.instances.size() == 1)
+                object.instances.front()->set_transformation(Slic3r::Geometry::Transformation());
 
-                // rebase indices to the current vertices list
-                for (Vec3i& face : its.indices)
-                    for (int& tri_id : face)
-                        tri_id -= min_id;
-            }
-
-            if (m_prusaslicer_generator_version && 
-                *m_prusaslicer_generator_version >= *Semver::parse("2.4.0-alpha1") &&
-                *m_prusaslicer_generator_version < *Semver::parse("2.4.0-alpha3"))
-                // PrusaSlicer 2.4.0-alpha2 contained a bug, where all vertices of a single object were saved for each volume the object contained.
-                // Remove the vertices, that are not referenced by any face.
-                its_compactify_vertices(its, true);
-
-            TriangleMesh triangle_mesh(std::move(its), volume_data.mesh_stats);
-
-            if (m_version == 0) {
-                // if the 3mf was not produced by PrusaSlicer and there is only one instance,
-                // bake the transformation into the geometry to allow the reload from disk command
-                // to work properly
-                if (object.instances.size() == 1) {
-                    triangle_mesh.transform(object.instances.front()->get_transformation().get_matrix(), false);
-                    object.instances.front()->set_transformation(Slic3r::Geometry::Transformation());
-                    //FIXME do the mesh fixing?
-                }
-            }
-            if (triangle_mesh.volume() < 0)
-                triangle_mesh.flip_triangles();
-
-			ModelVolume* volume = object.add_volume(std::move(triangle_mesh));
+            const size_t triangles_count = volume_data.last_triangle_id - volume_data.first_triangle_id + 1;
+			ModelVolume* volume = object.add_volume(std::move(volume_mesh.mesh));
             // stores the volume matrix taken from the metadata, if present
             if (has_transform)
                 volume->source.transform = Slic3r::Geometry::Transformation(volume_matrix_to_object);
@@ -3168,23 +3272,58 @@ namespace Slic3r {
 
     bool _3MF_Exporter::_add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets)
     {
-        std::string output_buffer;
-        output_buffer += "   <";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n";
-
-        auto flush = [this, &output_buffer, &context](bool force = false) {
-            if ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16) {
-                if (! mz_zip_writer_add_staged_data(&context, output_buffer.data(), output_buffer.size())) {
-                    add_error("Error during writing or compression");
-                    return false;
-                }
-                output_buffer.clear();
+        // Validate the meshes and calculate the offsets of vertices and triangles of the volumes.
+        unsigned int vertices_count = 0;
+        unsigned int triangles_count = 0;
+        for (ModelVolume* volume : object.volumes) {
+            if (volume == nullptr)
+                continue;
+
+            Offsets &offsets = volumes_offsets.insert({ volume, Offsets(vertices_count) }).first->second;
+
+            const indexed_triangle_set &its = volume->mesh().its;
+            if (its.vertices.empty()) {
+                add_error("Found invalid mesh");
+                return false;
             }
-            return true;
+
+            vertices_count += (int)its.vertices.size();
+            // updates triangle offsets
+            offsets.first_triangle_id = triangles_count;
+            triangles_count += (int)its.indices.size();
+            offsets.last_triangle_id = triangles_count - 1;
+        }
+
+        // Vertices and triangles are formatted in chunks in parallel, the formatted chunks are compressed into the archive
+        // in their order as soon as they are ready. Thus the XML of the mesh is never held in memory as a whole.
+        struct Chunk {
+            const ModelVolume *volume    { nullptr };
+            bool               triangles { false };
+            size_t             begin     { 0 };
+            size_t             end       { 0 };
+            // XML text of the chunk. Filled in for the constant chunks upfront.
+            std::string        data;
+        };
+        static constexpr const size_t chunk_size = 16384;
+        std::vector<Chunk> chunks;
+        auto add_text_chunk = [&chunks](std::string &&text) {
+            chunks.push_back({});
+            chunks.back().data = std::move(text);
+        };
+        auto add_volume_chunks = [&chunks, &object](bool triangles) {
+            for (const ModelVolume *volume : object.volumes)
+                if (volume != nullptr) {
+                    const indexed_triangle_set &its = volume->mesh().its;
+                    const size_t                size = triangles ? its.indices.size() : its.vertices.size();
+                    for (size_t begin = 0; begin < size; begin += chunk_size)
+                        chunks.push_back({ volume, triangles, begin, std::min(begin + chunk_size, size) });
+                }
         };
+        add_text_chunk(std::string("   <") + MESH_TAG + ">\n    <" + VERTICES_TAG + ">\n");
+        add_volume_chunks(false);
+        add_text_chunk(std::string("    </") + VERTICES_TAG + ">\n    <" + TRIANGLES_TAG + ">\n");
+        add_volume_chunks(true);
+        add_text_chunk(std::string("    </") + TRIANGLES_TAG + ">\n   </" + MESH_TAG + ">\n");
 
         auto format_coordinate = [](float f, char *buf) -> char* {
             assert(is_decimal_separator_point());
@@ -3216,25 +3355,12 @@ namespace Slic3r {
 #endif
         };
 
-        char buf[256];
-        unsigned int vertices_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            volumes_offsets.insert({ volume, Offsets(vertices_count) });
-
-            const indexed_triangle_set &its = volume->mesh().its;
-            if (its.vertices.empty()) {
-                add_error("Found invalid mesh");
-                return false;
-            }
-
-            vertices_count += (int)its.vertices.size();
-
-            const Transform3d& matrix = volume->get_matrix();
-            for (const auto& vertex: its.vertices) {
-                Vec3f v = (matrix * vertex.cast<double>()).cast<float>();
+        auto format_vertices = [&format_coordinate](const ModelVolume &volume, size_t begin, size_t end, std::string &output_buffer) {
+            char buf[256];
+            const indexed_triangle_set &its = volume.mesh().its;
+            const Transform3d& matrix = volume.get_matrix();
+            for (size_t i = begin; i < end; ++ i) {
+                Vec3f v = (matrix * its.vertices[i].cast<double>()).cast<float>();
                 char *ptr = buf;
                 boost::spirit::karma::generate(ptr, boost::spirit::lit("     <") << VERTEX_TAG << " x=\"");
                 ptr = format_coordinate(v.x(), ptr);
@@ -3245,34 +3371,23 @@ namespace Slic3r {
                 boost::spirit::karma::generate(ptr, "\"/>\n");
                 *ptr = '\0';
                 output_buffer += buf;
-                if (! flush())
-                    return false;
             }
-        }
-
-        output_buffer += "    </";
-        output_buffer += VERTICES_TAG;
-        output_buffer += ">\n    <";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n";
-
-        unsigned int triangles_count = 0;
-        for (ModelVolume* volume : object.volumes) {
-            if (volume == nullptr)
-                continue;
-
-            bool is_left_handed = volume->is_left_handed();
-            VolumeToOffsetsMap::iterator volume_it = volumes_offsets.find(volume);
-            assert(volume_it != volumes_offsets.end());
-
-            const indexed_triangle_set &its = volume->mesh().its;
-
-            // updates triangle offsets
-            volume_it->second.first_triangle_id = triangles_count;
-            triangles_count += (int)its.indices.size();
-            volume_it->second.last_triangle_id = triangles_count - 1;
+        };
 
-            for (int i = 0; i < int(its.indices.size()); ++ i) {
+        auto format_triangles = [](const ModelVolume &volume, const Offsets &offsets, size_t begin, size_t end, std::string &output_buffer) {
+            char buf[256];
+            const indexed_triangle_set &its = volume.mesh().its;
+            bool is_left_handed = volume.is_left_handed();
+            auto append_attribute = [&output_buffer](const char *attr, const std::string &data) {
+                if (! data.empty()) {
+                    output_buffer += " ";
+                    output_buffer += attr;
+                    output_buffer += "=\"";
+                    output_buffer += data;
+                    output_buffer += "\"";
+                }
+            };
+            for (int i = int(begin); i < int(end); ++ i) {
                 {
                     const Vec3i &idx = its.indices[i];
                     char *ptr = buf;
@@ -3280,64 +3395,57 @@ namespace Slic3r {
                         " v1=\"" << boost::spirit::int_ <<
                         "\" v2=\"" << boost::spirit::int_ <<
                         "\" v3=\"" << boost::spirit::int_ << "\"",
-                        idx[is_left_handed ? 2 : 0] + volume_it->second.first_vertex_id,
-                        idx[1] + volume_it->second.first_vertex_id,
-                        idx[is_left_handed ? 0 : 2] + volume_it->second.first_vertex_id);
+                        idx[is_left_handed ? 2 : 0] + offsets.first_vertex_id,
+                        idx[1] + offsets.first_vertex_id,
+                        idx[is_left_handed ? 0 : 2] + offsets.first_vertex_id);
                     *ptr = '\0';
                     output_buffer += buf;
                 }
-
-                std::string custom_supports_data_string = volume->supported_facets.get_triangle_as_string(i);
-                if (! custom_supports_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SUPPORTS_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_supports_data_string;
-                    output_buffer += "\"";
-                }
-
-                std::string custom_seam_data_string = volume->seam_facets.get_triangle_as_string(i);
-                if (! custom_seam_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += CUSTOM_SEAM_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += custom_seam_data_string;
-                    output_buffer += "\"";
-                }
-
-                std::string mm_painting_data_string = volume->mm_segmentation_facets.get_triangle_as_string(i);
-                if (! mm_painting_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += MM_SEGMENTATION_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += mm_painting_data_string;
-                    output_buffer += "\"";
-                }
-
-                std::string fuzzy_skin_data_string = volume->fuzzy_skin_facets.get_triangle_as_string(i);
-                if (!fuzzy_skin_data_string.empty()) {
-                    output_buffer += " ";
-                    output_buffer += FUZZY_SKIN_ATTR;
-                    output_buffer += "=\"";
-                    output_buffer += fuzzy_skin_data_string;
-                    output_buffer += "\"";
-                }
-
+                append_attribute(CUSTOM_SUPPORTS_ATTR, volume.supported_facets.get_triangle_as_string(i));
+                append_attribute(CUSTOM_SEAM_ATTR, volume.seam_facets.get_triangle_as_string(i));
+                append_attribute(MM_SEGMENTATION_ATTR, volume.mm_segmentation_facets.get_triangle_as_string(i));
+                append_attribute(FUZZY_SKIN_ATTR, volume.fuzzy_skin_facets.get_triangle_as_string(i));
                 output_buffer += "/>\n";
-
-                if (! flush())
-                    return false;
             }
-        }
-
-        output_buffer += "    </";
-        output_buffer += TRIANGLES_TAG;
-        output_buffer += ">\n   </";
-        output_buffer += MESH_TAG;
-        output_buffer += ">\n";
+        };
 
-        // Force flush.
-        return flush(true);
+        size_t            next_chunk = 0;
+        std::atomic<bool> write_ok   { true };
+        TBBLocalesSetter  locales_setter;
+        tbb::parallel_pipeline(parallel_pipeline_max_tokens(),
+            tbb::make_filter<void, Chunk*>(slic3r_tbb_filtermode::serial_in_order,
+                [&chunks, &next_chunk, &write_ok](tbb::flow_control &fc) -> Chunk* {
+                    if (next_chunk == chunks.size() || ! write_ok) {
+                        fc.stop();
+                        return nullptr;
+                    }
+                    return &chunks[next_chunk ++];
+                }) &
+            tbb::make_filter<Chunk*, Chunk*>(slic3r_tbb_filtermode::parallel,
+                [&volumes_offsets, &format_vertices, &format_triangles](Chunk *chunk) {
+                    if (chunk->volume != nullptr) {
+                        if (chunk->triangles) {
+                            auto volume_it = volumes_offsets.find(chunk->volume);
+                            assert(volume_it != volumes_offsets.end());
+                            format_triangles(*chunk->volume, volume_it->second, chunk->begin, chunk->end, chunk->data);
+                        } else
+                            format_vertices(*chunk->volume, chunk->begin, chunk->end, chunk->data);
+                    }
+                    return chunk;
+                }) &
+            tbb::make_filter<Chunk*, void>(slic3r_tbb_filtermode::serial_in_order,
+                [&context, &write_ok](Chunk *chunk) {
+                    if (write_ok && ! mz_zip_writer_add_staged_data(&context, chunk->data.data(), chunk->data.size()))
+                        write_ok = false;
+                    // Release the formatted text as soon as it is compressed.
+                    std::string().swap(chunk->data);
+                }));
+
+        if (! write_ok) {
+            add_error("Error during writing or compression");
+            return false;
+        }
+        return true;
     }
 
     void _3MF_Exporter::add_transformation(std::stringstream &stream, const Transform3d &tr)
@@ -22,6 +22,7 @@
 
 #include "libslic3r/GCode/ThumbnailData.hpp"
 #include "libslic3r/SLA/RasterBase.hpp"
+#include "libslic3r/SLA/ScanlineRaster.hpp"
 #include "libslic3r/SLAPrint.hpp"
 #include "LocalesUtils.hpp"
 #include "libslic3r/Config.hpp"
@@ -46,7 +47,6 @@
 #define PREV_H 168
 #define PREV_DPI 42
 
-#define LAYER_SIZE_ESTIMATE (32 * 1024)
 
 namespace Slic3r {
 
@@ -412,6 +412,9 @@ std::unique_ptr<sla::RasterBase> AnycubicSLAArchive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
+    if (m_cfg.sla_rasterizer.value == slarScanline)
+        return std::make_unique<sla::RasterGrayscaleAAScanline>(res, pxdim, tr, gamma);
+
     return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
 }
 
@@ -508,79 +511,110 @@ static void anycubicsla_write_layer(std::ofstream &out, anycubicsla_format_layer
     anycubicsla_write_float(out, l.layer48);
 }
 
-void AnycubicSLAArchive::export_print(const std::string     fname,
-                               const SLAPrint       &print,
-                               const ThumbnailsList &thumbnails,
-                               const std::string    &/*projectname*/)
-{
-    std::uint32_t layer_count = m_layers.size();
-
-    anycubicsla_format_intro         intro = {};
-    anycubicsla_format_header        header = {};
-    anycubicsla_format_preview       preview = {};
-    anycubicsla_format_layers_header layers_header = {};
-    anycubicsla_format_misc          misc = {};
-    std::vector<uint8_t>      layer_images;
-    std::uint32_t             image_offset;
-
-    assert(m_version == ANYCUBIC_SLA_FORMAT_VERSION_1);
-
-    intro.version             = m_version;
-    intro.area_num            = 4;
-    intro.header_data_offset  = sizeof(intro);
-    intro.preview_data_offset = sizeof(intro) + sizeof(header);
-    intro.layer_data_offset   = intro.preview_data_offset + sizeof(preview);
-    intro.image_data_offset = intro.layer_data_offset +
-                              sizeof(layers_header) +
-                              (sizeof(anycubicsla_format_layer) * layer_count);
-
-    fill_header(header, misc, print, layer_count);
-    fill_preview(preview, misc, thumbnails);
+namespace {
+
+// The layer table preceding the layer images needs the sizes of all the
+// images. A placeholder of the table is written first, the images are
+// appended as they come and the table is filled in when finalizing.
+class AnycubicSLALayerStream: public SLAArchiveWriter::LayerStream {
+    std::ofstream                         m_out;
+    anycubicsla_format_header             m_header = {};
+    anycubicsla_format_misc               m_misc   = {};
+    std::vector<anycubicsla_format_layer> m_layer_table;
+    std::streampos                        m_layer_table_pos;
+    std::uint32_t                         m_image_offset;
+    size_t                                m_next_layer = 0;
+
+public:
+    AnycubicSLALayerStream(const std::string    &fname,
+                           const SLAPrint       &print,
+                           const ThumbnailsList &thumbnails,
+                           uint16_t              version,
+                           std::uint32_t         layer_count)
+    {
+        anycubicsla_format_intro         intro = {};
+        anycubicsla_format_preview       preview = {};
+        anycubicsla_format_layers_header layers_header = {};
+
+        assert(version == ANYCUBIC_SLA_FORMAT_VERSION_1);
+
+        intro.version             = version;
+        intro.area_num            = 4;
+        intro.header_data_offset  = sizeof(intro);
+        intro.preview_data_offset = sizeof(intro) + sizeof(m_header);
+        intro.layer_data_offset   = intro.preview_data_offset + sizeof(preview);
+        intro.image_data_offset = intro.layer_data_offset +
+                                  sizeof(layers_header) +
+                                  (sizeof(anycubicsla_format_layer) * layer_count);
+
+        fill_header(m_header, m_misc, print, layer_count);
+        fill_preview(preview, m_misc, thumbnails);
 
-    try {
         // open the file and write the contents
-        std::ofstream out;
-        out.open(fname, std::ios::binary | std::ios::out | std::ios::trunc);
-        anycubicsla_write_intro(out, intro);
-        anycubicsla_write_header(out, header);
-        anycubicsla_write_preview(out, preview);
+        m_out.open(fname, std::ios::binary | std::ios::out | std::ios::trunc);
+        anycubicsla_write_intro(m_out, intro);
+        anycubicsla_write_header(m_out, m_header);
+        anycubicsla_write_preview(m_out, preview);
 
         layers_header.payload_size = intro.image_data_offset - intro.layer_data_offset -
                         sizeof(layers_header.tag)  - sizeof(layers_header.payload_size);
         layers_header.layer_count = layer_count;
-        anycubicsla_write_layers_header(out, layers_header);
+        anycubicsla_write_layers_header(m_out, layers_header);
 
         //layers
-        layer_images.reserve(layer_count * LAYER_SIZE_ESTIMATE);
-        image_offset = intro.image_data_offset;
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-            anycubicsla_format_layer l;
-            std::memset(&l, 0, sizeof(l));
-            l.image_offset = image_offset;
-            l.image_size = rst.size();
-            if (i < header.bottom_layer_count) {
-                l.exposure_time_s = header.bottom_exposure_time_s;
-                l.layer_height_mm = misc.bottom_layer_height_mm;
-                l.lift_distance_mm = misc.bottom_lift_distance_mm;
-                l.lift_speed_mms = misc.bottom_lift_speed_mms;
-            } else {
-                l.exposure_time_s = header.exposure_time_s;
-                l.layer_height_mm = header.layer_height_mm;
-                l.lift_distance_mm = header.lift_distance_mm;
-                l.lift_speed_mms = header.lift_speed_mms;
-            }
-            image_offset += l.image_size;
-            anycubicsla_write_layer(out, l);
-            // add the rle encoded layer image into the buffer
-            const char* img_start = reinterpret_cast<const char*>(rst.data());
-            const char* img_end = img_start + rst.size();
-            std::copy(img_start, img_end, std::back_inserter(layer_images));
-            i++;
+        m_layer_table.assign(layer_count, anycubicsla_format_layer{});
+        m_layer_table_pos = m_out.tellp();
+        for (anycubicsla_format_layer &l : m_layer_table)
+            anycubicsla_write_layer(m_out, l);
+        m_image_offset = intro.image_data_offset;
+    }
+
+    void write_layer(size_t idx, const sla::EncodedRaster &rst) override
+    {
+        // The images are stored one after another in the order of the layers.
+        assert(idx == m_next_layer && idx < m_layer_table.size());
+        ++ m_next_layer;
+
+        anycubicsla_format_layer &l = m_layer_table[idx];
+        l.image_offset = m_image_offset;
+        l.image_size = rst.size();
+        if (idx < m_header.bottom_layer_count) {
+            l.exposure_time_s = m_header.bottom_exposure_time_s;
+            l.layer_height_mm = m_misc.bottom_layer_height_mm;
+            l.lift_distance_mm = m_misc.bottom_lift_distance_mm;
+            l.lift_speed_mms = m_misc.bottom_lift_speed_mms;
+        } else {
+            l.exposure_time_s = m_header.exposure_time_s;
+            l.layer_height_mm = m_header.layer_height_mm;
+            l.lift_distance_mm = m_header.lift_distance_mm;
+            l.lift_speed_mms = m_header.lift_speed_mms;
         }
-        const char* img_buffer = reinterpret_cast<const char*>(layer_images.data());
-        out.write(img_buffer, layer_images.size());
-        out.close();
+        m_image_offset += l.image_size;
+        // add the rle encoded layer image
+        m_out.write(reinterpret_cast<const char*>(rst.data()), rst.size());
+    }
+
+    void finalize() override
+    {
+        m_out.seekp(m_layer_table_pos);
+        for (anycubicsla_format_layer &l : m_layer_table)
+            anycubicsla_write_layer(m_out, l);
+        m_out.close();
+    }
+};
+
+} // namespace
+
+void AnycubicSLAArchive::export_print(const std::string     fname,
+                               const SLAPrint       &print,
+                               const ThumbnailsList &thumbnails,
+                               const std::string    &/*projectname*/)
+{
+    try {
+        AnycubicSLALayerStream stream(fname, print, thumbnails, m_version, m_layers.size());
+        for (size_t i = 0; i < m_layers.size(); ++i)
+            stream.write_layer(i, m_layers[i]);
+        stream.finalize();
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
@@ -589,4 +623,14 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
 
 }
 
+std::unique_ptr<SLAArchiveWriter::LayerStream>
+AnycubicSLAArchive::open_stream(const std::string     &fname,
+                                const SLAPrint        &print,
+                                const ThumbnailsList  &thumbnails,
+                                const std::string     &/*projectname*/,
+                                size_t                 layer_num)
+{
+    return std::make_unique<AnycubicSLALayerStream>(fname, print, thumbnails, m_version, layer_num);
+}
+
 } // namespace Slic3r
@@ -40,6 +40,12 @@ protected:
     SLAPrinterConfig & cfg() { return m_cfg; }
     const SLAPrinterConfig & cfg() const { return m_cfg; }
 
+    std::unique_ptr<LayerStream> open_stream(const std::string     &fname,
+                                             const SLAPrint        &print,
+                                             const ThumbnailsList  &thumbnails,
+                                             const std::string     &projectname,
+                                             size_t                 layer_num) override;
+
 public:
     
     AnycubicSLAArchive() = default;
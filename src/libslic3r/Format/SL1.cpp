@@ -31,6 +31,7 @@
 #include "libslic3r/Execution/ExecutionTBB.hpp"
 
 #include "libslic3r/SLA/RasterBase.hpp"
+#include "libslic3r/SLA/ScanlineRaster.hpp"
 
 
 #include <boost/property_tree/ini_parser.hpp>
@@ -274,6 +275,9 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
+    if (m_cfg.sla_rasterizer.value == slarScanline)
+        return std::make_unique<sla::RasterGrayscaleAAScanline>(res, pxdim, tr, gamma);
+
     return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
 }
 
@@ -300,10 +304,11 @@ static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
     }
 }
 
-void SL1Archive::export_print(Zipper               &zipper,
-                              const SLAPrint       &print,
-                              const ThumbnailsList &thumbnails,
-                              const std::string    &prjname)
+// Write the configuration entries, which precede the layers in the archive.
+// Returns the project name the layer images are named after.
+static std::string write_config_entries(Zipper               &zipper,
+                                        const SLAPrint       &print,
+                                        const std::string    &prjname)
 {
     std::string project =
         prjname.empty() ?
@@ -317,29 +322,77 @@ void SL1Archive::export_print(Zipper               &zipper,
 
     fill_slicerconf(slicerconf, print);
 
-    try {
-        zipper.add_entry("config.ini");
-        zipper << to_ini(iniconf);
-        zipper.add_entry("prusaslicer.ini");
-        zipper << to_ini(slicerconf);
+    zipper.add_entry("config.ini");
+    zipper << to_ini(iniconf);
+    zipper.add_entry("prusaslicer.ini");
+    zipper << to_ini(slicerconf);
 
-        zipper.add_entry("config.json");
-        zipper << to_json(print, iniconf);
+    zipper.add_entry("config.json");
+    zipper << to_json(print, iniconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+    return project;
+}
 
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
-                                  rst.extension();
+static void write_layer_entry(Zipper                   &zipper,
+                              const std::string        &project,
+                              size_t                    idx,
+                              const sla::EncodedRaster &rst)
+{
+    std::string imgname = project + string_printf("%.5d", int(idx)) + "." +
+                          rst.extension();
 
-            zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+    zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
+}
 
-        for (const ThumbnailData& data : thumbnails)
-            if (data.is_valid())
-                write_thumbnail(zipper, data);
+// Write the thumbnails following the layers and close the archive.
+static void finalize_archive(Zipper &zipper, const ThumbnailsList &thumbnails)
+{
+    for (const ThumbnailData& data : thumbnails)
+        if (data.is_valid())
+            write_thumbnail(zipper, data);
+
+    zipper.finalize();
+}
+
+namespace {
 
-        zipper.finalize();
+class SL1LayerStream: public SLAArchiveWriter::LayerStream {
+    Zipper         m_zipper;
+    std::string    m_project;
+    ThumbnailsList m_thumbnails;
+
+public:
+    SL1LayerStream(Zipper               &&zipper,
+                   const SLAPrint        &print,
+                   const ThumbnailsList  &thumbnails,
+                   const std::string     &prjname)
+        : m_zipper(std::move(zipper)), m_thumbnails(thumbnails)
+    {
+        m_project = write_config_entries(m_zipper, print, prjname);
+    }
+
+    void write_layer(size_t idx, const sla::EncodedRaster &rst) override
+    {
+        write_layer_entry(m_zipper, m_project, idx, rst);
+    }
+
+    void finalize() override { finalize_archive(m_zipper, m_thumbnails); }
+};
+
+} // namespace
+
+void SL1Archive::export_print(Zipper               &zipper,
+                              const SLAPrint       &print,
+                              const ThumbnailsList &thumbnails,
+                              const std::string    &prjname)
+{
+    try {
+        std::string project = write_config_entries(zipper, print, prjname);
+
+        for (size_t i = 0; i < m_layers.size(); ++i)
+            write_layer_entry(zipper, project, i, m_layers[i]);
+
+        finalize_archive(zipper, thumbnails);
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
@@ -357,6 +410,25 @@ void SL1Archive::export_print(const std::string     fname,
     export_print(zipper, print, thumbnails, prjname);
 }
 
+std::unique_ptr<SLAArchiveWriter::LayerStream>
+SL1Archive::open_zip_stream(Zipper               &&zipper,
+                            const SLAPrint        &print,
+                            const ThumbnailsList  &thumbnails,
+                            const std::string     &prjname)
+{
+    return std::make_unique<SL1LayerStream>(std::move(zipper), print, thumbnails, prjname);
+}
+
+std::unique_ptr<SLAArchiveWriter::LayerStream>
+SL1Archive::open_stream(const std::string     &fname,
+                        const SLAPrint        &print,
+                        const ThumbnailsList  &thumbnails,
+                        const std::string     &prjname,
+                        size_t                 /*layer_num*/)
+{
+    return open_zip_stream(Zipper{fname, Zipper::FAST_COMPRESSION}, print, thumbnails, prjname);
+}
+
 } // namespace Slic3r
 
 // /////////////////////////////////////////////////////////////////////////////
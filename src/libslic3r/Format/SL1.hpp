@@ -30,6 +30,18 @@ protected:
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname);
 
+    // Stream the layers into the given zip file, see SLAArchiveWriter::start_streaming().
+    std::unique_ptr<LayerStream> open_zip_stream(Zipper               &&zipper,
+                                                 const SLAPrint        &print,
+                                                 const ThumbnailsList  &thumbnails,
+                                                 const std::string     &projectname);
+
+    std::unique_ptr<LayerStream> open_stream(const std::string     &fname,
+                                             const SLAPrint        &print,
+                                             const ThumbnailsList  &thumbnails,
+                                             const std::string     &projectname,
+                                             size_t                 layer_num) override;
+
 public:
 
     SL1Archive() = default;
@@ -265,6 +265,16 @@ void SL1_SVGArchive::export_print(const std::string     fname,
     SL1Archive::export_print(zipper, print, thumbnails, projectname);
 }
 
+std::unique_ptr<SLAArchiveWriter::LayerStream>
+SL1_SVGArchive::open_stream(const std::string     &fname,
+                            const SLAPrint        &print,
+                            const ThumbnailsList  &thumbnails,
+                            const std::string     &projectname,
+                            size_t                 /*layer_num*/)
+{
+    return open_zip_stream(Zipper{fname, Zipper::TIGHT_COMPRESSION}, print, thumbnails, projectname);
+}
+
 struct NanoSVGParser {
     NSVGimage *image;
     static constexpr const char *Units = "mm"; // Denotes user coordinate system
@@ -28,6 +28,12 @@ protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
     sla::RasterEncoder get_encoder() const override;
 
+    std::unique_ptr<LayerStream> open_stream(const std::string     &fname,
+                                             const SLAPrint        &print,
+                                             const ThumbnailsList  &thumbnails,
+                                             const std::string     &projectname,
+                                             size_t                 layer_num) override;
+
 public:
 
     void export_print(const std::string     fname,
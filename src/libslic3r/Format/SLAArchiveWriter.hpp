@@ -10,6 +10,9 @@
 #include <memory>
 #include <string>
 #include <cstddef>
+#include <mutex>
+#include <optional>
+#include <algorithm>
 
 #include "libslic3r/SLA/RasterBase.hpp"
 #include "libslic3r/Execution/ExecutionTBB.hpp"
@@ -22,16 +25,49 @@ class SLAPrint;
 class SLAPrinterConfig;
 
 class SLAArchiveWriter {
+public:
+    // Receives the encoded layers in the order of their indices and writes
+    // them into an archive which was opened before the rasterization.
+    class LayerStream {
+    public:
+        virtual ~LayerStream() = default;
+
+        virtual void write_layer(size_t idx, const sla::EncodedRaster &rst) = 0;
+
+        // Write the parts of the archive following the last layer and close it.
+        virtual void finalize() = 0;
+    };
+
+    // Number of encoded layers per thread kept in memory while streaming.
+    static constexpr size_t StreamingWindowPerThread = 4;
+
 protected:
     std::vector<sla::EncodedRaster> m_layers;
 
+    // Set between start_streaming() and finish_streaming() / abort_streaming().
+    std::unique_ptr<LayerStream> m_stream;
+
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    // Open the archive for streaming. Returns nullptr if the format does not
+    // support streaming, the layers are then collected in m_layers.
+    virtual std::unique_ptr<LayerStream> open_stream(const std::string     &/*fname*/,
+                                                     const SLAPrint        &/*print*/,
+                                                     const ThumbnailsList  &/*thumbnails*/,
+                                                     const std::string     &/*projectname*/,
+                                                     size_t                 /*layer_num*/)
+    {
+        return {};
+    }
+
 public:
     virtual ~SLAArchiveWriter() = default;
 
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
+    // While streaming, the layers are rasterized window by window and each
+    // layer is written into the stream as soon as all the layers below it are
+    // written, so only a window of encoded layers is kept in memory at a time.
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
         size_t     layer_num,
@@ -39,20 +75,75 @@ public:
         CancelFn cancelfn = []() { return false; },
         const EP & ep       = {})
     {
-        m_layers.resize(layer_num);
-        execution::for_each(
-            ep, size_t(0), m_layers.size(),
-            [this, &drawfn, &cancelfn](size_t idx) {
-                if (cancelfn()) return;
-
-                sla::EncodedRaster &enc = m_layers[idx];
-                auto                rst = create_raster();
-                drawfn(*rst, idx);
-                enc = rst->encode(get_encoder());
-            },
-            execution::max_concurrency(ep));
+        auto draw_layer = [this, &drawfn](size_t idx) {
+            auto rst = create_raster();
+            drawfn(*rst, idx);
+            return rst->encode(get_encoder());
+        };
+
+        if (! m_stream) {
+            m_layers.resize(layer_num);
+            execution::for_each(
+                ep, size_t(0), m_layers.size(),
+                [this, &draw_layer, &cancelfn](size_t idx) {
+                    if (cancelfn()) return;
+
+                    m_layers[idx] = draw_layer(idx);
+                },
+                execution::max_concurrency(ep));
+            return;
+        }
+
+        m_layers.clear();
+        const size_t window = std::max(size_t(1), StreamingWindowPerThread * execution::max_concurrency(ep));
+        std::vector<std::optional<sla::EncodedRaster>> pending(std::min(window, layer_num));
+        execution::BlockingMutex<EP> mutex;
+        for (size_t begin = 0; begin < layer_num && ! cancelfn(); begin += window) {
+            const size_t end  = std::min(begin + window, layer_num);
+            size_t       next = begin;
+            execution::for_each(
+                ep, begin, end,
+                [this, &draw_layer, &cancelfn, &pending, &mutex, &next, begin, end](size_t idx) {
+                    if (cancelfn()) return;
+
+                    sla::EncodedRaster enc = draw_layer(idx);
+
+                    std::lock_guard lck(mutex);
+                    pending[idx - begin] = std::move(enc);
+                    for (; next < end && pending[next - begin]; ++ next) {
+                        m_stream->write_layer(next, *pending[next - begin]);
+                        pending[next - begin].reset();
+                    }
+                });
+        }
+    }
+
+    // Open the archive before rasterizing, draw_layers() will then write the
+    // layers into it instead of collecting them in memory. Returns false if
+    // the format does not support streaming.
+    bool start_streaming(const std::string    &fname,
+                         const SLAPrint       &print,
+                         const ThumbnailsList &thumbnails,
+                         const std::string    &projectname,
+                         size_t                layer_num)
+    {
+        m_layers.clear();
+        m_stream = open_stream(fname, print, thumbnails, projectname, layer_num);
+        return bool(m_stream);
     }
 
+    // Complete the streamed archive after all the layers were drawn.
+    void finish_streaming()
+    {
+        if (std::unique_ptr<LayerStream> stream = std::move(m_stream); stream)
+            stream->finalize();
+    }
+
+    // Close the streamed archive without completing it, e.g. after cancellation.
+    void abort_streaming() { m_stream.reset(); }
+
+    bool is_streaming() const { return bool(m_stream); }
+
     // Export the print into an archive using the provided filename.
     virtual void export_print(const std::string     fname,
                               const SLAPrint       &print,
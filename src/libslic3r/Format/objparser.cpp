@@ -6,6 +6,8 @@
 #include <boost/nowide/cstdio.hpp>
 #include <LocalesUtils.hpp>
 #include <fast_float.h>
+#include <algorithm>
+#include <iterator>
 #include <new>
 #include <system_error>
 #include <utility>
@@ -14,6 +16,11 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include "libslic3r/Thread.hpp"
+
 #include "objparser.hpp"
 
 namespace ObjParser {
@@ -32,7 +39,18 @@ static double strtod_clocale(const char* str, char const** str_end)
 	return val;
 }
 
-static bool obj_parseline(const char *line, ObjData &data)
+// Face vertex with indices relative to the end of the vertex lists (negative indices in the OBJ file).
+// When parsing a block of the file independently of the preceding blocks, the relative indices have to be rebased
+// once the number of vertices in the preceding blocks is known.
+struct ObjRelativeVertex
+{
+	size_t	vertexIdx;
+	bool	coord;
+	bool	textureCoord;
+	bool	normal;
+};
+
+static bool obj_parseline(const char *line, ObjData &data, std::vector<ObjRelativeVertex> *relative = nullptr)
 {
 #define EATWS() while (*line == ' ' || *line == '\t') ++ line
 
@@ -239,6 +257,8 @@ static bool obj_parseline(const char *line, ObjData &data)
 					line = endptr;
 				}
 			}
+			if (relative != nullptr && (vertex.coordIdx < 0 || vertex.normalIdx < 0 || vertex.textureCoordIdx < 0))
+				relative->push_back({ data.vertices.size(), vertex.coordIdx < 0, vertex.textureCoordIdx < 0, vertex.normalIdx < 0 });
 			if (vertex.coordIdx < 0)
                 vertex.coordIdx += (int)data.coordinates.size() / 4;
             else
@@ -350,50 +370,105 @@ bool objparse(const char *path, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
 
-	FILE *pFile = boost::nowide::fopen(path, "rt");
+	FILE *pFile = boost::nowide::fopen(path, "rb");
 	if (pFile == 0)
 		return false;
 
-	constexpr size_t half_buf = 65536;
 	try {
-        char buf[half_buf * 2];
-		size_t len = 0;
-		size_t lenPrev = 0;
-        while ((len = ::fread(buf + lenPrev, 1, half_buf-1, pFile)) != 0) {
-            if (std::feof(pFile)) {
-                // Fix issue with missing last trinagle in obj file:
-                // https://github.com/prusa3d/PrusaSlicer/issues/12157
-                // algorithm expect line endings after last face
-                // but file format support it
-                buf[len+lenPrev] = '\n';
-                ++len;
-            }
-			len += lenPrev;
-			size_t lastLine = 0;
-			for (size_t i = 0; i < len; ++ i)
-				if (buf[i] == '\r' || buf[i] == '\n') {
-					buf[i] = 0;
-					char *c = buf + lastLine;
-					while (*c == ' ' || *c == '\t')
-						++ c;
-					//FIXME check the return value and exit on error?
-					// Will it break parsing of some obj files?
-					obj_parseline(c, data);
-					lastLine = i + 1;
+		// Read the whole file, the lines will be zero terminated in place.
+		std::vector<char> buf;
+		constexpr size_t block_size = 1024 * 1024;
+		for (size_t len = block_size; len == block_size;) {
+			size_t old_size = buf.size();
+			buf.resize(old_size + block_size);
+			len = ::fread(buf.data() + old_size, 1, block_size, pFile);
+			buf.resize(old_size + len);
+		}
+		::fclose(pFile);
+		pFile = nullptr;
+		// Fix issue with missing last trinagle in obj file:
+		// https://github.com/prusa3d/PrusaSlicer/issues/12157
+		// algorithm expect line endings after last face
+		// but file format support it
+		buf.emplace_back('\n');
+
+		// Split the file into blocks of whole lines, which are parsed in parallel.
+		std::vector<std::pair<size_t, size_t>> blocks;
+		for (size_t begin = 0; begin < buf.size();) {
+			size_t end = std::min(begin + block_size, buf.size());
+			while (buf[end - 1] != '\r' && buf[end - 1] != '\n')
+				++ end;
+			blocks.emplace_back(begin, end);
+			begin = end;
+		}
+
+		std::vector<ObjData>                        blocks_data(blocks.size());
+		std::vector<std::vector<ObjRelativeVertex>> blocks_relative(blocks.size());
+		{
+			Slic3r::TBBLocalesSetter tbb_locales_setter;
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks.size(), 1), [&buf, &blocks, &blocks_data, &blocks_relative](const tbb::blocked_range<size_t> &range) {
+				for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+					size_t lastLine = blocks[block_idx].first;
+					for (size_t i = lastLine; i < blocks[block_idx].second; ++ i)
+						if (buf[i] == '\r' || buf[i] == '\n') {
+							buf[i] = 0;
+							char *c = buf.data() + lastLine;
+							while (*c == ' ' || *c == '\t')
+								++ c;
+							//FIXME check the return value and exit on error?
+							// Will it break parsing of some obj files?
+							obj_parseline(c, blocks_data[block_idx], &blocks_relative[block_idx]);
+							lastLine = i + 1;
+						}
 				}
-			lenPrev = len - lastLine;
-            if (lenPrev > half_buf) {
-		    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
-				::fclose(pFile);
-				return false;
+			});
+		}
+
+		// Concatenate the blocks, rebase the relative and the first vertex indices.
+		for (size_t block_idx = 0; block_idx < blocks.size(); ++ block_idx) {
+			ObjData &block = blocks_data[block_idx];
+			const int coords_offset   = (int)data.coordinates.size() / 4;
+			const int textures_offset = (int)data.textureCoordinates.size() / 3;
+			const int normals_offset  = (int)data.normals.size() / 3;
+			const int vertices_offset = (int)data.vertices.size();
+			for (const ObjRelativeVertex &relative : blocks_relative[block_idx]) {
+				ObjVertex &vertex = block.vertices[relative.vertexIdx];
+				if (relative.coord)
+					vertex.coordIdx += coords_offset;
+				if (relative.textureCoord)
+					vertex.textureCoordIdx += textures_offset;
+				if (relative.normal)
+					vertex.normalIdx += normals_offset;
 			}
-			memmove(buf, buf + lastLine, lenPrev);
+			auto rebase = [vertices_offset](auto &items) {
+				for (auto &item : items)
+					item.vertexIdxFirst += vertices_offset;
+			};
+			rebase(block.usemtls);
+			rebase(block.objects);
+			rebase(block.groups);
+			rebase(block.smoothingGroups);
+			auto append = [](auto &dst, auto &src) {
+				dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+				src = {};
+			};
+			append(data.coordinates,        block.coordinates);
+			append(data.textureCoordinates, block.textureCoordinates);
+			append(data.normals,            block.normals);
+			append(data.parameters,         block.parameters);
+			append(data.mtllibs,            block.mtllibs);
+			append(data.usemtls,            block.usemtls);
+			append(data.objects,            block.objects);
+			append(data.groups,             block.groups);
+			append(data.smoothingGroups,    block.smoothingGroups);
+			append(data.vertices,           block.vertices);
 		}
     }
     catch (std::bad_alloc&) {
     	BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
 	}
-	::fclose(pFile);
+	if (pFile != nullptr)
+		::fclose(pFile);
 
 	// printf("vertices: %d\r\n", data.vertices.size() / 4);
 	// printf("coords: %d\r\n", data.coordinates.size());
@@ -1160,7 +1160,8 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, GCodeReader
     initialize_result_moves();
     size_t parse_line_callback_cntr = 10000;
     m_parser.set_progress_callback(progress_callback);
-    m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
+    // Lines are tokenized in parallel, only the stateful processing of the lines (kinematics, time estimation) runs serially.
+    m_parser.parse_file_parallel(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
         if (-- parse_line_callback_cntr == 0) {
             // Don't call the cancel_callback() too often, do it every at every 10000'th line.
             parse_line_callback_cntr = 10000;
@@ -4,6 +4,8 @@
 ///|/
 #include "GCodeReader.hpp"
 
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <fast_float.h>
 #include <iostream>
@@ -11,8 +13,13 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "Utils.hpp"
+#include "Thread.hpp"
+#include "ParallelPipeline.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/libslic3r.h"
 
@@ -42,6 +49,19 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 {
     assert(is_decimal_separator_point());
     
+    const char *c = this->tokenize_line(ptr, end, gline, command);
+
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.m_raw << std::endl;
+
+    return c;
+}
+
+const char* GCodeReader::tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command, std::string_view *raw) const
+{
     // command and args
     const char *c = ptr;
     {
@@ -90,15 +110,14 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
     // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr)
+    if (raw)
+        *raw = std::string_view(ptr, c - ptr);
+    else if (c > ptr)
         gline.m_raw.assign(ptr, c);
 
     // Skip the trailing newlines.
@@ -107,9 +126,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
@@ -126,10 +142,73 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
     }
 }
 
+// Map the file into memory. Returns false for an empty file or if the file could not be mapped,
+// in that case the caller shall fall back to the buffered reader.
+static bool map_file(const std::string &filename, boost::iostreams::mapped_file_source &mapped)
+{
+    try {
+        boost::system::error_code ec;
+        const boost::filesystem::path path(filename);
+        if (boost::filesystem::file_size(path, ec) == 0 || ec)
+            return false;
+        mapped.open(path);
+    } catch (const std::exception &) {
+        return false;
+    }
+    return mapped.is_open();
+}
+
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    boost::iostreams::mapped_file_source mapped;
+    if (! m_memory_mapped || ! map_file(filename, mapped))
+        return this->parse_file_buffered_internal(filename, parse_line_callback, line_end_callback);
+
+    // The lines are passed to the callback directly from the mapped memory, without copying.
+    const char *file_begin = mapped.data();
+    const char *file_end   = file_begin + mapped.size();
+    // Report progress at about the same rate as the buffered reader.
+    static constexpr const size_t progress_step = 65536 * 10;
+    const char *progress_next = file_begin + std::min(progress_step, mapped.size());
+    m_parsing = true;
+    for (const char *it = file_begin; it != file_end;) {
+        // Find end of line.
+        const char *it_end = it;
+        for (; it_end != file_end && *it_end != '\r' && *it_end != '\n'; ++ it_end) ;
+        if (it_end == file_end) {
+            // The last line of the file is not terminated by EOL, while the tokenizer expects
+            // a terminating character after the end of each line.
+            std::string last_line(it, it_end);
+            parse_line_callback(last_line.c_str(), last_line.c_str() + last_line.size());
+        } else
+            parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        // Skip EOL.
+        it = it_end;
+        if (it != file_end && *it == '\r')
+            ++ it;
+        if (it != file_end && *it == '\n') {
+            ++ it;
+            line_end_callback(size_t(it - file_begin));
+        }
+        if (it >= progress_next) {
+            progress_next = file_begin + std::min(size_t(progress_next - file_begin) + progress_step, mapped.size());
+            if (m_progress_callback != nullptr)
+                m_progress_callback(static_cast<float>(it - file_begin) / static_cast<float>(mapped.size()));
+        }
+    }
+    return true;
+}
+
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_file_buffered_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
+    if (in.f == nullptr)
+        return false;
 
     fseek(in.f, 0, SEEK_END);
     const long file_size = ftell(in.f);
@@ -220,6 +299,121 @@ bool GCodeReader::parse_file_raw(const std::string &filename, raw_line_callback_
         [](size_t){});
 }
 
+bool GCodeReader::parse_file_parallel(const std::string &filename, callback_t callback, std::vector<std::vector<size_t>> &lines_ends)
+{
+    boost::iostreams::mapped_file_source mapped;
+    if (! m_memory_mapped || ! map_file(filename, mapped))
+        // Empty file or a file that could not be memory mapped.
+        return this->parse_file(filename, callback, lines_ends);
+
+    lines_ends.clear();
+    lines_ends.push_back(std::vector<size_t>());
+
+    const char *file_begin = mapped.data();
+    const char *file_end   = file_begin + mapped.size();
+
+    // A block of complete lines of the mapped file, tokenized by the parallel stage of the pipeline.
+    struct Chunk {
+        const char                                         *begin;
+        const char                                         *end;
+        // Copy of the last line of the file if it is not terminated by EOL, as the tokenizer expects
+        // a terminating character after the end of each line.
+        std::string                                         last_line;
+        // Tokenized lines without their raw strings, which are only copied by the serial stage into a reused GCodeLine.
+        std::vector<GCodeLine>                              lines;
+        // Raw string and command of each line, pointing into the mapped file or into last_line.
+        std::vector<std::string_view>                       raw_lines;
+        std::vector<std::pair<const char*, const char*>>    commands;
+        // Positions in the file after each '\n'.
+        std::vector<size_t>                                 line_ends;
+    };
+
+    // Split the file into chunks of about 1MB, each chunk is cut after its last '\n'.
+    static constexpr const size_t chunk_size = 1024 * 1024;
+    const char       *chunk_begin = file_begin;
+    // Set by the serial stage if the callback called quit_parsing(), read by the input stage.
+    std::atomic<bool> quit { false };
+
+    const auto reader = tbb::make_filter<void, std::shared_ptr<Chunk>>(slic3r_tbb_filtermode::serial_in_order,
+        [file_end, &chunk_begin, &quit](tbb::flow_control &fc) -> std::shared_ptr<Chunk> {
+            if (quit || chunk_begin == file_end) {
+                fc.stop();
+                return {};
+            }
+            auto chunk = std::make_shared<Chunk>();
+            chunk->begin = chunk_begin;
+            chunk->end   = file_end;
+            if (size_t(file_end - chunk_begin) > chunk_size) {
+                const char *it = chunk_begin + chunk_size;
+                for (; it != chunk_begin && it[-1] != '\n'; -- it) ;
+                if (it == chunk_begin) {
+                    // Not a single complete line in this block, extend the chunk up to the next '\n'.
+                    it = std::find(chunk_begin + chunk_size, file_end, '\n');
+                    if (it != file_end)
+                        ++ it;
+                }
+                chunk->end = it;
+            }
+            chunk_begin = chunk->end;
+            return chunk;
+        });
+    const auto tokenizer = tbb::make_filter<std::shared_ptr<Chunk>, std::shared_ptr<Chunk>>(slic3r_tbb_filtermode::parallel,
+        [this, file_begin, file_end](std::shared_ptr<Chunk> chunk) -> std::shared_ptr<Chunk> {
+            for (const char *ptr = chunk->begin; ptr != chunk->end;) {
+                // Split the chunk to lines the same way parse_file_raw_internal() does.
+                const char *line_end = ptr;
+                for (; line_end != chunk->end && *line_end != '\r' && *line_end != '\n'; ++ line_end) ;
+                GCodeLine &gline = chunk->lines.emplace_back();
+                std::string_view &raw = chunk->raw_lines.emplace_back();
+                std::pair<const char*, const char*> &command = chunk->commands.emplace_back();
+                if (line_end == file_end) {
+                    chunk->last_line.assign(ptr, line_end);
+                    this->tokenize_line(chunk->last_line.c_str(), chunk->last_line.c_str() + chunk->last_line.size(), gline, command, &raw);
+                } else
+                    this->tokenize_line(ptr, line_end, gline, command, &raw);
+                ptr = line_end;
+                if (ptr != chunk->end && *ptr == '\r')
+                    ++ ptr;
+                if (ptr != chunk->end && *ptr == '\n') {
+                    ++ ptr;
+                    chunk->line_ends.emplace_back(size_t(ptr - file_begin));
+                }
+            }
+            return chunk;
+        });
+    // Line passed to the callback. Its raw string keeps its capacity, thus the lines are not allocated one by one.
+    GCodeLine gline;
+    const auto consumer = tbb::make_filter<std::shared_ptr<Chunk>, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &callback, &lines_ends, &quit, &gline, file_begin, file_size = mapped.size()](std::shared_ptr<Chunk> chunk) {
+            if (quit)
+                return;
+            for (size_t i = 0; i < chunk->lines.size(); ++ i) {
+                const GCodeLine &tokenized = chunk->lines[i];
+                std::copy(std::begin(tokenized.m_axis), std::end(tokenized.m_axis), std::begin(gline.m_axis));
+                gline.m_mask = tokenized.m_mask;
+                gline.m_raw.assign(chunk->raw_lines[i]);
+                if (gline.has(E) && m_config.use_relative_e_distances)
+                    m_position[E] = 0;
+                callback(*this, gline);
+                this->update_coordinates(gline, chunk->commands[i]);
+                if (! m_parsing) {
+                    // The callback wishes to exit.
+                    quit = true;
+                    return;
+                }
+            }
+            append(lines_ends.front(), std::move(chunk->line_ends));
+            if (m_progress_callback != nullptr)
+                m_progress_callback(static_cast<float>(chunk->end - file_begin) / static_cast<float>(file_size));
+        });
+
+    m_parsing = true;
+    // Locales are set to "C" for all threads participating in the pipeline, see GCodeGenerator::process_layers().
+    TBBLocalesSetter locales_setter;
+    tbb::parallel_pipeline(parallel_pipeline_max_tokens(), reader & tokenizer & consumer);
+    return true;
+}
+
 const char* GCodeReader::axis_pos(const char *raw_str, char axis)
 {
     const char *c = raw_str;
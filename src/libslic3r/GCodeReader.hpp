@@ -153,10 +153,18 @@ public:
     bool parse_file(const std::string& file, callback_t callback, std::vector<std::vector<size_t>>& lines_ends);
     // Just read the G-code file line by line, calls callback (const char *begin, const char *end). Returns false if reading the file failed.
     bool parse_file_raw(const std::string &file, raw_line_callback_t callback);
+    // Same as parse_file(), but the file is read in chunks split at line ends and the lines of several chunks are tokenized
+    // in parallel. Only the callback and the update of the current position are executed serially in the order of the lines,
+    // thus the callback receives the same sequence of lines and positions as with parse_file().
+    bool parse_file_parallel(const std::string &file, callback_t callback, std::vector<std::vector<size_t>> &lines_ends);
 
     // To be called by the callback to stop parsing.
     void quit_parsing() { m_parsing = false; }
 
+    // The parse_file() methods read the file through a memory mapping, so that the lines are tokenized in place.
+    // Files, which cannot be mapped, are read through a buffered stream. Disabling the memory mapping is useful for benchmarking.
+    void set_memory_mapped(bool memory_mapped) { m_memory_mapped = memory_mapped; }
+
     float& x()       { return m_position[X]; }
     float  x() const { return m_position[X]; }
     float& y()       { return m_position[Y]; }
@@ -180,9 +188,14 @@ private:
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
     template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_file_buffered_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
+    template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Stateless part of parse_line_internal(), it may be called from multiple threads.
+    // If raw is set, it receives the raw line as a view into the parsed buffer, the raw line is not copied into gline.
+    const char* tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command, std::string_view *raw = nullptr) const;
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
@@ -207,6 +220,7 @@ private:
     bool        m_verbose;
     // To be set by the callback to stop parsing.
     bool        m_parsing{ false };
+    bool        m_memory_mapped{ true };
 
     ProgressCallback m_progress_callback{ nullptr };
 };
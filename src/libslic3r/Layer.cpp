@@ -681,6 +681,7 @@ void Layer::make_perimeters()
 
     auto layer_region_reset_perimeters = [](LayerRegion &layerm) {
         layerm.m_perimeters.clear();
+        layerm.m_perimeters_unsplit.clear();
         layerm.m_fills.clear();
         layerm.m_thin_fills.clear();
         layerm.m_fill_expolygons.clear();
@@ -895,9 +896,13 @@ void Layer::sort_perimeters_into_islands(
                 return bbl.min < bbr.min || (bbl.min == bbr.min && bbl.max < bbr.max);
             });
             map_expolygon_to_region_and_fill.assign(fill_expolygons.size(), {});
+            // Split the fill expolygons by the regions, each region is clipped independently.
+            ClipperUtils::batch(layer_region_ids.size(), [this, &layer_region_ids, &fill_expolygons](size_t i) {
+                LayerRegion &l = *m_regions[layer_region_ids[i]];
+                l.m_fill_expolygons = intersection_ex(l.slices().surfaces, fill_expolygons);
+            });
             for (uint32_t region_idx : layer_region_ids) {
                 LayerRegion &l = *m_regions[region_idx];
-                l.m_fill_expolygons = intersection_ex(l.slices().surfaces, fill_expolygons);
                 l.m_fill_expolygons_bboxes.reserve(l.fill_expolygons().size());
                 for (const ExPolygon &expolygon : l.fill_expolygons()) {
                     BoundingBox bbox = get_extents(expolygon);
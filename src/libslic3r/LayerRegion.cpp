@@ -4,6 +4,8 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
 #include <string>
 #include <map>
@@ -134,35 +136,62 @@ void LayerRegion::make_perimeters(
     const ExPolygons *upper_slices = this->layer()->upper_layer ? &this->layer()->upper_layer->lslices : nullptr;
     // Cache for offsetted lower_slices
     Polygons          lower_layer_polygons_cache;
+    if (lower_slices != nullptr && region_config.overhangs) {
+        // Fill the cache before the islands are processed in parallel, see PerimeterGenerator::process_arachne() and process_classic().
+        double nozzle_diameter = print_config.nozzle_diameter.get_at(region_config.perimeter_extruder - 1);
+        lower_layer_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter / 2)));
+    }
+    const bool        use_arachne = this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase;
 
-    for (const Surface &surface : slices) {
+    // Perimeters, gap fills and fill areas of a single island.
+    struct IslandPerimeters {
+        ExtrusionEntityCollection perimeters;
+        ExtrusionEntityCollection gap_fills;
+        ExPolygons                fill_expolygons;
+    };
+    std::vector<IslandPerimeters> islands(slices.size());
+    // Islands are independent of each other, thus a layer with a few large islands does not have to wait for them one by one.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, slices.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+            IslandPerimeters &island = islands[island_idx];
+            // The cache is only written to by the perimeter generator if it is empty, thus an empty cache is not shared.
+            Polygons          empty_cache;
+            Polygons         &cache = lower_layer_polygons_cache.empty() ? empty_cache : lower_layer_polygons_cache;
+            if (use_arachne)
+                PerimeterGenerator::process_arachne(
+                    // input:
+                    params,
+                    slices.surfaces[island_idx],
+                    lower_slices,
+                    upper_slices,
+                    cache,
+                    // output:
+                    island.perimeters,
+                    island.gap_fills,
+                    island.fill_expolygons);
+            else
+                PerimeterGenerator::process_classic(
+                    // input:
+                    params,
+                    slices.surfaces[island_idx],
+                    lower_slices,
+                    upper_slices,
+                    cache,
+                    // output:
+                    island.perimeters,
+                    island.gap_fills,
+                    island.fill_expolygons);
+        }
+    });
+
+    // Collect the results in the order of the input slices.
+    for (IslandPerimeters &island : islands) {
         auto perimeters_begin      = uint32_t(m_perimeters.size());
         auto gap_fills_begin       = uint32_t(m_thin_fills.size());
         auto fill_expolygons_begin = uint32_t(fill_expolygons.size());
-        if (this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase)
-            PerimeterGenerator::process_arachne(
-                // input:
-                params,
-                surface,
-                lower_slices,
-                upper_slices,
-                lower_layer_polygons_cache,
-                // output:
-                m_perimeters,
-                m_thin_fills,
-                fill_expolygons);
-        else
-            PerimeterGenerator::process_classic(
-                // input:
-                params,
-                surface,
-                lower_slices,
-                upper_slices,
-                lower_layer_polygons_cache,
-                // output:
-                m_perimeters,
-                m_thin_fills,
-                fill_expolygons);
+        m_perimeters.append(std::move(island.perimeters.entities));
+        m_thin_fills.append(std::move(island.gap_fills.entities));
+        append(fill_expolygons, std::move(island.fill_expolygons));
         perimeter_and_gapfill_ranges.emplace_back(
             ExtrusionRange{ perimeters_begin, uint32_t(m_perimeters.size()) }, 
             ExtrusionRange{ gap_fills_begin,  uint32_t(m_thin_fills.size()) });
@@ -406,9 +435,10 @@ Surfaces expand_bridges_detect_orientations(
     Surfaces out{merge_bridges(bridges, expansion_result.expansions, closing_radius)};
 
     // Clip by the expanded bridges.
-    for (ExpansionZone& expansion_zone : expansion_zones)
-        if (expansion_zone.expanded_into)
+    ClipperUtils::batch(expansion_zones.size(), [&expansion_zones, &out](size_t i) {
+        if (ExpansionZone &expansion_zone = expansion_zones[i]; expansion_zone.expanded_into)
             expansion_zone.expolygons = diff_ex(expansion_zone.expolygons, out);
+    });
     return out;
 }
 
@@ -446,9 +476,10 @@ Surfaces expand_merge_surfaces(
     // look for narrow_ensure_vertical_wall_thickness_region_radius filter.
     expanded = closing_ex(expanded, closing_radius);
     // Trim the zones by the expanded expolygons.
-    for (ExpansionZone& expansion_zone : expansion_zones)
-        if (expansion_zone.expanded_into)
+    ClipperUtils::batch(expansion_zones.size(), [&expansion_zones, &expanded](size_t i) {
+        if (ExpansionZone &expansion_zone = expansion_zones[i]; expansion_zone.expanded_into)
             expansion_zone.expolygons = diff_ex(expansion_zone.expolygons, expanded);
+    });
 
     Surface templ{ surface_type, {} };
     templ.bridge_angle = bridge_angle;
@@ -202,6 +202,9 @@ private:
     // ordered collection of extrusion paths/loops to build all perimeters
     // (this collection contains only ExtrusionEntityCollection objects)
     ExtrusionEntityCollection   m_perimeters;
+    // m_perimeters before they were split at overhangs by PrintObject::calculate_overhanging_perimeters().
+    // Restored by PrintObject::make_perimeters() if the perimeters of this layer are not regenerated.
+    ExtrusionEntityCollection   m_perimeters_unsplit;
 
     // ordered collection of extrusion paths to fill surfaces
     // (this collection contains only ExtrusionEntityCollection objects)
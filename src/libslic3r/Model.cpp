@@ -2115,9 +2115,17 @@ indexed_triangle_set FacetsAnnotation::get_facets(const ModelVolume &mv, Triangl
 }
 
 indexed_triangle_set FacetsAnnotation::get_facets_strict(const ModelVolume &mv, TriangleStateType type) const {
+    if (type != TriangleStateType::NONE && ! TriangleSelector::has_facets(m_data, type))
+        // Don't construct the TriangleSelector if there is nothing to extract.
+        return {};
+
     TriangleSelector selector(mv.mesh());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
-    selector.deserialize(m_data, false);
+    if (type == TriangleStateType::NONE)
+        selector.deserialize(m_data, false);
+    else
+        // Expand just the source triangles containing facets of the requested type and their neighbors.
+        selector.deserialize(m_data, type, false);
     return selector.get_facets_strict(type);
 }
 
@@ -5,6 +5,7 @@
 #include <boost/log/trivial.hpp>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
 #include <boost/container_hash/hash.hpp>
 #include <utility>
 #include <Eigen/Geometry>
@@ -38,6 +39,7 @@
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Surface.hpp"
 #include "libslic3r/SVG.hpp"
+#include "libslic3r/Timer.hpp"
 #include "libslic3r/TriangleMeshSlicer.hpp"
 #include "libslic3r/TriangleSelector.hpp"
 #include "libslic3r/Utils.hpp"
@@ -708,18 +710,18 @@ static inline std::vector<std::vector<ExPolygons>> segmentation_top_and_bottom_l
                                                                                       const std::function<void()>                                     &throw_on_cancel_callback)
 {
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers in parallel - Begin";
+    Timing::Timer                timer;
+    timer.start();
     const size_t                 num_layers = input_expolygons.size();
     const SpanOfConstPtrs<Layer> layers     = print_object.layers();
 
-    // Maximum number of top / bottom layers accounts for maximum overlap of one thread group into a neighbor thread group.
+    // Maximum number of top / bottom layers accounts for maximum overlap of one band of layers into a neighbor band.
     int max_top_layers = 0;
     int max_bottom_layers = 0;
-    int granularity = 1;
     for (size_t i = 0; i < print_object.num_printing_regions(); ++ i) {
         const PrintRegionConfig &config = print_object.printing_region(i).config();
         max_top_layers    = std::max(max_top_layers, config.top_solid_layers.value);
         max_bottom_layers = std::max(max_bottom_layers, config.bottom_solid_layers.value);
-        granularity       = std::max(granularity, std::max(config.top_solid_layers.value, config.bottom_solid_layers.value) - 1);
     }
 
     // Project upwards pointing painted triangles over top surfaces,
@@ -732,88 +734,86 @@ static inline std::vector<std::vector<ExPolygons>> segmentation_top_and_bottom_l
         for (const ModelVolume *mv : print_object.model_object()->volumes)
             if (mv->is_model_part()) {
                 const Transform3d volume_trafo = object_trafo * mv->get_matrix();
-                for (size_t extruder_idx = 0; extruder_idx < num_facets_states; ++extruder_idx) {
-                    const indexed_triangle_set painted = extract_facets_info(*mv).facets_annotation.get_facets_strict(*mv, TriangleStateType(extruder_idx));
-
-                    if constexpr (MM_SEGMENTATION_DEBUG_TOP_BOTTOM) {
-                        its_write_obj(painted, debug_out_path("mm-painted-patch-%d.obj", extruder_idx).c_str());
-                    }
+                // Each painted state is extracted and sliced independently of the other states.
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, num_facets_states, 1), [&](const tbb::blocked_range<size_t> &range) {
+                    for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++ extruder_idx) {
+                        throw_on_cancel_callback();
+                        const indexed_triangle_set painted = extract_facets_info(*mv).facets_annotation.get_facets_strict(*mv, TriangleStateType(extruder_idx));
+
+                        if constexpr (MM_SEGMENTATION_DEBUG_TOP_BOTTOM) {
+                            its_write_obj(painted, debug_out_path("mm-painted-patch-%d.obj", extruder_idx).c_str());
+                        }
 
-                    if (! painted.indices.empty()) {
-                        std::vector<Polygons> top, bottom;
-                        if (!zs.empty() && is_volume_sinking(painted, volume_trafo)) {
-                            std::vector<float> zs_sinking = {0.f};
-                            Slic3r::append(zs_sinking, zs);
-                            slice_mesh_slabs(painted, zs_sinking, volume_trafo, max_top_layers > 0 ? &top : nullptr, max_bottom_layers > 0 ? &bottom : nullptr, throw_on_cancel_callback);
-
-                            MeshSlicingParams slicing_params;
-                            slicing_params.trafo = volume_trafo;
-                            Polygons bottom_slice = slice_mesh(painted, zs[0], slicing_params);
-
-                            top.erase(top.begin());
-                            bottom.erase(bottom.begin());
-
-                            bottom[0] = union_(bottom[0], bottom_slice);
-                        } else
-                            slice_mesh_slabs(painted, zs, volume_trafo, max_top_layers > 0 ? &top : nullptr, max_bottom_layers > 0 ? &bottom : nullptr, throw_on_cancel_callback);
-                        auto merge = [](std::vector<Polygons> &&src, std::vector<Polygons> &dst) {
-                            auto it_src = find_if(src.begin(), src.end(), [](const Polygons &p){ return ! p.empty(); });
-                            if (it_src != src.end()) {
-                                if (dst.empty()) {
-                                    dst = std::move(src);
-                                } else {
-                                    assert(src.size() == dst.size());
-                                    auto it_dst = dst.begin() + (it_src - src.begin());
-                                    for (; it_src != src.end(); ++ it_src, ++ it_dst)
-                                        if (! it_src->empty()) {
-                                            if (it_dst->empty())
-                                                *it_dst = std::move(*it_src);
-                                            else
-                                                append(*it_dst, std::move(*it_src));
-                                        }
+                        if (! painted.indices.empty()) {
+                            std::vector<Polygons> top, bottom;
+                            if (!zs.empty() && is_volume_sinking(painted, volume_trafo)) {
+                                std::vector<float> zs_sinking = {0.f};
+                                Slic3r::append(zs_sinking, zs);
+                                slice_mesh_slabs(painted, zs_sinking, volume_trafo, max_top_layers > 0 ? &top : nullptr, max_bottom_layers > 0 ? &bottom : nullptr, throw_on_cancel_callback);
+
+                                MeshSlicingParams slicing_params;
+                                slicing_params.trafo = volume_trafo;
+                                Polygons bottom_slice = slice_mesh(painted, zs[0], slicing_params);
+
+                                top.erase(top.begin());
+                                bottom.erase(bottom.begin());
+
+                                bottom[0] = union_(bottom[0], bottom_slice);
+                            } else
+                                slice_mesh_slabs(painted, zs, volume_trafo, max_top_layers > 0 ? &top : nullptr, max_bottom_layers > 0 ? &bottom : nullptr, throw_on_cancel_callback);
+                            auto merge = [](std::vector<Polygons> &&src, std::vector<Polygons> &dst) {
+                                auto it_src = find_if(src.begin(), src.end(), [](const Polygons &p){ return ! p.empty(); });
+                                if (it_src != src.end()) {
+                                    if (dst.empty()) {
+                                        dst = std::move(src);
+                                    } else {
+                                        assert(src.size() == dst.size());
+                                        auto it_dst = dst.begin() + (it_src - src.begin());
+                                        for (; it_src != src.end(); ++ it_src, ++ it_dst)
+                                            if (! it_src->empty()) {
+                                                if (it_dst->empty())
+                                                    *it_dst = std::move(*it_src);
+                                                else
+                                                    append(*it_dst, std::move(*it_src));
+                                            }
+                                    }
                                 }
-                            }
-                        };
-                        merge(std::move(top),    top_raw[extruder_idx]);
-                        merge(std::move(bottom), bottom_raw[extruder_idx]);
+                            };
+                            merge(std::move(top),    top_raw[extruder_idx]);
+                            merge(std::move(bottom), bottom_raw[extruder_idx]);
+                        }
                     }
-                }
+                }); // end of parallel_for
             }
     }
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers - Slicing of painted patches in " << timer.elapsed_milliseconds() << " ms";
+    timer.start();
 
-    auto filter_out_small_polygons = [&num_facets_states, &num_layers](std::vector<std::vector<Polygons>> &raw_surfaces, double min_area) -> void {
-        for (size_t extruder_idx = 0; extruder_idx < num_facets_states; ++extruder_idx) {
-            if (raw_surfaces[extruder_idx].empty())
-                continue;
-
-            for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-                if (raw_surfaces[extruder_idx][layer_idx].empty())
-                    continue;
-
-                remove_small(raw_surfaces[extruder_idx][layer_idx], min_area);
-            }
-        }
-    };
-
-    // Filter out polygons less than 0.1mm^2, because they are unprintable and causing dimples on outer primers (#7104)
-    filter_out_small_polygons(top_raw, Slic3r::sqr(POLYGON_FILTER_MIN_AREA_SCALED));
-    filter_out_small_polygons(bottom_raw, Slic3r::sqr(POLYGON_FILTER_MIN_AREA_SCALED));
-
-    // Remove top and bottom surfaces that are covered by the previous or next sliced layer.
-    for (size_t extruder_idx = 0; extruder_idx < num_facets_states; ++extruder_idx) {
-        for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-            const bool has_top_surface    = !top_raw[extruder_idx].empty() && !top_raw[extruder_idx][layer_idx].empty();
-            const bool has_bottom_surface = !bottom_raw[extruder_idx].empty() && !bottom_raw[extruder_idx][layer_idx].empty();
-
-            if (has_top_surface && layer_idx < (num_layers - 1)) {
-                top_raw[extruder_idx][layer_idx] = diff(top_raw[extruder_idx][layer_idx], input_expolygons[layer_idx + 1]);
-            }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&num_facets_states, &num_layers, &top_raw, &bottom_raw, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            throw_on_cancel_callback();
+            for (size_t extruder_idx = 0; extruder_idx < num_facets_states; ++ extruder_idx) {
+                if (!top_raw[extruder_idx].empty() && !top_raw[extruder_idx][layer_idx].empty()) {
+                    Polygons &top = top_raw[extruder_idx][layer_idx];
+                    // Filter out polygons less than 0.1mm^2, because they are unprintable and causing dimples on outer primers (#7104)
+                    remove_small(top, Slic3r::sqr(POLYGON_FILTER_MIN_AREA_SCALED));
+                    // Remove top surfaces that are covered by the next sliced layer.
+                    if (!top.empty() && layer_idx < (num_layers - 1))
+                        top = diff(top, input_expolygons[layer_idx + 1]);
+                }
 
-            if (has_bottom_surface && layer_idx > 0) {
-                bottom_raw[extruder_idx][layer_idx] = diff(bottom_raw[extruder_idx][layer_idx], input_expolygons[layer_idx - 1]);
+                if (!bottom_raw[extruder_idx].empty() && !bottom_raw[extruder_idx][layer_idx].empty()) {
+                    Polygons &bottom = bottom_raw[extruder_idx][layer_idx];
+                    remove_small(bottom, Slic3r::sqr(POLYGON_FILTER_MIN_AREA_SCALED));
+                    // Remove bottom surfaces that are covered by the previous sliced layer.
+                    if (!bottom.empty() && layer_idx > 0)
+                        bottom = diff(bottom, input_expolygons[layer_idx - 1]);
+                }
             }
         }
-    }
+    }); // end of parallel_for
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers - Filtering of projected patches in " << timer.elapsed_milliseconds() << " ms";
+    timer.start();
 
     if constexpr (MM_SEGMENTATION_DEBUG_TOP_BOTTOM) {
         const std::vector<std::string> colors = {"aqua", "black", "blue", "fuchsia", "gray", "green", "lime", "maroon", "navy", "olive", "purple", "red", "silver", "teal", "yellow"};
@@ -839,11 +839,6 @@ static inline std::vector<std::vector<ExPolygons>> segmentation_top_and_bottom_l
         }
     }
 
-    std::vector<std::vector<ExPolygons>> triangles_by_color_bottom(num_facets_states);
-    std::vector<std::vector<ExPolygons>> triangles_by_color_top(num_facets_states);
-    triangles_by_color_bottom.assign(num_facets_states, std::vector<ExPolygons>(num_layers * 2));
-    triangles_by_color_top.assign(num_facets_states, std::vector<ExPolygons>(num_layers * 2));
-
     struct LayerColorStat {
         // Number of regions for a queried color.
         int     num_regions             { 0 };
@@ -880,145 +875,183 @@ static inline std::vector<std::vector<ExPolygons>> segmentation_top_and_bottom_l
         return out;
     };
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers, granularity), [&granularity, &num_layers, &num_facets_states, &layer_color_stat, &top_raw, &triangles_by_color_top,
-                                                                               &throw_on_cancel_callback, &input_expolygons, &bottom_raw, &triangles_by_color_bottom](const tbb::blocked_range<size_t> &range) {
-        size_t group_idx   = range.begin() / granularity;
-        size_t layer_idx_offset = (group_idx & 1) * num_layers;
-        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-            for (size_t color_idx = 0; color_idx < num_facets_states; ++color_idx) {
+    // Top and bottom surfaces of all colors are propagated into a single accumulator indexed by color and layer.
+    // A top surface is propagated at most max_top_layers below its layer, a bottom surface at most max_bottom_layers - 1
+    // above its layer, thus two bands of band_size layers separated by another band never write into the same layer.
+    // The bands are processed in windows from the bottom up. Inside a window, even bands are processed in parallel first,
+    // then odd bands. Once a window is done, the layers more than max_top_layers below the next window will be neither
+    // written nor read anymore: their colors are merged and their projected patches are released right away, thus
+    // the projected patches are not held together with the unmerged accumulator of the whole object.
+    // The painted patches are still projected for all layers at once above, because slice_mesh_slabs() needs
+    // the connectivity of the whole painted mesh, thus slicing them per window would repeat that work for each window.
+    std::vector<std::vector<ExPolygons>> triangles_by_color(num_facets_states, std::vector<ExPolygons>(num_layers));
+    const size_t band_size        = size_t(std::max(max_top_layers + max_bottom_layers, 1));
+    const size_t num_bands        = (num_layers + band_size - 1) / band_size;
+    // Even number of bands, so that the last band of a window and the first band of the next window are not processed concurrently.
+    const size_t num_window_bands = 2 * size_t(std::max(tbb::this_task_arena::max_concurrency(), 1));
+
+    auto merge_colors_and_release_layers = [&triangles_by_color, &top_raw, &bottom_raw, &throw_on_cancel_callback](const size_t begin, const size_t end) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end), [&triangles_by_color, &top_raw, &bottom_raw, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                 throw_on_cancel_callback();
-                LayerColorStat stat = layer_color_stat(layer_idx, color_idx);
-                if (std::vector<Polygons> &top = top_raw[color_idx]; !top.empty() && !top[layer_idx].empty()) {
-                    if (ExPolygons top_ex = union_ex(top[layer_idx]); !top_ex.empty()) {
-                        // Clean up thin projections. They are not printable anyways.
-                        if (stat.small_region_threshold > 0)
-                            top_ex = opening_ex(top_ex, stat.small_region_threshold);
-
-                        if (!top_ex.empty()) {
-                            append(triangles_by_color_top[color_idx][layer_idx + layer_idx_offset], top_ex);
-                            float offset = 0.f;
-                            ExPolygons layer_slices_trimmed = input_expolygons[layer_idx];
-                            for (int last_idx = int(layer_idx) - 1; last_idx >= std::max(int(layer_idx - stat.top_solid_layers), int(0)); --last_idx) {
-                                offset -= stat.extrusion_width;
-                                layer_slices_trimmed = intersection_ex(layer_slices_trimmed, input_expolygons[last_idx]);
-                                ExPolygons last = intersection_ex(top_ex, offset_ex(layer_slices_trimmed, offset));
-
-                                // Trim this propagated top layer by the painted bottom layer.
-                                last = trim_by_top_or_bottom_layer(last, size_t(last_idx), bottom_raw);
-
-                                if (stat.small_region_threshold > 0)
-                                    last = opening_ex(last, stat.small_region_threshold);
-
-                                if (last.empty())
-                                    break;
-
-                                append(triangles_by_color_top[color_idx][last_idx + layer_idx_offset], std::move(last));
+                for (std::vector<std::vector<Polygons>> *raw : { &top_raw, &bottom_raw })
+                    for (std::vector<Polygons> &by_layer : *raw)
+                        if (! by_layer.empty())
+                            Polygons().swap(by_layer[layer_idx]);
+                for (size_t color_idx = 0; color_idx < triangles_by_color.size(); ++color_idx)
+                    if (ExPolygons &self = triangles_by_color[color_idx][layer_idx]; !self.empty())
+                        self = union_ex(self);
+                // Trim one region by the other if some of the regions overlap.
+                for (size_t color_idx = 1; color_idx < triangles_by_color.size(); ++ color_idx)
+                    if (ExPolygons &self = triangles_by_color[color_idx][layer_idx]; !self.empty() && !triangles_by_color[color_idx - 1][layer_idx].empty())
+                        self = diff_ex(self, triangles_by_color[color_idx - 1][layer_idx]);
+            }
+        });
+    };
+
+    size_t num_merged_layers = 0;
+    for (size_t window_begin = 0; window_begin < num_bands; window_begin += num_window_bands) {
+        const size_t window_end = std::min(window_begin + num_window_bands, num_bands);
+        for (size_t band_parity : { 0, 1 }) {
+            if (window_begin + band_parity >= window_end)
+                continue;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, (window_end - window_begin + 1 - band_parity) / 2), [&window_begin, &band_parity, &band_size, &num_layers, &num_facets_states, &layer_color_stat, &top_raw, &bottom_raw,
+                                                                                                               &triangles_by_color, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+                for (size_t band_idx = range.begin(); band_idx < range.end(); ++ band_idx) {
+                    const size_t first_layer_idx = (window_begin + 2 * band_idx + band_parity) * band_size;
+                    const size_t last_layer_idx  = std::min(first_layer_idx + band_size, num_layers);
+                    for (size_t layer_idx = first_layer_idx; layer_idx < last_layer_idx; ++ layer_idx) {
+                        for (size_t color_idx = 0; color_idx < num_facets_states; ++color_idx) {
+                            throw_on_cancel_callback();
+                            std::vector<ExPolygons> &by_layer = triangles_by_color[color_idx];
+                            LayerColorStat           stat     = layer_color_stat(layer_idx, color_idx);
+                            assert(stat.top_solid_layers <= int(band_size) && stat.bottom_solid_layers <= int(band_size));
+                            if (std::vector<Polygons> &top = top_raw[color_idx]; !top.empty() && !top[layer_idx].empty()) {
+                                if (ExPolygons top_ex = union_ex(top[layer_idx]); !top_ex.empty()) {
+                                    // Clean up thin projections. They are not printable anyways.
+                                    if (stat.small_region_threshold > 0)
+                                        top_ex = opening_ex(top_ex, stat.small_region_threshold);
+
+                                    if (!top_ex.empty()) {
+                                        append(by_layer[layer_idx], top_ex);
+                                        float offset = 0.f;
+                                        ExPolygons layer_slices_trimmed = input_expolygons[layer_idx];
+                                        for (int last_idx = int(layer_idx) - 1; last_idx >= std::max(int(layer_idx - stat.top_solid_layers), int(0)); --last_idx) {
+                                            offset -= stat.extrusion_width;
+                                            layer_slices_trimmed = intersection_ex(layer_slices_trimmed, input_expolygons[last_idx]);
+                                            ExPolygons last = intersection_ex(top_ex, offset_ex(layer_slices_trimmed, offset));
+
+                                            // Trim this propagated top layer by the painted bottom layer.
+                                            last = trim_by_top_or_bottom_layer(last, size_t(last_idx), bottom_raw);
+
+                                            if (stat.small_region_threshold > 0)
+                                                last = opening_ex(last, stat.small_region_threshold);
+
+                                            if (last.empty())
+                                                break;
+
+                                            append(by_layer[last_idx], std::move(last));
+                                        }
+                                    }
+                                }
                             }
-                        }
-                    }
-                }
 
-                if (std::vector<Polygons> &bottom = bottom_raw[color_idx]; !bottom.empty() && !bottom[layer_idx].empty()) {
-                    if (ExPolygons bottom_ex = union_ex(bottom[layer_idx]); !bottom_ex.empty()) {
-                        // Clean up thin projections. They are not printable anyways.
-                        if (stat.small_region_threshold > 0)
-                            bottom_ex = opening_ex(bottom_ex, stat.small_region_threshold);
+                            if (std::vector<Polygons> &bottom = bottom_raw[color_idx]; !bottom.empty() && !bottom[layer_idx].empty()) {
+                                if (ExPolygons bottom_ex = union_ex(bottom[layer_idx]); !bottom_ex.empty()) {
+                                    // Clean up thin projections. They are not printable anyways.
+                                    if (stat.small_region_threshold > 0)
+                                        bottom_ex = opening_ex(bottom_ex, stat.small_region_threshold);
 
-                        if (!bottom_ex.empty()) {
-                            append(triangles_by_color_bottom[color_idx][layer_idx + layer_idx_offset], bottom_ex);
-                            float offset = 0.f;
-                            ExPolygons layer_slices_trimmed = input_expolygons[layer_idx];
-                            for (size_t last_idx = layer_idx + 1; last_idx < std::min(layer_idx + stat.bottom_solid_layers, num_layers); ++last_idx) {
-                                offset -= stat.extrusion_width;
-                                layer_slices_trimmed = intersection_ex(layer_slices_trimmed, input_expolygons[last_idx]);
-                                ExPolygons last = intersection_ex(bottom_ex, offset_ex(layer_slices_trimmed, offset));
+                                    if (!bottom_ex.empty()) {
+                                        append(by_layer[layer_idx], bottom_ex);
+                                        float offset = 0.f;
+                                        ExPolygons layer_slices_trimmed = input_expolygons[layer_idx];
+                                        for (size_t last_idx = layer_idx + 1; last_idx < std::min(layer_idx + stat.bottom_solid_layers, num_layers); ++last_idx) {
+                                            offset -= stat.extrusion_width;
+                                            layer_slices_trimmed = intersection_ex(layer_slices_trimmed, input_expolygons[last_idx]);
+                                            ExPolygons last = intersection_ex(bottom_ex, offset_ex(layer_slices_trimmed, offset));
 
-                                // Trim this propagated bottom layer by the painted top layer.
-                                last = trim_by_top_or_bottom_layer(last, size_t(last_idx), top_raw);
+                                            // Trim this propagated bottom layer by the painted top layer.
+                                            last = trim_by_top_or_bottom_layer(last, size_t(last_idx), top_raw);
 
-                                if (stat.small_region_threshold > 0)
-                                    last = opening_ex(last, stat.small_region_threshold);
+                                            if (stat.small_region_threshold > 0)
+                                                last = opening_ex(last, stat.small_region_threshold);
 
-                                if (last.empty())
-                                    break;
+                                            if (last.empty())
+                                                break;
 
-                                append(triangles_by_color_bottom[color_idx][last_idx + layer_idx_offset], std::move(last));
+                                            append(by_layer[last_idx], std::move(last));
+                                        }
+                                    }
+                                }
                             }
                         }
                     }
                 }
-            }
+            }); // end of parallel_for
         }
-    });
 
-    std::vector<std::vector<ExPolygons>> triangles_by_color_merged(num_facets_states);
-    triangles_by_color_merged.assign(num_facets_states, std::vector<ExPolygons>(num_layers));
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&triangles_by_color_merged, &triangles_by_color_bottom, &triangles_by_color_top, &num_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-            throw_on_cancel_callback();
-            for (size_t color_idx = 0; color_idx < triangles_by_color_merged.size(); ++color_idx) {
-                auto &self = triangles_by_color_merged[color_idx][layer_idx];
-                append(self, std::move(triangles_by_color_bottom[color_idx][layer_idx]));
-                append(self, std::move(triangles_by_color_bottom[color_idx][layer_idx + num_layers]));
-                append(self, std::move(triangles_by_color_top[color_idx][layer_idx]));
-                append(self, std::move(triangles_by_color_top[color_idx][layer_idx + num_layers]));
-                self = union_ex(self);
-            }
-            // Trim one region by the other if some of the regions overlap.
-            for (size_t color_idx = 1; color_idx < triangles_by_color_merged.size(); ++ color_idx)
-                triangles_by_color_merged[color_idx][layer_idx] = diff_ex(triangles_by_color_merged[color_idx][layer_idx],
-                                                                          triangles_by_color_merged[color_idx - 1][layer_idx]);
+        // Layers below merge_end are final and their projected patches will not be accessed anymore.
+        const size_t window_last_layer = std::min(window_end * band_size, num_layers);
+        const size_t merge_end         = window_end == num_bands ? num_layers : window_last_layer - std::min(window_last_layer, size_t(max_top_layers));
+        if (merge_end > num_merged_layers) {
+            merge_colors_and_release_layers(num_merged_layers, merge_end);
+            num_merged_layers = merge_end;
         }
-    });
+    }
+    assert(num_merged_layers == num_layers);
+
+    top_raw.clear();
+    bottom_raw.clear();
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers - Propagation into solid layers and merging of colors in " << timer.elapsed_milliseconds() << " ms";
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers in parallel - End";
 
-    return triangles_by_color_merged;
+    return triangles_by_color;
 }
 
-static std::vector<std::vector<ExPolygons>> merge_segmented_layers(const std::vector<std::vector<ExPolygons>> &segmented_regions,
-                                                                   std::vector<std::vector<ExPolygons>>      &&top_and_bottom_layers,
-                                                                   const size_t                                num_facets_states,
-                                                                   const std::function<void()>                &throw_on_cancel_callback)
+// Merges the side segmentation with the segmentation of top and bottom layers.
+// Both inputs are consumed, the side segmentation is reused for the output, which is indexed by layer and then by extruder - 1.
+static std::vector<std::vector<ExPolygons>> merge_segmented_layers(std::vector<std::vector<ExPolygons>> &&segmented_regions,
+                                                                   std::vector<std::vector<ExPolygons>> &&top_and_bottom_layers,
+                                                                   const size_t                           num_facets_states,
+                                                                   const std::function<void()>           &throw_on_cancel_callback)
 {
-    const size_t                         num_layers = segmented_regions.size();
-    std::vector<std::vector<ExPolygons>> segmented_regions_merged(num_layers);
-    segmented_regions_merged.assign(num_layers, std::vector<ExPolygons>(num_facets_states - 1));
+    const size_t num_layers = segmented_regions.size();
     assert(!top_and_bottom_layers.size() || num_facets_states == top_and_bottom_layers.size());
 
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Merging segmented layers in parallel - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&segmented_regions, &top_and_bottom_layers, &segmented_regions_merged, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&segmented_regions, &top_and_bottom_layers, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-            assert(segmented_regions[layer_idx].size() == num_facets_states);
-            // Zero is skipped because it is the default color of the volume
-            for (size_t extruder_id = 1; extruder_id < num_facets_states; ++extruder_id) {
-                throw_on_cancel_callback();
-                if (!segmented_regions[layer_idx][extruder_id].empty()) {
-                    ExPolygons segmented_regions_trimmed = segmented_regions[layer_idx][extruder_id];
-                    if (!top_and_bottom_layers.empty()) {
-                        for (const std::vector<ExPolygons> &top_and_bottom_by_extruder : top_and_bottom_layers) {
-                            if (!top_and_bottom_by_extruder[layer_idx].empty() && !segmented_regions_trimmed.empty()) {
-                                segmented_regions_trimmed = diff_ex(segmented_regions_trimmed, top_and_bottom_by_extruder[layer_idx]);
-                            }
-                        }
-                    }
-
-                    segmented_regions_merged[layer_idx][extruder_id - 1] = std::move(segmented_regions_trimmed);
+            std::vector<ExPolygons> &regions = segmented_regions[layer_idx];
+            assert(regions.size() == num_facets_states);
+            if (!top_and_bottom_layers.empty()) {
+                // Trim the side segmentation by top and bottom layers of all colors first, because
+                // the top and bottom layers are moved into the output below.
+                for (size_t extruder_id = 1; extruder_id < num_facets_states; ++extruder_id) {
+                    throw_on_cancel_callback();
+                    for (const std::vector<ExPolygons> &top_and_bottom_by_extruder : top_and_bottom_layers)
+                        if (!top_and_bottom_by_extruder[layer_idx].empty() && !regions[extruder_id].empty())
+                            regions[extruder_id] = diff_ex(regions[extruder_id], top_and_bottom_by_extruder[layer_idx]);
                 }
 
-                if (!top_and_bottom_layers.empty() && !top_and_bottom_layers[extruder_id][layer_idx].empty()) {
-                    bool was_top_and_bottom_empty = segmented_regions_merged[layer_idx][extruder_id - 1].empty();
-                    append(segmented_regions_merged[layer_idx][extruder_id - 1], top_and_bottom_layers[extruder_id][layer_idx]);
+                for (size_t extruder_id = 1; extruder_id < num_facets_states; ++extruder_id) {
+                    if (ExPolygons &top_and_bottom = top_and_bottom_layers[extruder_id][layer_idx]; !top_and_bottom.empty()) {
+                        bool was_top_and_bottom_empty = regions[extruder_id].empty();
+                        append(regions[extruder_id], std::move(top_and_bottom));
 
-                    // Remove dimples (#7235) appearing after merging side segmentation of the model with tops and bottoms painted layers.
-                    if (!was_top_and_bottom_empty)
-                        segmented_regions_merged[layer_idx][extruder_id - 1] = offset2_ex(union_ex(segmented_regions_merged[layer_idx][extruder_id - 1]), float(SCALED_EPSILON), -float(SCALED_EPSILON));
+                        // Remove dimples (#7235) appearing after merging side segmentation of the model with tops and bottoms painted layers.
+                        if (!was_top_and_bottom_empty)
+                            regions[extruder_id] = offset2_ex(union_ex(regions[extruder_id]), float(SCALED_EPSILON), -float(SCALED_EPSILON));
+                    }
                 }
             }
+            // Zero is skipped because it is the default color of the volume
+            regions.erase(regions.begin());
         }
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Merging segmented layers in parallel - End";
 
-    return segmented_regions_merged;
+    return std::move(segmented_regions);
 }
 
 // Check if all ColoredLine representing a single layer uses the same color.
@@ -1666,8 +1699,12 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     std::vector<std::vector<ColorProjectionLines>> input_polygons_projection_lines_layers(num_layers);
     std::vector<std::vector<ColorLines>>           color_polygons_lines_layers(num_layers);
 
+    // Wall clock time spent in the individual steps is reported at the end of each step.
+    Timing::Timer timer;
+
     // Merge all regions and remove small holes
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - Begin";
+    timer.start();
     tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &input_polygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
@@ -1699,9 +1736,10 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
             }
         }
     }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - End";
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - End, " << timer.elapsed_milliseconds() << " ms";
 
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - Begin";
+    timer.start();
     const std::vector<float> layer_zs = get_print_object_layers_zs(layers);
     for (const ModelVolume *mv : print_object.model_object()->volumes) {
         std::vector<ColorPolygons> color_polygons_per_layer = slice_model_volume_with_color(*mv, extract_facets_info, layer_zs, print_object, num_facets_states);
@@ -1735,7 +1773,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
             }
         }); // end of parallel_for
     }
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - End";
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - End, " << timer.elapsed_milliseconds() << " ms";
 
     if constexpr (MM_SEGMENTATION_DEBUG_FILTERED_COLOR_LINES) {
         for (size_t layer_idx = 0; layer_idx < print_object.layers().size(); ++layer_idx) {
@@ -1745,6 +1783,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
 
     // Project sliced ColorPolygons on sliced layers (input_expolygons).
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles - Begin";
+    timer.start();
     tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_lines_layers, &input_polygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
@@ -1788,7 +1827,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
             }
         }
     }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - Projection of painted triangles - End";
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles - End, " << timer.elapsed_milliseconds() << " ms";
 
     std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
     segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_facets_states));
@@ -1796,6 +1835,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     // Be aware that after the projection of the ColorPolygons and its postprocessing isn't
     // ensured that consistency of the color_prev. So, only color_next can be used.
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - Begin";
+    timer.start();
     tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&input_polygons_projection_lines_layers, &segmented_regions, &input_expolygons, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
@@ -1833,22 +1873,28 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
             }
         }
     }); // end of parallel_for
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - End";
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - End, " << timer.elapsed_milliseconds() << " ms";
     throw_on_cancel_callback();
 
     // The first index is extruder number (includes default extruder), and the second one is layer number
     std::vector<std::vector<ExPolygons>> top_and_bottom_layers;
     if (include_top_and_bottom_layers == IncludeTopAndBottomLayers::Yes) {
+        timer.start();
         top_and_bottom_layers = segmentation_top_and_bottom_layers(print_object, input_expolygons, extract_facets_info, num_facets_states, throw_on_cancel_callback);
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Segmentation of top and bottom layers took " << timer.elapsed_milliseconds() << " ms";
         throw_on_cancel_callback();
     }
 
     if (segmentation_max_width > 0.f) {
+        timer.start();
         cut_segmented_layers(input_expolygons, segmented_regions, scaled<float>(segmentation_max_width), scaled<float>(segmentation_interlocking_depth), throw_on_cancel_callback);
+        BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Cutting segmented layers took " << timer.elapsed_milliseconds() << " ms";
         throw_on_cancel_callback();
     }
 
-    std::vector<std::vector<ExPolygons>> segmented_regions_merged = merge_segmented_layers(segmented_regions, std::move(top_and_bottom_layers), num_facets_states, throw_on_cancel_callback);
+    timer.start();
+    std::vector<std::vector<ExPolygons>> segmented_regions_merged = merge_segmented_layers(std::move(segmented_regions), std::move(top_and_bottom_layers), num_facets_states, throw_on_cancel_callback);
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Merging segmented layers took " << timer.elapsed_milliseconds() << " ms";
     throw_on_cancel_callback();
 
     if constexpr (MM_SEGMENTATION_DEBUG_REGIONS) {
@@ -0,0 +1,39 @@
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_ParallelPipeline_hpp_
+#define slic3r_ParallelPipeline_hpp_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <tbb/task_arena.h>
+
+// Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
+// We are using quite an old TBB 2017 U7. Before we update our build servers, let's use the old API, which is deprecated in up to date TBB.
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if ! defined(TBB_VERSION_MAJOR)
+    static_assert(false, "TBB_VERSION_MAJOR not defined");
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
+
+namespace Slic3r {
+
+// Maximum number of items in flight for a tbb::parallel_pipeline() with a single parallel stage between
+// serial stages: enough to keep all the threads of the current task arena busy while the serial stages wait.
+inline size_t parallel_pipeline_max_tokens()
+{
+    return std::max<size_t>(4, 2 * size_t(tbb::this_task_arena::max_concurrency()));
+}
+
+} // namespace Slic3r
+
+#endif // slic3r_ParallelPipeline_hpp_
@@ -707,6 +707,7 @@ static std::vector<std::string> s_Preset_sla_printer_options {
     "elefant_foot_compensation",
     "elefant_foot_min_width",
     "gamma_correction",
+    "sla_rasterizer",
     "min_exposure_time", "max_exposure_time",
     "min_initial_exposure_time", "max_initial_exposure_time", "sla_archive_format", "sla_output_precision",
     //FIXME the print host keys are left here just for conversion from the Printer preset to Physical Printer preset.
@@ -69,13 +69,11 @@ void Print::clear()
     m_model.clear_objects();
 }
 
-// Called by Print::apply().
-// This method only accepts PrintConfig option keys.
-bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* new_config */, const std::vector<t_config_option_key> &opt_keys)
+// Collects the steps invalidated by a change of a PrintConfig option into steps and osteps.
+// Returns false if the option is not known, thus all steps shall be invalidated.
+// Shared by Print::invalidate_state_by_config_options() and the slice cache, see PrintObjectSliceCache.cpp.
+bool Print::steps_invalidated_by_config_option(const t_config_option_key &opt_key, std::vector<PrintStep> &steps, std::vector<PrintObjectStep> &osteps)
 {
-    if (opt_keys.empty())
-        return false;
-
     // Cache the plenty of parameters, which influence the G-code generator only,
     // or they are only notes not influencing the generated G-code.
     static std::unordered_set<std::string> steps_gcode = {
@@ -184,114 +182,127 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
 
     static std::unordered_set<std::string> steps_ignore;
 
+    if (steps_gcode.find(opt_key) != steps_gcode.end()) {
+        // These options only affect G-code export or they are just notes without influence on the generated G-code,
+        // so there is nothing to invalidate.
+        steps.emplace_back(psGCodeExport);
+    } else if (steps_ignore.find(opt_key) != steps_ignore.end()) {
+        // These steps have no influence on the G-code whatsoever. Just ignore them.
+    } else if (
+           opt_key == "skirts"
+        || opt_key == "skirt_height"
+        || opt_key == "draft_shield"
+        || opt_key == "skirt_distance"
+        || opt_key == "min_skirt_length"
+        || opt_key == "ooze_prevention") {
+        steps.emplace_back(psSkirtBrim);
+    } else if (
+           opt_key == "first_layer_height"
+        || opt_key == "nozzle_diameter"
+        || opt_key == "resolution"
+        // Spiral Vase forces different kind of slicing than the normal model:
+        // In Spiral Vase mode, holes are closed and only the largest area contour is kept at each layer.
+        // Therefore toggling the Spiral Vase on / off requires complete reslicing.
+        || opt_key == "spiral_vase"
+        || opt_key == "filament_shrinkage_compensation_xy"
+        || opt_key == "filament_shrinkage_compensation_z"
+        || opt_key == "prefer_clockwise_movements") {
+        osteps.emplace_back(posSlice);
+    } else if (
+           opt_key == "complete_objects"
+        || opt_key == "filament_type"
+        || opt_key == "first_layer_temperature"
+        || opt_key == "filament_loading_speed"
+        || opt_key == "filament_loading_speed_start"
+        || opt_key == "filament_unloading_speed"
+        || opt_key == "filament_unloading_speed_start"
+        || opt_key == "filament_toolchange_delay"
+        || opt_key == "filament_cooling_moves"
+        || opt_key == "filament_stamping_loading_speed"
+        || opt_key == "filament_stamping_distance"
+        || opt_key == "filament_minimal_purge_on_wipe_tower"
+        || opt_key == "filament_cooling_initial_speed"
+        || opt_key == "filament_cooling_final_speed"
+        || opt_key == "filament_purge_multiplier"
+        || opt_key == "filament_ramming_parameters"
+        || opt_key == "filament_multitool_ramming"
+        || opt_key == "filament_multitool_ramming_volume"
+        || opt_key == "filament_multitool_ramming_flow"
+        || opt_key == "filament_max_volumetric_speed"
+        || opt_key == "filament_infill_max_speed"
+        || opt_key == "filament_infill_max_crossing_speed"
+        || opt_key == "gcode_flavor"
+        || opt_key == "high_current_on_filament_swap"
+        || opt_key == "infill_first"
+        || opt_key == "single_extruder_multi_material"
+        || opt_key == "temperature"
+        || opt_key == "idle_temperature"
+        || opt_key == "wipe_tower"
+        || opt_key == "wipe_tower_width"
+        || opt_key == "wipe_tower_brim_width"
+        || opt_key == "wipe_tower_cone_angle"
+        || opt_key == "wipe_tower_bridging"
+        || opt_key == "wipe_tower_extra_spacing"
+        || opt_key == "wipe_tower_extra_flow"
+        || opt_key == "wipe_tower_no_sparse_layers"
+        || opt_key == "wipe_tower_extruder"
+        || opt_key == "wiping_volumes_matrix"
+        || opt_key == "wiping_volumes_use_custom_matrix"
+        || opt_key == "parking_pos_retraction"
+        || opt_key == "cooling_tube_retraction"
+        || opt_key == "cooling_tube_length"
+        || opt_key == "extra_loading_move"
+        || opt_key == "multimaterial_purging"
+        || opt_key == "travel_speed"
+        || opt_key == "travel_speed_z"
+        || opt_key == "first_layer_speed"
+        || opt_key == "z_offset") {
+        steps.emplace_back(psWipeTower);
+        steps.emplace_back(psSkirtBrim);
+    } else if (opt_key == "filament_soluble") {
+        steps.emplace_back(psWipeTower);
+        // Soluble support interface / non-soluble base interface produces non-soluble interface layers below soluble interface layers.
+        // Thus switching between soluble / non-soluble interface layer material may require recalculation of supports.
+        //FIXME Killing supports on any change of "filament_soluble" is rough. We should check for each object whether that is necessary.
+        osteps.emplace_back(posSupportMaterial);
+    } else if (
+           opt_key == "first_layer_extrusion_width" 
+        || opt_key == "min_layer_height"
+        || opt_key == "max_layer_height"
+        || opt_key == "gcode_resolution") {
+        osteps.emplace_back(posPerimeters);
+        osteps.emplace_back(posInfill);
+        osteps.emplace_back(posSupportMaterial);
+        steps.emplace_back(psSkirtBrim);
+    } else if (opt_key == "avoid_crossing_curled_overhangs") {
+        osteps.emplace_back(posEstimateCurledExtrusions);
+    } else if (opt_key == "automatic_extrusion_widths") {
+        osteps.emplace_back(posPerimeters);
+    } else {
+        // Unknown option, the caller shall invalidate all steps.
+        return false;
+    }
+    return true;
+}
+
+// Called by Print::apply().
+// This method only accepts PrintConfig option keys.
+bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* new_config */, const std::vector<t_config_option_key> &opt_keys)
+{
+    if (opt_keys.empty())
+        return false;
+
     std::vector<PrintStep> steps;
     std::vector<PrintObjectStep> osteps;
     bool invalidated = false;
 
-    for (const t_config_option_key &opt_key : opt_keys) {
-        if (steps_gcode.find(opt_key) != steps_gcode.end()) {
-            // These options only affect G-code export or they are just notes without influence on the generated G-code,
-            // so there is nothing to invalidate.
-            steps.emplace_back(psGCodeExport);
-        } else if (steps_ignore.find(opt_key) != steps_ignore.end()) {
-            // These steps have no influence on the G-code whatsoever. Just ignore them.
-        } else if (
-               opt_key == "skirts"
-            || opt_key == "skirt_height"
-            || opt_key == "draft_shield"
-            || opt_key == "skirt_distance"
-            || opt_key == "min_skirt_length"
-            || opt_key == "ooze_prevention") {
-            steps.emplace_back(psSkirtBrim);
-        } else if (
-               opt_key == "first_layer_height"
-            || opt_key == "nozzle_diameter"
-            || opt_key == "resolution"
-            // Spiral Vase forces different kind of slicing than the normal model:
-            // In Spiral Vase mode, holes are closed and only the largest area contour is kept at each layer.
-            // Therefore toggling the Spiral Vase on / off requires complete reslicing.
-            || opt_key == "spiral_vase"
-            || opt_key == "filament_shrinkage_compensation_xy"
-            || opt_key == "filament_shrinkage_compensation_z"
-            || opt_key == "prefer_clockwise_movements") {
-            osteps.emplace_back(posSlice);
-        } else if (
-               opt_key == "complete_objects"
-            || opt_key == "filament_type"
-            || opt_key == "first_layer_temperature"
-            || opt_key == "filament_loading_speed"
-            || opt_key == "filament_loading_speed_start"
-            || opt_key == "filament_unloading_speed"
-            || opt_key == "filament_unloading_speed_start"
-            || opt_key == "filament_toolchange_delay"
-            || opt_key == "filament_cooling_moves"
-            || opt_key == "filament_stamping_loading_speed"
-            || opt_key == "filament_stamping_distance"
-            || opt_key == "filament_minimal_purge_on_wipe_tower"
-            || opt_key == "filament_cooling_initial_speed"
-            || opt_key == "filament_cooling_final_speed"
-            || opt_key == "filament_purge_multiplier"
-            || opt_key == "filament_ramming_parameters"
-            || opt_key == "filament_multitool_ramming"
-            || opt_key == "filament_multitool_ramming_volume"
-            || opt_key == "filament_multitool_ramming_flow"
-            || opt_key == "filament_max_volumetric_speed"
-            || opt_key == "filament_infill_max_speed"
-            || opt_key == "filament_infill_max_crossing_speed"
-            || opt_key == "gcode_flavor"
-            || opt_key == "high_current_on_filament_swap"
-            || opt_key == "infill_first"
-            || opt_key == "single_extruder_multi_material"
-            || opt_key == "temperature"
-            || opt_key == "idle_temperature"
-            || opt_key == "wipe_tower"
-            || opt_key == "wipe_tower_width"
-            || opt_key == "wipe_tower_brim_width"
-            || opt_key == "wipe_tower_cone_angle"
-            || opt_key == "wipe_tower_bridging"
-            || opt_key == "wipe_tower_extra_spacing"
-            || opt_key == "wipe_tower_extra_flow"
-            || opt_key == "wipe_tower_no_sparse_layers"
-            || opt_key == "wipe_tower_extruder"
-            || opt_key == "wiping_volumes_matrix"
-            || opt_key == "wiping_volumes_use_custom_matrix"
-            || opt_key == "parking_pos_retraction"
-            || opt_key == "cooling_tube_retraction"
-            || opt_key == "cooling_tube_length"
-            || opt_key == "extra_loading_move"
-            || opt_key == "multimaterial_purging"
-            || opt_key == "travel_speed"
-            || opt_key == "travel_speed_z"
-            || opt_key == "first_layer_speed"
-            || opt_key == "z_offset") {
-            steps.emplace_back(psWipeTower);
-            steps.emplace_back(psSkirtBrim);
-        } else if (opt_key == "filament_soluble") {
-            steps.emplace_back(psWipeTower);
-            // Soluble support interface / non-soluble base interface produces non-soluble interface layers below soluble interface layers.
-            // Thus switching between soluble / non-soluble interface layer material may require recalculation of supports.
-            //FIXME Killing supports on any change of "filament_soluble" is rough. We should check for each object whether that is necessary.
-            osteps.emplace_back(posSupportMaterial);
-        } else if (
-               opt_key == "first_layer_extrusion_width" 
-            || opt_key == "min_layer_height"
-            || opt_key == "max_layer_height"
-            || opt_key == "gcode_resolution") {
-            osteps.emplace_back(posPerimeters);
-            osteps.emplace_back(posInfill);
-            osteps.emplace_back(posSupportMaterial);
-            steps.emplace_back(psSkirtBrim);
-        } else if (opt_key == "avoid_crossing_curled_overhangs") {
-            osteps.emplace_back(posEstimateCurledExtrusions);
-        } else if (opt_key == "automatic_extrusion_widths") {
-            osteps.emplace_back(posPerimeters);
-        } else {
+    for (const t_config_option_key &opt_key : opt_keys)
+        if (! steps_invalidated_by_config_option(opt_key, steps, osteps)) {
             // for legacy, if we can't handle this option let's invalidate all steps
             //FIXME invalidate all steps of all objects as well?
             invalidated |= this->invalidate_all_steps();
             // Continue with the other opt_keys to possibly invalidate any object specific steps.
         }
-    }
 
     sort_remove_duplicates(steps);
     for (PrintStep step : steps)
@@ -978,9 +989,14 @@ void Print::process()
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
         for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            m_objects[idx]->make_perimeters();
-            m_objects[idx]->infill();
-            m_objects[idx]->ironing();
+            PrintObject &obj = *m_objects[idx];
+            // Restore posSlice ... posInfill from the slice cache if enabled, the following steps become no-ops on a cache hit.
+            const bool cached = ! m_slice_cache_dir.empty() && obj.load_from_slice_cache(m_slice_cache_dir);
+            obj.make_perimeters();
+            obj.infill();
+            if (! m_slice_cache_dir.empty() && ! cached)
+                obj.store_to_slice_cache(m_slice_cache_dir);
+            obj.ironing();
         }
     }, tbb::simple_partitioner());
 
@@ -394,8 +394,11 @@ private:
     bool                    invalidate_all_steps();
     // Invalidate steps based on a set of parameters changed.
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
+    // If layer_ranges is set, the parameters were changed for a region referenced by these layer ranges only. Then if the slices
+    // stay valid, posPerimeters will be recalculated only for the layers inside layer_ranges.
     bool                    invalidate_state_by_config_options(
-        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+        const std::vector<t_layer_height_range> *layer_ranges = nullptr);
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -429,6 +432,20 @@ private:
         const std::vector<std::pair<const Surface*, float>>& surfaces_w_bottom_z) const;
     FillLightning::GeneratorPtr prepare_lightning_infill_data();
 
+    // Invalidate posPerimeters, but keep the perimeters of layers outside of layer_ranges if they are valid.
+    bool        invalidate_perimeters_in_layer_ranges(const std::vector<t_layer_height_range> &layer_ranges);
+    // Perimeters of a single layer range are only regenerated if the object is split into multiple layer ranges.
+    // Only then the perimeters before splitting at overhangs are kept for make_perimeters().
+    bool        perimeters_invalidated_by_layer_ranges() const { return m_shared_regions != nullptr && m_shared_regions->layer_ranges.size() > 1; }
+
+    // Persistent on-disk cache of the posSlice ... posInfill steps, implemented in PrintObjectSliceCache.cpp.
+    // MD5 hash of all inputs of the cached steps, used as a file name in the cache directory.
+    std::string slice_cache_key() const;
+    // Restore the layers from the cache and mark posSlice ... posInfill as done. Returns false on cache miss.
+    bool        load_from_slice_cache(const std::string &cache_dir);
+    // Store the layers into the cache, if posInfill is done and the cache entry does not exist yet.
+    void        store_to_slice_cache(const std::string &cache_dir) const;
+
     // XYZ in scaled coordinates
     Vec3crd									m_size;
     PrintObjectConfig                       m_config;
@@ -451,6 +468,9 @@ private:
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
+    // Z ranges of layers, for which make_perimeters() shall regenerate perimeters after posPerimeters was invalidated
+    // by a configuration change of layer range modifiers. Empty if perimeters of all layers shall be regenerated.
+    std::vector<t_layer_height_range>       m_perimeters_dirty_layer_ranges;
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
@@ -697,6 +717,15 @@ public:
     // Returns scaling for each axis representing shrinkage compensations in each axis.
     Vec3d shrinkage_compensation() const;
 
+    // Directory of the persistent cache of sliced objects, see PrintObjectSliceCache.cpp.
+    // The cache is disabled if empty.
+    const std::string&  slice_cache_dir() const { return m_slice_cache_dir; }
+    void                set_slice_cache_dir(const std::string &dir) { m_slice_cache_dir = dir; }
+
+    // Collects the steps invalidated by a change of a PrintConfig option.
+    // Returns false if the option is not known, thus all steps shall be invalidated.
+    static bool         steps_invalidated_by_config_option(const t_config_option_key &opt_key, std::vector<PrintStep> &steps, std::vector<PrintObjectStep> &osteps);
+
 protected:
     // Invalidates the step, and its depending steps in Print.
     bool                invalidate_step(PrintStep step);
@@ -747,6 +776,9 @@ private:
     // Cache to store sequential print clearance contours
     Polygons m_sequential_print_clearance_contours;
 
+    // Directory of the persistent cache of sliced objects, empty if disabled.
+    std::string                             m_slice_cache_dir;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCodeGenerator;
     // To allow GCodeProcessor to emit warnings.
@@ -210,6 +210,12 @@ static const t_config_enum_values s_keys_map_SLADisplayOrientation = {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLADisplayOrientation)
 
+static const t_config_enum_values s_keys_map_SLARasterizer = {
+    { "agg",            slarAGG},
+    { "scanline",       slarScanline}
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(SLARasterizer)
+
 static const t_config_enum_values s_keys_map_SLAPillarConnectionMode = {
     {"zigzag",          int(SLAPillarConnectionMode::zigzag)},
     {"cross",           int(SLAPillarConnectionMode::cross)},
@@ -4274,6 +4280,19 @@ void PrintConfigDef::init_sla_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionFloat(1.0));
 
+    def = this->add("sla_rasterizer", coEnum);
+    def->label = L("Rasterizer");
+    def->tooltip = L("Algorithm drawing the sliced polygons into the layer images. "
+                     "The scanline rasterizer is faster on high resolution displays "
+                     "with many small features per layer, it differs from the AGG "
+                     "rasterizer only in the rounding of the antialiased edge pixels.");
+    def->set_enum<SLARasterizer>({
+        { "agg",        L("AGG") },
+        { "scanline",   L("Scanline") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<SLARasterizer>(slarAGG));
+
 
     // SLA Material settings.
 
@@ -5671,6 +5690,17 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->cli = "slice|s";
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("batch", coString);
+    def->label = L("Batch slicing");
+    def->tooltip = L("Slice a list of jobs read from the given JSON file in a single process, reusing the loaded configuration "
+                     "and the sliced objects between jobs. Each job is a JSON object with the \"input\" file name(s), "
+                     "the \"output\" G-code file name, optional \"load\" config file(s) and optional \"config\" key / value pairs "
+                     "overriding the configuration. The file contains an array of jobs or an object with a \"jobs\" array. "
+                     "If the file name is \"-\", jobs are read from the standard input, one JSON object per line. "
+                     "The configuration embedded in a 3MF input is applied as when slicing the file alone. "
+                     "Transform options other than --dont-arrange and --ensure-on-bed are not supported.");
+    def->set_default_value(new ConfigOptionString());
+
     def = this->add("help", coBool);
     def->label = L("Help");
     def->tooltip = L("Show this help.");
@@ -5844,6 +5874,11 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("slice_cache", coString);
+    def->label = L("Slice cache directory");
+    def->tooltip = L("Store the sliced objects (layers, perimeters and infill) into the given directory and reuse them "
+                     "when the same object is sliced again with the same mesh and slicing parameters.");
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
@@ -260,20 +260,43 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
+    // If posPerimeters was invalidated by a configuration change of some layer range modifiers only,
+    // perimeters are regenerated just for the layers of these layer ranges.
+    std::vector<unsigned char> layer_dirty(m_layers.size(), true);
+    if (! m_perimeters_dirty_layer_ranges.empty()) {
+        size_t num_dirty = 0;
+        for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx) {
+            const coordf_t z = m_layers[layer_idx]->slice_z;
+            layer_dirty[layer_idx] = std::any_of(m_perimeters_dirty_layer_ranges.begin(), m_perimeters_dirty_layer_ranges.end(),
+                [z](const t_layer_height_range &range) { return range.first - EPSILON <= z && z <= range.second + EPSILON; });
+            num_dirty += layer_dirty[layer_idx];
+        }
+        BOOST_LOG_TRIVIAL(info) << "Regenerating perimeters of " << num_dirty << " out of " << m_layers.size() << " layers";
+    }
+
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
+        [this, &layer_dirty](const tbb::blocked_range<size_t>& range) {
             PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                 m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
+                if (layer_dirty[layer_idx])
+                    m_layers[layer_idx]->make_perimeters();
+                else
+                    // Keep the perimeters, just revert their splitting at overhangs, which will be recalculated.
+                    for (LayerRegion *layerm : m_layers[layer_idx]->m_regions)
+                        if (! layerm->m_perimeters_unsplit.empty()) {
+                            layerm->m_perimeters = std::move(layerm->m_perimeters_unsplit);
+                            layerm->m_perimeters_unsplit.clear();
+                        }
             }
         }
     );
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    m_perimeters_dirty_layer_ranges.clear();
     this->set_done(posPerimeters);
 }
 
@@ -586,10 +609,15 @@ void PrintObject::calculate_overhanging_perimeters()
                             continue;
                         }
                         size_t prev_layer_id = l->lower_layer ? l->lower_layer->id() : size_t(-1);
-                        layer_region->m_perimeters =
+                        ExtrusionEntityCollection perimeters =
                             ExtrusionProcessor::calculate_and_split_overhanging_extrusions(&layer_region->m_perimeters,
                                                                                            unscaled_polygons_lines[prev_layer_id],
                                                                                            curled_lines[l->id()]);
+                        if (this->perimeters_invalidated_by_layer_ranges()) {
+                            // Keep the perimeters before splitting for make_perimeters() regenerating perimeters of some layers only.
+                            layer_region->m_perimeters_unsplit = std::move(layer_region->m_perimeters);
+                        }
+                        layer_region->m_perimeters = std::move(perimeters);
                     }
                 }
             });
@@ -691,7 +719,8 @@ SupportLayerPtrs::iterator PrintObject::insert_support_layer(SupportLayerPtrs::i
 // Called by Print::apply().
 // This method only accepts PrintObjectConfig and PrintRegionConfig option keys.
 bool PrintObject::invalidate_state_by_config_options(
-    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys)
+    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+    const std::vector<t_layer_height_range> *layer_ranges)
 {
     if (opt_keys.empty())
         return false;
@@ -917,16 +946,39 @@ bool PrintObject::invalidate_state_by_config_options(
     }
 
     sort_remove_duplicates(steps);
+    if (layer_ranges != nullptr && ! steps.empty() && steps.front() == posPerimeters) {
+        // Slices stay valid, regenerate perimeters of the layers of the modified layer range only.
+        // The steps following posPerimeters are not local to a layer, they are invalidated for the whole object.
+        invalidated |= this->invalidate_perimeters_in_layer_ranges(*layer_ranges);
+        steps.erase(steps.begin());
+    }
     for (PrintObjectStep step : steps)
         invalidated |= this->invalidate_step(step);
     return invalidated;
 }
 
+bool PrintObject::invalidate_perimeters_in_layer_ranges(const std::vector<t_layer_height_range> &layer_ranges)
+{
+    // Perimeters of the other layers are valid if they were all generated, or if just some layer ranges were invalidated since then.
+    bool keep_other_layers = this->perimeters_invalidated_by_layer_ranges() && ! layer_ranges.empty() &&
+        (this->is_step_done_unguarded(posPerimeters) || ! m_perimeters_dirty_layer_ranges.empty());
+    std::vector<t_layer_height_range> dirty_layer_ranges = std::move(m_perimeters_dirty_layer_ranges);
+    bool invalidated = this->invalidate_step(posPerimeters);
+    if (keep_other_layers) {
+        append(dirty_layer_ranges, layer_ranges);
+        m_perimeters_dirty_layer_ranges = std::move(dirty_layer_ranges);
+    }
+    return invalidated;
+}
+
 bool PrintObject::invalidate_step(PrintObjectStep step)
 {
 	bool invalidated = Inherited::invalidate_step(step);
     
     // propagate to dependent steps
+    if (step == posPerimeters || step == posSlice)
+        // Regenerate perimeters of all layers.
+        m_perimeters_dirty_layer_ranges.clear();
     if (step == posPerimeters) {
 		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning,  posSupportSpotsSearch, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
@@ -963,6 +1015,7 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+    m_perimeters_dirty_layer_ranges.clear();
 	return result;
 }
 
@@ -1130,7 +1183,7 @@ void PrintObject::detect_surfaces_type()
                     // find internal surfaces (difference between top/bottom surfaces and others)
                     {
                         Polygons topbottom = to_polygons(top);
-                        polygons_append(topbottom, to_polygons(bottom));
+                        polygons_append(topbottom, bottom);
                         surfaces_append(surfaces_out, diff_ex(surfaces_prev, topbottom), stInternal);
                     }
 
@@ -1357,7 +1410,7 @@ void PrintObject::discover_vertical_shells()
                                 0.5f * float(extflow.scaled_width() + extflow.scaled_spacing()) + (float(perimeters) - 1.f) * flow.scaled_spacing());
                             perimeter_min_spacing = std::min(perimeter_min_spacing, float(std::min(extflow.scaled_spacing(), flow.scaled_spacing())));
                         }
-                        polygons_append(cache.holes, to_polygons(layerm.fill_expolygons()));
+                        polygons_append(cache.holes, layerm.fill_expolygons());
                     }
                     // Save some computing time by reducing the number of polygons.
                     cache.top_surfaces    = union_(cache.top_surfaces);
@@ -1417,7 +1470,7 @@ void PrintObject::discover_vertical_shells()
                         // Holes over all regions. Only collect them once, they are valid for all region_id iterations.
                         if (cache.holes.empty()) {
                             for (size_t region_id = 0; region_id < layer.regions().size(); ++ region_id)
-                                polygons_append(cache.holes, to_polygons(layer.regions()[region_id]->fill_expolygons()));
+                                polygons_append(cache.holes, layer.regions()[region_id]->fill_expolygons());
                         }
                     }
                 });
@@ -1623,7 +1676,7 @@ void PrintObject::discover_vertical_shells()
                         continue;
 
                     // Append the internal solids, so they will be merged with the new ones.
-                    polygons_append(shell, to_polygons(layerm->fill_surfaces().filter_by_type(stInternalSolid)));
+                    polygons_append(shell, layerm->fill_surfaces().filter_by_type(stInternalSolid));
 
                     // These regions will be filled by a rectilinear full infill. Currently this type of infill
                     // only fills regions, which fit at least a single line. To avoid gaps in the sparse infill,
@@ -1652,14 +1705,10 @@ void PrintObject::discover_vertical_shells()
 
                         Polygons object_volume;
                         Polygons internal_volume;
-                        {
-                            Polygons shrinked_bottom_slice = idx_layer > 0 ? to_polygons(m_layers[idx_layer - 1]->lslices) : Polygons{};
-                            Polygons shrinked_upper_slice  = (idx_layer + 1) < m_layers.size() ?
-                                                                 to_polygons(m_layers[idx_layer + 1]->lslices) :
-                                                                 Polygons{};
-                            object_volume = intersection(shrinked_bottom_slice, shrinked_upper_slice);
-                            internal_volume = closing(polygonsInternal, float(SCALED_EPSILON));
-                        }
+                        if (idx_layer > 0 && idx_layer + 1 < m_layers.size())
+                            // Clip the slices directly, without converting them to Polygons first.
+                            object_volume = intersection(m_layers[idx_layer - 1]->lslices, m_layers[idx_layer + 1]->lslices);
+                        internal_volume = closing(polygonsInternal, float(SCALED_EPSILON));
 
                         // The regularization operation may cause scattered tiny drops on the smooth parts of the model, filter them out
                         // If the region checks both following conditions, it is removed:
@@ -1791,14 +1840,11 @@ void PrintObject::bridge_over_infill()
                 Polygons   unsupported_area;
                 Polygons   lower_layer_solids;
                 for (const LayerRegion *region : layer->lower_layer->regions()) {
-                    Polygons fill_polys = to_polygons(region->fill_expolygons());
                     // initially consider the whole layer unsupported, but also gather solid layers to later cut off supported parts
-                    unsupported_area.insert(unsupported_area.end(), fill_polys.begin(), fill_polys.end());
+                    polygons_append(unsupported_area, region->fill_expolygons());
                     for (const Surface &surface : region->fill_surfaces()) {
-                        if (surface.surface_type != stInternal || region->region().config().fill_density.value == 100) {
-                            Polygons p = to_polygons(surface.expolygon);
-                            lower_layer_solids.insert(lower_layer_solids.end(), p.begin(), p.end());
-                        }
+                        if (surface.surface_type != stInternal || region->region().config().fill_density.value == 100)
+                            polygons_append(lower_layer_solids, surface.expolygon);
                     }
                 }
                 unsupported_area = closing(unsupported_area, float(SCALED_EPSILON));
@@ -1816,7 +1862,7 @@ void PrintObject::bridge_over_infill()
                         Polygons unsupported         = intersection(to_polygons(s->expolygon), unsupported_area);
                         // The following flag marks those surfaces, which overlap with unuspported area, but at least part of them is supported. 
                         // These regions can be filtered by area, because they for sure are touching solids on lower layers, and it does not make sense to bridge their tiny overhangs 
-                        bool     partially_supported = area(unsupported) < area(to_polygons(s->expolygon)) - EPSILON;
+                        bool     partially_supported = area(unsupported) < s->expolygon.area() - EPSILON;
                         if (!unsupported.empty() && (!partially_supported || area(unsupported) > 3 * 3 * spacing * spacing)) {
                             Polygons worth_bridging = intersection(to_polygons(s->expolygon), expand(unsupported, 4 * spacing));
                             // after we extracted the part worth briding, we go over the leftovers and merge the tiny ones back, to not brake the surface too much
@@ -1885,8 +1931,7 @@ void PrintObject::bridge_over_infill()
                 Polygons lightning_fill;
                 for (const LayerRegion *region : lower_layer->regions()) {
                     if (region->region().config().fill_pattern == ipLightning) {
-                        Polygons lf = to_polygons(region->fill_surfaces().filter_by_type(stInternal));
-                        lightning_fill.insert(lightning_fill.end(), lf.begin(), lf.end());
+                        polygons_append(lightning_fill, region->fill_surfaces().filter_by_type(stInternal));
                     }
                 }
 
@@ -2391,16 +2436,11 @@ void PrintObject::bridge_over_infill()
                 Polygons total_fill_area;
                 Polygons total_top_area;
                 for (const LayerRegion *region : layer->regions()) {
-                    Polygons top_polys = to_polygons(region->fill_surfaces().filter_by_types({stTop}));
-                    total_top_area.insert(total_top_area.end(), top_polys.begin(), top_polys.end());
-                    Polygons internal_polys = to_polygons(region->fill_surfaces().filter_by_types({stInternal, stInternalSolid}));
-                    expansion_area.insert(expansion_area.end(), internal_polys.begin(), internal_polys.end());
-                    Polygons fill_polys = to_polygons(region->fill_expolygons());
-                    total_fill_area.insert(total_fill_area.end(), fill_polys.begin(), fill_polys.end());
-                    if (region->region().config().fill_pattern == ipLightning) {
-                        Polygons l = to_polygons(region->fill_surfaces().filter_by_type(stInternal));
-                        lightning_area.insert(lightning_area.end(), l.begin(), l.end());
-                    }
+                    polygons_append(total_top_area, region->fill_surfaces().filter_by_types({stTop}));
+                    polygons_append(expansion_area, region->fill_surfaces().filter_by_types({stInternal, stInternalSolid}));
+                    polygons_append(total_fill_area, region->fill_expolygons());
+                    if (region->region().config().fill_pattern == ipLightning)
+                        polygons_append(lightning_area, region->fill_surfaces().filter_by_type(stInternal));
                 }
                 total_fill_area   = closing(total_fill_area, float(SCALED_EPSILON));
                 expansion_area    = closing(expansion_area, float(SCALED_EPSILON));
@@ -0,0 +1,681 @@
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+// Persistent on-disk cache of the results of the posSlice ... posInfill steps of a PrintObject.
+//
+// The cache is content addressed: the file name is the MD5 hash of all inputs of the cached steps,
+// that is the transformed meshes of the ModelVolumes including their multi-material and fuzzy skin painting,
+// the layer Z table, the PrintObjectConfig, all the PrintRegionConfigs and the PrintConfig keys
+// influencing slicing, perimeter and infill generation (see Print::steps_invalidated_by_config_option()).
+// If a file with a matching hash is found, the layers are deserialized and the posSlice ... posInfill steps
+// are marked as done without being calculated.
+// The cache is only enabled by the command line interface, see the "slice_cache" option.
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/uuid/detail/md5.hpp>
+#include <boost/algorithm/hex.hpp>
+#include <cereal/archives/binary.hpp>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+
+#include "Layer.hpp"
+#include "LayerRegion.hpp"
+#include "Model.hpp"
+#include "Print.hpp"
+#include "Slicing.hpp"
+#include "Surface.hpp"
+#include "SurfaceCollection.hpp"
+#include "ExtrusionEntity.hpp"
+#include "ExtrusionEntityCollection.hpp"
+#include "libslic3r_version.h"
+#include "libslic3r/Utils.hpp"
+
+namespace Slic3r {
+
+namespace {
+
+// Increase whenever the layout of the serialized data changes.
+static constexpr const uint32_t SliceCacheMagic   = 0x43535350; // "PSSC"
+static constexpr const uint32_t SliceCacheVersion = 1;
+static constexpr const char    *SliceCacheSuffix  = ".slicecache";
+
+// Keys of PrintConfig, which invalidate any of the cached steps posSlice ... posInfill.
+// Unknown keys invalidate all steps, thus they are hashed as well.
+t_config_option_keys slice_cache_print_config_keys(const PrintConfig &config)
+{
+    t_config_option_keys         out;
+    std::vector<PrintStep>       steps;
+    std::vector<PrintObjectStep> osteps;
+    for (const t_config_option_key &key : config.keys()) {
+        osteps.clear();
+        if (! Print::steps_invalidated_by_config_option(key, steps, osteps) ||
+            std::any_of(osteps.begin(), osteps.end(), [](PrintObjectStep step) { return step <= posInfill; }))
+            out.emplace_back(key);
+    }
+    return out;
+}
+
+class SliceCacheHasher
+{
+public:
+    void add(const void *data, size_t size) { m_md5.process_bytes(data, size); }
+    template<typename T> void add_pod(const T &value) { static_assert(std::is_trivially_copyable_v<T>); this->add(&value, sizeof(T)); }
+    void add(const std::string &str) { this->add_pod(uint64_t(str.size())); this->add(str.data(), str.size()); }
+    void add(const ConfigBase &config, const t_config_option_keys &keys) {
+        for (const t_config_option_key &key : keys)
+            if (config.has(key)) {
+                this->add(key);
+                this->add(config.opt_serialize(key));
+            }
+    }
+    void add(const TriangleSelector::TriangleSplittingData &data) {
+        this->add_pod(uint64_t(data.triangles_to_split.size()));
+        for (const TriangleSelector::TriangleBitStreamMapping &mapping : data.triangles_to_split) {
+            this->add_pod(mapping.triangle_idx);
+            this->add_pod(mapping.bitstream_start_idx);
+        }
+        // std::vector<bool> is not contiguous, pack it into bytes.
+        std::vector<uint8_t> packed((data.bitstream.size() + 7) / 8, 0);
+        for (size_t i = 0; i < data.bitstream.size(); ++ i)
+            if (data.bitstream[i])
+                packed[i / 8] |= uint8_t(1 << (i % 8));
+        this->add_pod(uint64_t(data.bitstream.size()));
+        this->add(packed.data(), packed.size());
+    }
+
+    std::string hex_digest() {
+        using boost::uuids::detail::md5;
+        md5::digest_type digest{};
+        std::string      out;
+        m_md5.get_digest(digest);
+        boost::algorithm::hex(digest, digest + std::size(digest), std::back_inserter(out));
+        return out;
+    }
+
+private:
+    boost::uuids::detail::md5 m_md5;
+};
+
+using OArchive = cereal::BinaryOutputArchive;
+using IArchive = cereal::BinaryInputArchive;
+
+// ExtrusionRole does not expose its bit mask, serialize it modifier by modifier.
+uint16_t extrusion_role_to_bits(const ExtrusionRole role)
+{
+    uint16_t bits = 0;
+    for (int i = 0; i < int(ExtrusionRoleModifier::Count); ++ i)
+        if (role.has(ExtrusionRoleModifier(i)))
+            bits |= uint16_t(1 << i);
+    return bits;
+}
+
+ExtrusionRole extrusion_role_from_bits(const uint16_t bits)
+{
+    ExtrusionRoleModifiers out;
+    for (int i = 0; i < int(ExtrusionRoleModifier::Count); ++ i)
+        if (bits & (1 << i))
+            out = out | ExtrusionRoleModifier(i);
+    return ExtrusionRole(out);
+}
+
+void save(OArchive &ar, const Points &pts)
+{
+    ar(uint64_t(pts.size()));
+    if (! pts.empty())
+        ar(cereal::binary_data(pts.data(), pts.size() * sizeof(Point)));
+}
+
+void load(IArchive &ar, Points &pts)
+{
+    uint64_t n;
+    ar(n);
+    pts.assign(size_t(n), Point());
+    if (n > 0)
+        ar(cereal::binary_data(pts.data(), pts.size() * sizeof(Point)));
+}
+
+void save(OArchive &ar, const ExPolygon &expoly)
+{
+    save(ar, expoly.contour.points);
+    ar(uint64_t(expoly.holes.size()));
+    for (const Polygon &hole : expoly.holes)
+        save(ar, hole.points);
+}
+
+void load(IArchive &ar, ExPolygon &expoly)
+{
+    load(ar, expoly.contour.points);
+    uint64_t n;
+    ar(n);
+    expoly.holes.assign(size_t(n), Polygon());
+    for (Polygon &hole : expoly.holes)
+        load(ar, hole.points);
+}
+
+// Declared before the save_vector() / load_vector() templates to be found by the unqualified lookup.
+void save(OArchive &ar, const Polyline &polyline);
+void load(IArchive &ar, Polyline &polyline);
+void save(OArchive &ar, const BoundingBox &bbox);
+void load(IArchive &ar, BoundingBox &bbox);
+void save(OArchive &ar, const Surface &surface);
+void save(OArchive &ar, const ExtrusionPath &path);
+void save(OArchive &ar, const LayerSlice &lslice);
+void load(IArchive &ar, LayerSlice &lslice);
+
+template<typename T>
+void save_vector(OArchive &ar, const std::vector<T> &v)
+{
+    ar(uint64_t(v.size()));
+    for (const T &item : v)
+        save(ar, item);
+}
+
+template<typename T>
+void load_vector(IArchive &ar, std::vector<T> &v)
+{
+    uint64_t n;
+    ar(n);
+    v.assign(size_t(n), T());
+    for (T &item : v)
+        load(ar, item);
+}
+
+void save(OArchive &ar, const Polyline &polyline) { save(ar, polyline.points); }
+void load(IArchive &ar, Polyline &polyline) { load(ar, polyline.points); }
+
+void save(OArchive &ar, const BoundingBox &bbox) { ar(bbox.min.x(), bbox.min.y(), bbox.max.x(), bbox.max.y(), bbox.defined); }
+void load(IArchive &ar, BoundingBox &bbox) { ar(bbox.min.x(), bbox.min.y(), bbox.max.x(), bbox.max.y(), bbox.defined); }
+
+void save(OArchive &ar, const Surface &surface)
+{
+    ar(int32_t(surface.surface_type), surface.thickness, surface.thickness_layers, surface.bridge_angle, surface.extra_perimeters);
+    save(ar, surface.expolygon);
+}
+
+void load(IArchive &ar, SurfaceCollection &surfaces)
+{
+    uint64_t n;
+    ar(n);
+    surfaces.surfaces.clear();
+    surfaces.surfaces.reserve(size_t(n));
+    for (size_t i = 0; i < size_t(n); ++ i) {
+        int32_t type;
+        Surface surface(stInternal, ExPolygon());
+        ar(type, surface.thickness, surface.thickness_layers, surface.bridge_angle, surface.extra_perimeters);
+        if (type < 0 || type >= int32_t(stCount))
+            throw Slic3r::RuntimeError("Invalid surface type in the slice cache");
+        surface.surface_type = SurfaceType(type);
+        load(ar, surface.expolygon);
+        surfaces.surfaces.emplace_back(std::move(surface));
+    }
+}
+
+void save(OArchive &ar, const SurfaceCollection &surfaces) { save_vector(ar, surfaces.surfaces); }
+
+void save(OArchive &ar, const ExtrusionAttributes &attributes)
+{
+    ar(extrusion_role_to_bits(attributes.role), attributes.mm3_per_mm, attributes.width, attributes.height, attributes.maybe_self_crossing);
+    ar(attributes.overhang_attributes.has_value());
+    if (attributes.overhang_attributes)
+        ar(attributes.overhang_attributes->start_distance_from_prev_layer, attributes.overhang_attributes->end_distance_from_prev_layer,
+           attributes.overhang_attributes->proximity_to_curled_lines);
+}
+
+void load(IArchive &ar, ExtrusionAttributes &attributes)
+{
+    uint16_t role;
+    bool     has_overhang_attributes;
+    ar(role, attributes.mm3_per_mm, attributes.width, attributes.height, attributes.maybe_self_crossing);
+    attributes.role = extrusion_role_from_bits(role);
+    ar(has_overhang_attributes);
+    if (has_overhang_attributes) {
+        OverhangAttributes overhang;
+        ar(overhang.start_distance_from_prev_layer, overhang.end_distance_from_prev_layer, overhang.proximity_to_curled_lines);
+        attributes.overhang_attributes = overhang;
+    } else
+        attributes.overhang_attributes.reset();
+}
+
+void save(OArchive &ar, const ExtrusionPath &path)
+{
+    save(ar, path.attributes());
+    save(ar, path.polyline);
+}
+
+void load(IArchive &ar, ExtrusionPath &path)
+{
+    ExtrusionAttributes attributes;
+    load(ar, attributes);
+    path = ExtrusionPath(attributes);
+    load(ar, path.polyline);
+}
+
+void save(OArchive &ar, const ExtrusionPaths &paths) { save_vector(ar, paths); }
+
+void load(IArchive &ar, ExtrusionPaths &paths)
+{
+    uint64_t n;
+    ar(n);
+    paths.clear();
+    paths.reserve(size_t(n));
+    for (size_t i = 0; i < size_t(n); ++ i) {
+        ExtrusionPath path(ExtrusionRole::None);
+        load(ar, path);
+        paths.emplace_back(std::move(path));
+    }
+}
+
+// Tags of the polymorphic ExtrusionEntity types.
+enum class ExtrusionEntityTag : uint8_t {
+    Path,
+    PathOriented,
+    MultiPath,
+    Loop,
+    Collection,
+};
+
+void save(OArchive &ar, const ExtrusionEntityCollection &collection);
+
+void save(OArchive &ar, const ExtrusionEntity &entity)
+{
+    if (entity.is_collection()) {
+        ar(uint8_t(ExtrusionEntityTag::Collection));
+        save(ar, static_cast<const ExtrusionEntityCollection&>(entity));
+    } else if (const auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity); loop) {
+        ar(uint8_t(ExtrusionEntityTag::Loop), int32_t(loop->loop_role()));
+        save(ar, loop->paths);
+    } else if (const auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(&entity); multipath) {
+        ar(uint8_t(ExtrusionEntityTag::MultiPath));
+        save(ar, multipath->paths);
+    } else if (const auto *path = dynamic_cast<const ExtrusionPath*>(&entity); path) {
+        ar(uint8_t(dynamic_cast<const ExtrusionPathOriented*>(path) ? ExtrusionEntityTag::PathOriented : ExtrusionEntityTag::Path));
+        save(ar, *path);
+    } else
+        throw Slic3r::RuntimeError("Unknown ExtrusionEntity type cannot be stored into the slice cache");
+}
+
+void save(OArchive &ar, const ExtrusionEntityCollection &collection)
+{
+    ar(collection.no_sort, uint64_t(collection.entities.size()));
+    for (const ExtrusionEntity *entity : collection.entities)
+        save(ar, *entity);
+}
+
+void load(IArchive &ar, ExtrusionEntityCollection &collection);
+
+ExtrusionEntity* load_extrusion_entity(IArchive &ar)
+{
+    uint8_t tag;
+    ar(tag);
+    switch (ExtrusionEntityTag(tag)) {
+    case ExtrusionEntityTag::Collection:
+    {
+        auto collection = std::make_unique<ExtrusionEntityCollection>();
+        load(ar, *collection);
+        return collection.release();
+    }
+    case ExtrusionEntityTag::Loop:
+    {
+        int32_t        role;
+        ExtrusionPaths paths;
+        ar(role);
+        load(ar, paths);
+        return new ExtrusionLoop(std::move(paths), ExtrusionLoopRole(role));
+    }
+    case ExtrusionEntityTag::MultiPath:
+    {
+        auto multipath = std::make_unique<ExtrusionMultiPath>();
+        load(ar, multipath->paths);
+        return multipath.release();
+    }
+    case ExtrusionEntityTag::Path:
+    case ExtrusionEntityTag::PathOriented:
+    {
+        ExtrusionAttributes attributes;
+        Polyline            polyline;
+        load(ar, attributes);
+        load(ar, polyline);
+        return ExtrusionEntityTag(tag) == ExtrusionEntityTag::Path ?
+            new ExtrusionPath(std::move(polyline), attributes) :
+            new ExtrusionPathOriented(std::move(polyline), attributes);
+    }
+    default:
+        throw Slic3r::RuntimeError("Invalid ExtrusionEntity type in the slice cache");
+    }
+}
+
+void load(IArchive &ar, ExtrusionEntityCollection &collection)
+{
+    uint64_t n;
+    collection.clear();
+    ar(collection.no_sort, n);
+    collection.entities.reserve(size_t(n));
+    for (size_t i = 0; i < size_t(n); ++ i)
+        collection.entities.emplace_back(load_extrusion_entity(ar));
+}
+
+template<typename T>
+void save(OArchive &ar, const IndexRange<T> &range) { ar(*range.begin(), *range.end()); }
+
+template<typename T>
+void load(IArchive &ar, IndexRange<T> &range)
+{
+    T begin, end;
+    ar(begin, end);
+    if (begin > end)
+        throw Slic3r::RuntimeError("Invalid index range in the slice cache");
+    range = IndexRange<T>(begin, end);
+}
+
+void save(OArchive &ar, const LayerExtrusionRange &range)
+{
+    ar(range.region());
+    save(ar, static_cast<const ExtrusionRange&>(range));
+}
+
+void load(IArchive &ar, LayerExtrusionRange &range)
+{
+    uint32_t       region;
+    ExtrusionRange extrusion_range;
+    ar(region);
+    load(ar, extrusion_range);
+    range = LayerExtrusionRange(region, extrusion_range);
+}
+
+void save(OArchive &ar, const LayerIsland &island)
+{
+    save(ar, island.boundary);
+    save(ar, island.perimeters);
+    save(ar, island.thin_fills);
+    ar(uint64_t(island.fills.size()));
+    for (const LayerExtrusionRange &range : island.fills)
+        save(ar, range);
+    save(ar, island.fill_expolygons);
+    ar(island.fill_region_id);
+}
+
+void load(IArchive &ar, LayerIsland &island)
+{
+    uint64_t n;
+    load(ar, island.boundary);
+    load(ar, island.perimeters);
+    load(ar, island.thin_fills);
+    ar(n);
+    island.fills.clear();
+    for (size_t i = 0; i < size_t(n); ++ i) {
+        LayerExtrusionRange range;
+        load(ar, range);
+        island.fills.push_back(range);
+    }
+    load(ar, island.fill_expolygons);
+    ar(island.fill_region_id);
+}
+
+void save(OArchive &ar, const LayerSlice::Links &links)
+{
+    ar(uint64_t(links.size()));
+    for (const LayerSlice::Link &link : links)
+        ar(link.slice_idx, link.area);
+}
+
+void load(IArchive &ar, LayerSlice::Links &links)
+{
+    uint64_t n;
+    ar(n);
+    links.clear();
+    for (size_t i = 0; i < size_t(n); ++ i) {
+        LayerSlice::Link link;
+        ar(link.slice_idx, link.area);
+        links.push_back(link);
+    }
+}
+
+void save(OArchive &ar, const LayerSlice &lslice)
+{
+    save(ar, lslice.bbox);
+    save(ar, lslice.overlaps_above);
+    save(ar, lslice.overlaps_below);
+    ar(uint64_t(lslice.islands.size()));
+    for (const LayerIsland &island : lslice.islands)
+        save(ar, island);
+}
+
+void load(IArchive &ar, LayerSlice &lslice)
+{
+    uint64_t n;
+    load(ar, lslice.bbox);
+    load(ar, lslice.overlaps_above);
+    load(ar, lslice.overlaps_below);
+    ar(n);
+    lslice.islands.clear();
+    for (size_t i = 0; i < size_t(n); ++ i) {
+        LayerIsland island;
+        load(ar, island);
+        lslice.islands.push_back(std::move(island));
+    }
+}
+
+std::string slice_cache_file_path(const std::string &cache_dir, const std::string &key)
+{
+    return (boost::filesystem::path(cache_dir) / (key + SliceCacheSuffix)).string();
+}
+
+} // anonymous namespace
+
+std::string PrintObject::slice_cache_key() const
+{
+    SliceCacheHasher hasher;
+    hasher.add_pod(SliceCacheMagic);
+    hasher.add_pod(SliceCacheVersion);
+    hasher.add(std::string(SLIC3R_VERSION));
+
+    // Z table of the layers, including the raft.
+    std::vector<coordf_t> layer_height_profile;
+    PrintObject::update_layer_height_profile(*this->model_object(), m_slicing_params, layer_height_profile);
+    std::vector<coordf_t> object_layers = generate_object_layers(m_slicing_params, layer_height_profile);
+    hasher.add_pod(uint64_t(m_slicing_params.raft_layers()));
+    hasher.add_pod(m_slicing_params.object_print_z_min);
+    hasher.add_pod(uint64_t(object_layers.size()));
+    hasher.add(object_layers.data(), object_layers.size() * sizeof(coordf_t));
+
+    // Meshes transformed into the PrintObject coordinate system, as they are being sliced.
+    const Transform3d trafo = this->trafo_centered();
+    for (const ModelVolume *volume : this->model_object()->volumes) {
+        const indexed_triangle_set &its       = volume->mesh().its;
+        const Transform3f           trafo_vol = (trafo * volume->get_matrix()).cast<float>();
+        hasher.add_pod(int32_t(volume->type()));
+        hasher.add_pod(uint64_t(its.vertices.size()));
+        for (const stl_vertex &v : its.vertices) {
+            const Vec3f pt = trafo_vol * v;
+            hasher.add(pt.data(), 3 * sizeof(float));
+        }
+        hasher.add_pod(uint64_t(its.indices.size()));
+        if (! its.indices.empty())
+            hasher.add(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+        hasher.add(volume->mm_segmentation_facets.get_data());
+        hasher.add(volume->fuzzy_skin_facets.get_data());
+    }
+
+    // Configurations: object, print and all the regions, and the assignment of regions to volumes and layer ranges.
+    hasher.add(m_config, m_config.keys());
+    hasher.add(m_print->config(), slice_cache_print_config_keys(m_print->config()));
+    for (const std::unique_ptr<PrintRegion> &region : m_shared_regions->all_regions)
+        hasher.add(region->config(), region->config().keys());
+    for (const PrintObjectRegions::LayerRangeRegions &range : m_shared_regions->layer_ranges) {
+        hasher.add_pod(range.layer_height_range.first);
+        hasher.add_pod(range.layer_height_range.second);
+        for (const PrintObjectRegions::VolumeRegion &region : range.volume_regions) {
+            auto it_volume = std::find(this->model_object()->volumes.begin(), this->model_object()->volumes.end(), region.model_volume);
+            hasher.add_pod(int32_t(it_volume - this->model_object()->volumes.begin()));
+            hasher.add_pod(int32_t(region.parent));
+            hasher.add_pod(int32_t(region.region ? region.region->print_object_region_id() : -1));
+        }
+        for (const PrintObjectRegions::PaintedRegion &region : range.painted_regions) {
+            hasher.add_pod(region.extruder_id);
+            hasher.add_pod(int32_t(region.parent));
+            hasher.add_pod(int32_t(region.region->print_object_region_id()));
+        }
+        for (const PrintObjectRegions::FuzzySkinPaintedRegion &region : range.fuzzy_skin_painted_regions) {
+            hasher.add_pod(int32_t(region.parent_type));
+            hasher.add_pod(int32_t(region.parent));
+            hasher.add_pod(int32_t(region.region->print_object_region_id()));
+        }
+    }
+
+    return hasher.hex_digest();
+}
+
+bool PrintObject::load_from_slice_cache(const std::string &cache_dir)
+{
+    // Only restore into a PrintObject with no slicing data, the layers may be referenced otherwise.
+    if (cache_dir.empty() || this->is_step_done(posSlice))
+        return false;
+
+    const std::string path = slice_cache_file_path(cache_dir, this->slice_cache_key());
+    boost::system::error_code ec;
+    if (! boost::filesystem::is_regular_file(path, ec))
+        return false;
+
+    LayerPtrs layers;
+    bool      typed_slices = false;
+    try {
+        boost::nowide::ifstream ifs(path, std::ios::binary);
+        IArchive ar(ifs);
+        uint32_t magic, version;
+        uint64_t num_layers, num_regions;
+        ar(magic, version);
+        if (magic != SliceCacheMagic || version != SliceCacheVersion)
+            throw Slic3r::RuntimeError("Unsupported slice cache format");
+        ar(typed_slices, num_layers, num_regions);
+        if (num_regions != this->num_printing_regions())
+            throw Slic3r::RuntimeError("Number of regions does not match");
+        layers.reserve(size_t(num_layers));
+        Layer *prev = nullptr;
+        for (size_t i = 0; i < size_t(num_layers); ++ i) {
+            uint64_t id;
+            coordf_t height, print_z, slice_z;
+            ar(id, height, print_z, slice_z);
+            Layer *layer = new Layer(size_t(id), this, height, print_z, slice_z);
+            layers.emplace_back(layer);
+            if (prev != nullptr) {
+                prev->upper_layer  = layer;
+                layer->lower_layer = prev;
+            }
+            prev = layer;
+            load_vector(ar, layer->lslices);
+            uint64_t n;
+            ar(n);
+            layer->lslice_indices_sorted_by_print_order.assign(size_t(n), 0);
+            for (size_t &idx : layer->lslice_indices_sorted_by_print_order) {
+                uint64_t v;
+                ar(v);
+                idx = size_t(v);
+            }
+            ar(n);
+            layer->lslices_ex.assign(size_t(n), LayerSlice());
+            for (LayerSlice &lslice : layer->lslices_ex)
+                load(ar, lslice);
+            layer->m_regions.reserve(size_t(num_regions));
+            for (size_t region_id = 0; region_id < size_t(num_regions); ++ region_id) {
+                LayerRegion *layerm = layer->add_region(&this->printing_region(region_id));
+                load_vector(ar, layerm->m_raw_slices);
+                load(ar, layerm->m_slices);
+                load_vector(ar, layerm->m_fill_expolygons);
+                load_vector(ar, layerm->m_fill_expolygons_bboxes);
+                load_vector(ar, layerm->m_fill_expolygons_composite);
+                load_vector(ar, layerm->m_fill_expolygons_composite_bboxes);
+                load(ar, layerm->m_fill_surfaces);
+                load(ar, layerm->m_thin_fills);
+                load_vector(ar, layerm->m_unsupported_bridge_edges);
+                load(ar, layerm->m_perimeters);
+                load(ar, layerm->m_fills);
+            }
+        }
+    } catch (const std::exception &ex) {
+        for (Layer *layer : layers)
+            delete layer;
+        BOOST_LOG_TRIVIAL(warning) << "Failed to load the slice cache " << path << ": " << ex.what();
+        return false;
+    }
+
+    // Install the loaded layers and mark the cached steps as done.
+    if (this->set_started(posSlice)) {
+        this->clear_layers();
+        m_layers       = std::move(layers);
+        m_typed_slices = typed_slices;
+        this->set_done(posSlice);
+    } else {
+        for (Layer *layer : layers)
+            delete layer;
+        return false;
+    }
+    for (PrintObjectStep step : { posPerimeters, posPrepareInfill, posInfill })
+        if (this->set_started(step))
+            this->set_done(step);
+    BOOST_LOG_TRIVIAL(info) << "Loaded " << m_layers.size() << " layers of object " << this->model_object()->name << " from the slice cache " << path;
+    return true;
+}
+
+void PrintObject::store_to_slice_cache(const std::string &cache_dir) const
+{
+    if (cache_dir.empty() || ! this->is_step_done(posInfill))
+        return;
+
+    const std::string path = slice_cache_file_path(cache_dir, this->slice_cache_key());
+    boost::system::error_code ec;
+    if (boost::filesystem::exists(path, ec))
+        return;
+
+    // Write into a temporary file first, then rename, so that concurrent processes sharing the cache never see a partial file.
+    // The temporary name is unique, as several objects of this process may store the same cache entry concurrently.
+    const std::string path_tmp = path + boost::filesystem::unique_path(".%%%%-%%%%-%%%%-%%%%.tmp").string();
+    try {
+        boost::filesystem::create_directories(cache_dir);
+        {
+            boost::nowide::ofstream ofs(path_tmp, std::ios::binary);
+            OArchive ar(ofs);
+            ar(SliceCacheMagic, SliceCacheVersion);
+            ar(m_typed_slices, uint64_t(m_layers.size()), uint64_t(this->num_printing_regions()));
+            for (const Layer *layer : m_layers) {
+                ar(uint64_t(layer->id()), layer->height, layer->print_z, layer->slice_z);
+                save_vector(ar, layer->lslices);
+                ar(uint64_t(layer->lslice_indices_sorted_by_print_order.size()));
+                for (size_t idx : layer->lslice_indices_sorted_by_print_order)
+                    ar(uint64_t(idx));
+                save_vector(ar, layer->lslices_ex);
+                assert(layer->region_count() == this->num_printing_regions());
+                for (const LayerRegion *layerm : layer->regions()) {
+                    save_vector(ar, layerm->m_raw_slices);
+                    save(ar, layerm->m_slices);
+                    save_vector(ar, layerm->m_fill_expolygons);
+                    save_vector(ar, layerm->m_fill_expolygons_bboxes);
+                    save_vector(ar, layerm->m_fill_expolygons_composite);
+                    save_vector(ar, layerm->m_fill_expolygons_composite_bboxes);
+                    save(ar, layerm->m_fill_surfaces);
+                    save(ar, layerm->m_thin_fills);
+                    save_vector(ar, layerm->m_unsupported_bridge_edges);
+                    save(ar, layerm->m_perimeters);
+                    save(ar, layerm->m_fills);
+                }
+            }
+            if (! ofs)
+                throw Slic3r::RuntimeError("Write error");
+        }
+        boost::filesystem::rename(path_tmp, path);
+        BOOST_LOG_TRIVIAL(info) << "Stored " << m_layers.size() << " layers of object " << this->model_object()->name << " into the slice cache " << path;
+    } catch (const std::exception &ex) {
+        boost::filesystem::remove(path_tmp, ec);
+        BOOST_LOG_TRIVIAL(warning) << "Failed to store the slice cache " << path << ": " << ex.what();
+    }
+}
+
+} // namespace Slic3r
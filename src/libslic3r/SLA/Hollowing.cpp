@@ -39,7 +39,7 @@ namespace sla {
 
 struct Interior {
     indexed_triangle_set mesh;
-    VoxelGridPtr gridptr;
+    std::shared_ptr<VoxelGrid> gridptr;
 
     double iso_surface = 0.;
     double thickness = 0.;
@@ -78,25 +78,30 @@ VoxelGrid &get_grid(Interior &interior)
     return *interior.gridptr;
 }
 
-InteriorPtr generate_interior(const VoxelGrid       &vgrid,
-                              const HollowingConfig &hc,
-                              const JobController   &ctl)
+// Narrow band ranges of the field needed to hollow with the given config.
+static float interior_range(const HollowingConfig &hc)
+{
+    return 1.1f * float(hc.min_thickness + hc.closing_distance); // world units
+}
+
+static float exterior_range(double voxsc)
+{
+    return float(1. / voxsc); // world units
+}
+
+// Generate the interior from a field, which narrow band is already dilated
+// to interior_range() and exterior_range().
+static InteriorPtr generate_interior_dilated(std::shared_ptr<VoxelGrid> gridptr,
+                                             double                     voxsc,
+                                             const HollowingConfig     &hc,
+                                             const JobController       &ctl)
 {
-    double voxsc    = get_voxel_scale(vgrid);
     double offset   = hc.min_thickness;              // world units
     double D        = hc.closing_distance;           // world units
-    float  in_range = 1.1f * float(offset + D);      // world units
-    float  out_range = 1.f / voxsc; // world units
+    float  in_range = interior_range(hc);            // world units
+    float  out_range = exterior_range(voxsc);        // world units
     auto   narrowb  = 1.f;  // voxel units (voxel count)
 
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(0, _u8L("Hollowing"));
-
-    auto gridptr = dilate_grid(vgrid, out_range, in_range);
-
-    if (ctl.stopcondition()) return {};
-    else ctl.statuscb(30, _u8L("Hollowing"));
-
     double iso_surface = D;
     if (D > EPSILON) {
         gridptr = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb);
@@ -128,6 +133,44 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
     return interior;
 }
 
+InteriorPtr generate_interior(const VoxelGrid       &vgrid,
+                              const HollowingConfig &hc,
+                              const JobController   &ctl)
+{
+    double voxsc = get_voxel_scale(vgrid);
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(0, _u8L("Hollowing"));
+
+    std::shared_ptr<VoxelGrid> gridptr =
+        dilate_grid(vgrid, exterior_range(voxsc), interior_range(hc));
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(30, _u8L("Hollowing"));
+
+    return generate_interior_dilated(std::move(gridptr), voxsc, hc, ctl);
+}
+
+InteriorPtr generate_interior(const HollowingGrid   &grid,
+                              const HollowingConfig &hc,
+                              const JobController   &ctl)
+{
+    assert(grid.grid);
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(0, _u8L("Hollowing"));
+
+    // Always dilate the kept field, not a previously dilated one, so that the
+    // interior does not depend on the order of the config changes.
+    std::shared_ptr<VoxelGrid> gridptr =
+        dilate_grid(*grid.grid, exterior_range(grid.voxel_scale), interior_range(hc));
+
+    if (ctl.stopcondition()) return {};
+    else ctl.statuscb(30, _u8L("Hollowing"));
+
+    return generate_interior_dilated(std::move(gridptr), grid.voxel_scale, hc, ctl);
+}
+
 indexed_triangle_set DrainHole::to_mesh() const
 {
     auto r = double(radius);
@@ -752,9 +795,10 @@ DrainHoles transformed_drainhole_points(const ModelObject &mo,
     return pts;
 }
 
+static constexpr double MIN_SAMPLES_IN_WALL = 3.5;
+
 double get_voxel_scale(double mesh_volume, const HollowingConfig &hc)
 {
-    static constexpr double MIN_SAMPLES_IN_WALL = 3.5;
     static constexpr double MAX_OVERSAMPL = 8.;
     static constexpr double UNIT_VOLUME   = 500000; // empiric
 
@@ -104,6 +104,20 @@ InteriorPtr generate_interior(const VoxelGrid &mesh,
                               const HollowingConfig &  = {},
                               const JobController &ctl = {});
 
+// Signed distance field of the mesh to be hollowed. It can be kept to
+// regenerate the interior when just the wall thickness or the closing distance
+// changes, see update_hollowing_grid(). The field itself is never dilated,
+// each interior is generated from a dilated copy.
+struct HollowingGrid
+{
+    std::shared_ptr<VoxelGrid> grid;
+    double voxel_scale = 0.;
+};
+
+InteriorPtr generate_interior(const HollowingGrid &grid,
+                              const HollowingConfig &  = {},
+                              const JobController &ctl = {});
+
 // Return the maximum possible volume (upper bound) of a csg mesh.
 // Not the exact volume, that would require actually doing the booleans.
 template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
@@ -129,9 +143,9 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
 }
 
 template<class It>
-InteriorPtr generate_interior(const Range<It>       &csgparts,
-                              const HollowingConfig &hc  = {},
-                              const JobController   &ctl = {})
+HollowingGrid generate_hollowing_grid(const Range<It>       &csgparts,
+                                      const HollowingConfig &hc  = {},
+                                      const JobController   &ctl = {})
 {
     double mesh_vol = csgmesh_positive_maxvolume(csgparts);
     double voxsc    = get_voxel_scale(mesh_vol, hc);
@@ -153,8 +167,38 @@ InteriorPtr generate_interior(const Range<It>       &csgparts,
                           params.exterior_bandwidth(),
                           params.interior_bandwidth());
 
-    return ptr ? generate_interior(*ptr, hc, ctl) :
-                 InteriorPtr{};
+    HollowingGrid ret;
+    if (ptr) {
+        ret.grid        = std::move(ptr);
+        ret.voxel_scale = voxsc;
+    }
+
+    return ret;
+}
+
+// Voxelize csgparts into grid, unless the grid has the voxel scale the config
+// asks for. The interior is then the same as if the grid was generated anew.
+// The grid has to be reset by the caller whenever csgparts change.
+template<class It>
+void update_hollowing_grid(HollowingGrid         &grid,
+                           const Range<It>       &csgparts,
+                           const HollowingConfig &hc  = {},
+                           const JobController   &ctl = {})
+{
+    if (! grid.grid ||
+        grid.voxel_scale != get_voxel_scale(csgmesh_positive_maxvolume(csgparts), hc))
+        grid = generate_hollowing_grid(csgparts, hc, ctl);
+}
+
+template<class It>
+InteriorPtr generate_interior(const Range<It>       &csgparts,
+                              const HollowingConfig &hc  = {},
+                              const JobController   &ctl = {})
+{
+    HollowingGrid grid = generate_hollowing_grid(csgparts, hc, ctl);
+
+    return grid.grid ? generate_interior(grid, hc, ctl) :
+                       InteriorPtr{};
 }
 
 inline InteriorPtr generate_interior(const indexed_triangle_set &mesh,
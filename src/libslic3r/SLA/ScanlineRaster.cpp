@@ -0,0 +1,237 @@
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "ScanlineRaster.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 is part of x86-64, the partially covered spans are blended 16 pixels at once.
+    #include <emmintrin.h>
+    #define SLIC3R_RASTER_SIMD
+#endif
+
+namespace Slic3r { namespace sla {
+
+RasterGrayscaleAAScanline::RasterGrayscaleAAScanline(const Resolution &res,
+                                                     const PixelDim   &pd,
+                                                     const Trafo      &trafo,
+                                                     double            gamma)
+    : m_resolution(res)
+    , m_pxdim_scaled(SCALING_FACTOR, SCALING_FACTOR)
+    , m_trafo(trafo)
+    , m_buf(res.pixels(), 0)
+{
+    // Visual Studio compiler gives warnings about possible division by zero.
+    assert(pd.w_mm != 0 && pd.h_mm != 0);
+    if (pd.w_mm != 0 && pd.h_mm != 0) {
+        m_pxdim_scaled.w_mm /= pd.w_mm;
+        m_pxdim_scaled.h_mm /= pd.h_mm;
+    }
+
+    // Same table as agg::rasterizer_scanline_aa::gamma() builds from
+    // agg::gamma_power(gamma) or agg::gamma_threshold(.5).
+    for (size_t i = 0; i < m_gamma.size(); ++ i) {
+        double cover = double(i) / 255.;
+        double v     = gamma > 0 ? std::pow(cover, gamma) : (cover < .5 ? 0. : 1.);
+        m_gamma[i]   = uint8_t(v * 255. + .5);
+    }
+}
+
+Vec2d RasterGrayscaleAAScanline::to_px(const Point &p) const
+{
+    // Mirrors AGGRaster::to_path().
+    Vec2d v = m_trafo.flipXY ?
+        Vec2d(double(p.y()) * m_pxdim_scaled.h_mm, double(p.x()) * m_pxdim_scaled.w_mm) :
+        Vec2d(double(p.x()) * m_pxdim_scaled.w_mm, double(p.y()) * m_pxdim_scaled.h_mm);
+
+    v.x() += m_trafo.center_x * m_pxdim_scaled.w_mm;
+    v.y() += m_trafo.center_y * m_pxdim_scaled.h_mm;
+
+    if (m_trafo.mirror_x) v.x() = double(m_resolution.width_px) - v.x();
+    if (m_trafo.mirror_y) v.y() = double(m_resolution.height_px) - v.y();
+
+    return v;
+}
+
+void RasterGrayscaleAAScanline::add_polygon(const Polygon &poly)
+{
+    if (poly.points.size() < 3)
+        return;
+
+    Vec2d prev = to_px(poly.points.back());
+    for (const Point &pt : poly.points) {
+        Vec2d next = to_px(pt);
+        add_line(prev, next);
+        prev = next;
+    }
+}
+
+// Accumulate the signed area right of the edge into the cells of each row the
+// edge crosses, so that the prefix sum of a row of cells is the winding number
+// weighted by the pixel coverage.
+void RasterGrayscaleAAScanline::add_line(Vec2d a, Vec2d b)
+{
+    if (a.y() == b.y())
+        return;
+
+    float dir = 1.f;
+    if (a.y() > b.y()) {
+        std::swap(a, b);
+        dir = -1.f;
+    }
+
+    const double height = double(m_resolution.height_px);
+    const double width  = double(m_resolution.width_px);
+    if (b.y() <= 0. || a.y() >= height)
+        return;
+
+    const double dxdy  = (b.x() - a.x()) / (b.y() - a.y());
+    const int    y_end = int(std::min(height, std::ceil(b.y())));
+    int          y     = int(std::max(0., std::floor(a.y())));
+    double       x     = a.x() + (std::max(double(y), a.y()) - a.y()) * dxdy;
+
+    for (; y < y_end; ++ y) {
+        const double dy    = std::min(double(y + 1), b.y()) - std::max(double(y), a.y());
+        const double xnext = x + dxdy * dy;
+        const float  d     = float(dy) * dir;
+        const double x0    = std::min(x, xnext);
+        const double x1    = std::max(x, xnext);
+        x = xnext;
+
+        if (x1 <= 0.) {
+            // The whole row of the raster is right of the edge.
+            add_cell(0, y, d);
+            continue;
+        }
+        if (x0 >= width)
+            continue;
+
+        const double x0floor = std::floor(x0);
+        const double x1ceil  = std::ceil(x1);
+        const int    x0i     = int(x0floor);
+        const int    x1i     = int(x1ceil);
+        if (x1i <= x0i + 1) {
+            // The edge stays within a single pixel of this row.
+            const float xmf = float(.5 * (x0 + x1) - x0floor);
+            add_cell(x0i, y, d - d * xmf);
+            add_cell(x0i + 1, y, d * xmf);
+        } else {
+            const double s   = 1. / (x1 - x0);
+            const double x0f = x0 - x0floor;
+            const double a0  = .5 * s * (1. - x0f) * (1. - x0f);
+            const double x1f = x1 - x1ceil + 1.;
+            const double am  = .5 * s * x1f * x1f;
+            add_cell(x0i, y, float(d * a0));
+            if (x1i == x0i + 2) {
+                add_cell(x0i + 1, y, float(d * (1. - a0 - am)));
+            } else {
+                const double a1 = s * (1.5 - x0f);
+                add_cell(x0i + 1, y, float(d * (a1 - a0)));
+                // Cells left of the raster are merged into its first column,
+                // cells right of the raster are skipped.
+                int       xi     = x0i + 2;
+                const int xi_end = std::min(x1i - 1, int(m_resolution.width_px));
+                if (xi < 0) {
+                    add_cell(0, y, float(d * s * std::min(-xi, xi_end - xi)));
+                    xi = 0;
+                }
+                for (; xi < xi_end; ++ xi)
+                    add_cell(xi, y, float(d * s));
+                const double a2 = a1 + (x1i - x0i - 3) * s;
+                add_cell(x1i - 1, y, float(d * (1. - a2 - am)));
+            }
+            add_cell(x1i, y, float(d * am));
+        }
+    }
+}
+
+// Blend white with the same opacity into a span of pixels, exactly like
+// agg::pixfmt_gray8 does with agg::gray8::lerp().
+static void blend_span(uint8_t *dst, size_t n, uint8_t alpha)
+{
+    if (alpha == 0)
+        return;
+    if (alpha == 255) {
+        std::memset(dst, 255, n);
+        return;
+    }
+
+    size_t i = 0;
+#ifdef SLIC3R_RASTER_SIMD
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i a    = _mm_set1_epi16(alpha);
+    auto lerp = [&](__m128i p) {
+        // t = (255 - p) * alpha + 128 fits into 16 bits, so does (t >> 8) + t.
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(full, p), a), half);
+        return _mm_add_epi16(p, _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(t, 8), t), 8));
+    };
+    for (; i + 16 <= n; i += 16) {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        p = _mm_packus_epi16(lerp(_mm_unpacklo_epi8(p, zero)), lerp(_mm_unpackhi_epi8(p, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), p);
+    }
+#endif // SLIC3R_RASTER_SIMD
+    for (; i < n; ++ i) {
+        unsigned t = unsigned(255 - dst[i]) * alpha + 128;
+        dst[i] = uint8_t(dst[i] + (((t >> 8) + t) >> 8));
+    }
+}
+
+void RasterGrayscaleAAScanline::render_row(uint8_t *row, const Cell *begin, const Cell *end) const
+{
+    const int width = int(m_resolution.width_px);
+    float     cover = 0.f;
+    for (const Cell *cell = begin; cell != end;) {
+        const int x = cell->x;
+        for (; cell != end && cell->x == x; ++ cell)
+            cover += cell->cover;
+        // The coverage is constant up to the next cell. Past the last cell it
+        // is zero unless the polygon continues beyond the right raster edge.
+        const int x_end = cell == end ? width : cell->x;
+        // Coverage scaled to 0..256 like by agg::rasterizer_scanline_aa::calculate_alpha().
+        const int c = std::min(255, int(std::abs(cover) * 256.f));
+        blend_span(row + x, size_t(x_end - x), m_gamma[c]);
+    }
+}
+
+void RasterGrayscaleAAScanline::draw(const ExPolygon &poly)
+{
+    m_cells.clear();
+    add_polygon(poly.contour);
+    for (const Polygon &hole : poly.holes)
+        add_polygon(hole);
+    if (m_cells.empty())
+        return;
+
+    // Counting sort of the cells by rows.
+    auto [ymin, ymax] = std::minmax_element(m_cells.begin(), m_cells.end(),
+        [](const Cell &l, const Cell &r) { return l.y < r.y; });
+    const int y0 = ymin->y;
+    // Count the cells of each row, convert the counts to the row ends, then
+    // scatter the cells while moving the row ends to the row starts.
+    m_row_start.assign(size_t(ymax->y - y0 + 1), 0);
+    for (const Cell &cell : m_cells)
+        ++ m_row_start[cell.y - y0];
+    size_t offset = 0;
+    for (size_t &row : m_row_start)
+        offset = (row += offset);
+    m_sorted_cells.resize(m_cells.size());
+    for (auto it = m_cells.rbegin(); it != m_cells.rend(); ++ it)
+        m_sorted_cells[-- m_row_start[it->y - y0]] = *it;
+
+    for (size_t irow = 0; irow < m_row_start.size(); ++ irow) {
+        Cell *begin = m_sorted_cells.data() + m_row_start[irow];
+        Cell *end   = m_sorted_cells.data() + (irow + 1 < m_row_start.size() ? m_row_start[irow + 1] : m_sorted_cells.size());
+        if (begin == end)
+            continue;
+        std::sort(begin, end, [](const Cell &l, const Cell &r) { return l.x < r.x; });
+        render_row(m_buf.data() + size_t(y0 + int(irow)) * m_resolution.width_px, begin, end);
+    }
+}
+
+}} // namespace Slic3r::sla
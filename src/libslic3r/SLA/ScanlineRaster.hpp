@@ -0,0 +1,94 @@
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef SLA_SCANLINERASTER_HPP
+#define SLA_SCANLINERASTER_HPP
+
+#include <stddef.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <libslic3r/SLA/RasterBase.hpp>
+#include "libslic3r/ExPolygon.hpp"
+
+namespace Slic3r { namespace sla {
+
+/*
+ * Anti-aliased monochrome canvas, an alternative to RasterGrayscaleAA which
+ * does not go through the generic AGG scanline machinery.
+ *
+ * Each polygon edge deposits the exact signed area it covers into cells of the
+ * pixels it passes through. Only these cells are stored, sorted by rows and
+ * columns, and the coverage between two cells of a row is constant, thus it is
+ * filled as a whole span. Polygons are filled by the non-zero rule in white
+ * over the black background, the gamma is applied to the coverage the same
+ * way as by create_raster_grayscale_aa(): zero gamma means thresholding.
+ */
+class RasterGrayscaleAAScanline : public RasterBase {
+public:
+    RasterGrayscaleAAScanline(const Resolution &res,
+                              const PixelDim   &pd,
+                              const Trafo      &trafo,
+                              double            gamma = 1.);
+
+    Trafo      trafo() const override { return m_trafo; }
+    Resolution resolution() const { return m_resolution; }
+    PixelDim   pixel_dimensions() const
+    {
+        return {SCALING_FACTOR / m_pxdim_scaled.w_mm,
+                SCALING_FACTOR / m_pxdim_scaled.h_mm};
+    }
+
+    void draw(const ExPolygon &poly) override;
+
+    EncodedRaster encode(RasterEncoder encoder) const override
+    {
+        return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);
+    }
+
+    uint8_t read_pixel(size_t col, size_t row) const
+    {
+        return m_buf[row * m_resolution.width_px + col];
+    }
+
+    void clear() { std::fill(m_buf.begin(), m_buf.end(), uint8_t(0)); }
+
+private:
+    struct Cell {
+        int   x;
+        int   y;
+        float cover;
+    };
+
+    Resolution m_resolution;
+    PixelDim   m_pxdim_scaled;    // used for scaled coordinate polygons
+    Trafo      m_trafo;
+
+    // Opacity of a pixel indexed by its coverage 0..255.
+    std::array<uint8_t, 256> m_gamma;
+
+    std::vector<uint8_t> m_buf;
+
+    // Working buffers of draw(), kept to avoid reallocation per polygon.
+    std::vector<Cell>   m_cells;
+    std::vector<Cell>   m_sorted_cells;
+    std::vector<size_t> m_row_start;
+
+    Vec2d to_px(const Point &p) const;
+    void  add_polygon(const Polygon &poly);
+    void  add_line(Vec2d a, Vec2d b);
+    void  add_cell(int x, int y, float cover)
+    {
+        // The cells left of the raster accumulate into its first column,
+        // the cells right of it do not influence any pixel.
+        if (x < int(m_resolution.width_px))
+            m_cells.push_back({ std::max(x, 0), y, cover });
+    }
+    void  render_row(uint8_t *row, const Cell *begin, const Cell *end) const;
+};
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SCANLINERASTER_HPP
@@ -68,7 +68,7 @@ SupportPointGenerator::SupportPointGenerator(
     : SupportPointGenerator(emesh, config, throw_on_cancel, statusfn)
 {
     std::random_device rd;
-    m_rng.seed(rd());
+    seed(rd());
     execute(slices, heights);
 }
 
@@ -238,61 +238,199 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
 
     std::vector<SupportPointGenerator::MyLayer> layers = make_layers(slices, heights, m_throw_on_cancel);
 
+    if (m_config.parallel_island_stacks) {
+        process_island_stacks(layers);
+        return;
+    }
+
     PointGrid3D point_grid;
     point_grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+    Placement placement{ m_rng, point_grid, m_output };
 
     double increment = 100.0 / layers.size();
     double status    = 0;
 
+    std::vector<size_t> bottom_islands;
+    std::vector<size_t> top_islands;
     for (unsigned int layer_id = 0; layer_id < layers.size(); ++ layer_id) {
         SupportPointGenerator::MyLayer *layer_top     = &layers[layer_id];
         SupportPointGenerator::MyLayer *layer_bottom  = (layer_id > 0) ? &layers[layer_id - 1] : nullptr;
-        std::vector<float>        support_force_bottom;
-        if (layer_bottom != nullptr) {
-            support_force_bottom.assign(layer_bottom->islands.size(), 0.f);
-            for (size_t i = 0; i < layer_bottom->islands.size(); ++ i)
-                support_force_bottom[i] = layer_bottom->islands[i].supports_force_total();
-        }
-        for (Structure &top : layer_top->islands)
-            for (Structure::Link &bottom_link : top.islands_below) {
-                Structure &bottom = *bottom_link.island;
-                //float centroids_dist = (bottom.centroid - top.centroid).norm();
-                // Penalization resulting from centroid offset:
+        top_islands.resize(layer_top->islands.size());
+        std::iota(top_islands.begin(), top_islands.end(), 0);
+        process_layer(layer_bottom, bottom_islands, *layer_top, top_islands, placement);
+        bottom_islands.swap(top_islands);
+
+        m_throw_on_cancel();
+
+        status += increment;
+        m_statusfn(int(std::round(status)));
+    }
+}
+
+// Propagate the support force from the islands of layer_bottom to the islands of layer_top
+// and add support points where the inherited force is not sufficient. The islands are given
+// by their sorted indices into the layers, the islands below the top islands and the islands
+// above the bottom islands have to be among them.
+void SupportPointGenerator::process_layer(const MyLayer *layer_bottom, const std::vector<size_t> &bottom_islands,
+                                          MyLayer &layer_top, const std::vector<size_t> &top_islands, Placement &placement)
+{
+    assert(layer_bottom != nullptr || bottom_islands.empty());
+    std::vector<float> support_force_bottom;
+    support_force_bottom.reserve(bottom_islands.size());
+    for (size_t island_id : bottom_islands)
+        support_force_bottom.emplace_back(layer_bottom->islands[island_id].supports_force_total());
+    auto support_force_of = [layer_bottom, &bottom_islands, &support_force_bottom](const Structure &bottom) -> float& {
+        auto it = std::lower_bound(bottom_islands.begin(), bottom_islands.end(), size_t(&bottom - layer_bottom->islands.data()));
+        assert(it != bottom_islands.end() && *it == size_t(&bottom - layer_bottom->islands.data()));
+        return support_force_bottom[it - bottom_islands.begin()];
+    };
+
+    for (size_t island_id : top_islands) {
+        const Structure &top = layer_top.islands[island_id];
+        for (const Structure::Link &bottom_link : top.islands_below) {
+            const Structure &bottom = *bottom_link.island;
+            //float centroids_dist = (bottom.centroid - top.centroid).norm();
+            // Penalization resulting from centroid offset:
 //                  bottom.supports_force *= std::min(1.f, 1.f - std::min(1.f, (1600.f * layer_height) * centroids_dist * centroids_dist / bottom.area));
-                float &support_force = support_force_bottom[&bottom - layer_bottom->islands.data()];
+            float &support_force = support_force_of(bottom);
 //FIXME this condition does not reflect a bifurcation into a one large island and one tiny island well, it incorrectly resets the support force to zero.
 // One should rather work with the overlap area vs overhang area.
 //                support_force *= std::min(1.f, 1.f - std::min(1.f, 0.1f * centroids_dist * centroids_dist / bottom.area));
-                // Penalization resulting from increasing polygon area:
-                support_force *= std::min(1.f, 20.f * bottom.area / top.area);
+            // Penalization resulting from increasing polygon area:
+            support_force *= std::min(1.f, 20.f * bottom.area / top.area);
+        }
+    }
+    // Let's assign proper support force to each of them:
+    for (size_t i = 0; i < bottom_islands.size(); ++ i) {
+        const Structure &below               = layer_bottom->islands[bottom_islands[i]];
+        float            below_support_force = support_force_bottom[i];
+        float            above_overlap_area  = 0.f;
+        for (const Structure::Link &above_link : below.islands_above)
+            above_overlap_area += above_link.overlap_area;
+        for (const Structure::Link &above_link : below.islands_above)
+            above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
+    }
+    // Now iterate over all polygons and append new points if needed.
+    for (size_t island_id : top_islands) {
+        Structure &s = layer_top.islands[island_id];
+        // Penalization resulting from large diff from the last layer:
+        s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+
+        add_support_points(s, placement);
+    }
+}
+
+// Split the islands into stacks, which do not influence each other, and process the stacks concurrently.
+// Islands linked across layers share the support force, thus they belong to the same stack. Islands closer
+// than the largest spacing of the support points may reject each other's points, so their stacks are merged.
+void SupportPointGenerator::process_island_stacks(std::vector<MyLayer> &layers)
+{
+    // Index the islands of all layers by a single number.
+    std::vector<size_t> layer_offsets(layers.size() + 1, 0);
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id)
+        layer_offsets[layer_id + 1] = layer_offsets[layer_id] + layers[layer_id].islands.size();
+    const size_t num_islands = layer_offsets.back();
+    auto island_idx = [&layer_offsets](const Structure &s) {
+        return layer_offsets[s.layer->layer_id] + size_t(&s - s.layer->islands.data());
+    };
+
+    // Union-find of the islands.
+    std::vector<size_t> parent(num_islands);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    auto unite = [&parent, &find](size_t i, size_t j) {
+        i = find(i);
+        j = find(j);
+        // Keep the lower index as the root, so that the roots do not depend on the order of merging.
+        if (i != j)
+            parent[std::max(i, j)] = std::min(i, j);
+    };
+    for (const MyLayer &layer : layers)
+        for (const Structure &s : layer.islands)
+            for (const Structure::Link &below : s.islands_below)
+                unite(island_idx(s), island_idx(*below.island));
+
+    {
+        // Merge the stacks with the bounding boxes closer than the largest collision distance of uniformly_cover().
+        const coord_t spacing = scaled(std::max(m_config.minimal_distance, m_config.support_force() / (5.f * m_config.tear_pressure())));
+        std::vector<BoundingBox> bboxes(num_islands);
+        for (const MyLayer &layer : layers)
+            for (const Structure &s : layer.islands)
+                bboxes[find(island_idx(s))].merge(s.bbox);
+        std::vector<size_t> roots;
+        for (size_t i = 0; i < num_islands; ++ i)
+            if (parent[i] == i) {
+                bboxes[i].offset(spacing);
+                roots.emplace_back(i);
             }
-        // Let's assign proper support force to each of them:
-        if (layer_id > 0) {
-            for (Structure &below : layer_bottom->islands) {
-                float below_support_force = support_force_bottom[&below - layer_bottom->islands.data()];
-                float above_overlap_area = 0.f;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_overlap_area += above_link.overlap_area;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
+        std::sort(roots.begin(), roots.end(), [&bboxes](size_t l, size_t r) { return bboxes[l].min.x() < bboxes[r].min.x(); });
+        for (size_t i = 0; i < roots.size(); ++ i)
+            for (size_t j = i + 1; j < roots.size() && bboxes[roots[j]].min.x() <= bboxes[roots[i]].max.x(); ++ j)
+                if (bboxes[roots[i]].overlap(bboxes[roots[j]]))
+                    unite(roots[i], roots[j]);
+    }
+
+    // Islands of each stack ordered by layers, the stacks are ordered by their lowest island.
+    std::vector<std::vector<size_t>> stacks;
+    {
+        std::vector<size_t> stack_of_root(num_islands, std::numeric_limits<size_t>::max());
+        for (size_t i = 0; i < num_islands; ++ i) {
+            size_t &stack_id = stack_of_root[find(i)];
+            if (stack_id == std::numeric_limits<size_t>::max()) {
+                stack_id = stacks.size();
+                stacks.emplace_back();
             }
+            stacks[stack_id].emplace_back(i);
         }
-        // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
-            // Penalization resulting from large diff from the last layer:
-            s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+    }
 
-            add_support_points(s, point_grid);
-        }
+    std::vector<std::vector<SupportPoint>> stack_points(stacks.size());
+    execution::SpinningMutex<ExecutionTBB> status_mutex;
+    size_t                                 num_processed = 0;
+    int                                    status        = 0;
+    execution::for_each(ex_tbb, size_t(0), stacks.size(),
+        [this, &layers, &layer_offsets, &stacks, &stack_points, &status_mutex, &num_processed, &status, num_islands](size_t stack_id)
+    {
+        std::seed_seq seq{ m_seed, std::mt19937::result_type(stack_id) };
+        std::mt19937  rng(seq);
+        PointGrid3D   point_grid;
+        point_grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+        Placement placement{ rng, point_grid, stack_points[stack_id] };
+
+        const std::vector<size_t> &stack = stacks[stack_id];
+        std::vector<size_t> bottom_islands;
+        std::vector<size_t> top_islands;
+        size_t              bottom_layer_id = std::numeric_limits<size_t>::max();
+        for (auto it = stack.begin(); it != stack.end();) {
+            const size_t layer_id = std::upper_bound(layer_offsets.begin(), layer_offsets.end(), *it) - layer_offsets.begin() - 1;
+            top_islands.clear();
+            for (; it != stack.end() && *it < layer_offsets[layer_id + 1]; ++ it)
+                top_islands.emplace_back(*it - layer_offsets[layer_id]);
+            if (bottom_layer_id + 1 != layer_id)
+                // Stacks merged by proximity may skip layers.
+                bottom_islands.clear();
+            process_layer(bottom_islands.empty() ? nullptr : &layers[layer_id - 1], bottom_islands, layers[layer_id], top_islands, placement);
+            bottom_islands.swap(top_islands);
+            bottom_layer_id = layer_id;
 
-        m_throw_on_cancel();
+            m_throw_on_cancel();
 
-        status += increment;
-        m_statusfn(int(std::round(status)));
-    }
+            std::lock_guard<execution::SpinningMutex<ExecutionTBB>> lock(status_mutex);
+            num_processed += bottom_islands.size();
+            if (int st = int(std::round(100. * num_processed / num_islands)); st > status)
+                m_statusfn(status = st);
+        }
+    }, 1 /* gransize */);
+
+    for (std::vector<SupportPoint> &points : stack_points)
+        append(m_output, std::move(points));
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, Placement &placement)
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -303,12 +441,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, placement, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, placement);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -319,13 +457,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, placement, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, placement, icfWithBoundary);
     }
 }
 
@@ -540,7 +678,7 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, Placement &placement, IslandCoverageFlags flags)
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -578,14 +716,14 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     std::vector<Vec2f> raw_samples =
         flags & icfWithBoundary ?
             sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+                                           5.f / poisson_radius, placement.rng) :
+            sample_expolygon(islands, samples_per_mm2, placement.rng);
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
         poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius,
-            [&structure, &grid3d, min_spacing](const Vec2f &pos) {
-                return grid3d.collides_with(pos, structure.layer->print_z, min_spacing);
+            [&structure, &placement, min_spacing](const Vec2f &pos) {
+                return placement.grid.collides_with(pos, structure.layer->print_z, min_spacing);
             });
         if (poisson_samples.size() >= poisson_samples_target || m_config.minimal_distance > poisson_radius-EPSILON)
             break;
@@ -611,13 +749,13 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), placement.rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
-        m_output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
+        placement.output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
         structure.supports_force_this_layer += m_config.support_force();
-        grid3d.insert(pt, &structure);
+        placement.grid.insert(pt, &structure);
     }
 }
 
@@ -39,6 +39,10 @@ public:
         float density_relative {1.f};
         float minimal_distance {1.f};
         float head_diameter {0.4f};
+        // Process the stacks of islands, which do not influence each other, concurrently.
+        // Each stack samples with its own random generator derived from seed(),
+        // thus the result does not depend on the number of threads.
+        bool  parallel_island_stacks {false};
 
         // Originally calibrated to 7.7f, reduced density by Tamas to 70% which is 11.1 (7.7 / 0.7) to adjust for new algorithm changes in tm_suppt_gen_improve
         inline float support_force() const { return 11.1f / density_relative; } // a force one point can support       (arbitrary force unit)
@@ -209,7 +213,7 @@ public:
     void execute(const std::vector<ExPolygons> &slices,
                  const std::vector<float> &     heights);
     
-    void seed(std::mt19937::result_type s) { m_rng.seed(s); }
+    void seed(std::mt19937::result_type s) { m_seed = s; m_rng.seed(s); }
 private:
     std::vector<SupportPoint> m_output;
     
@@ -217,14 +221,26 @@ private:
     
     void process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights);
 
+    // Where the support points are sampled from, checked for collisions and stored.
+    struct Placement {
+        std::mt19937              &rng;
+        PointGrid3D               &grid;
+        std::vector<SupportPoint> &output;
+    };
+
+    void process_layer(const MyLayer *layer_bottom, const std::vector<size_t> &bottom_islands,
+                       MyLayer &layer_top, const std::vector<size_t> &top_islands, Placement &placement);
+
+    void process_island_stacks(std::vector<MyLayer> &layers);
+
 public:
     enum IslandCoverageFlags : uint8_t { icfNone = 0x0, icfIsNew = 0x1, icfWithBoundary = 0x2 };
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, Placement &placement, IslandCoverageFlags flags = icfNone);
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    void add_support_points(Structure& structure, Placement &placement);
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
@@ -237,7 +253,8 @@ private:
     std::function<void(void)> m_throw_on_cancel;
     std::function<void(int)>  m_statusfn;
     
-    std::mt19937 m_rng;
+    std::mt19937              m_rng;
+    std::mt19937::result_type m_seed = std::mt19937::default_seed;
 };
 
 void remove_bottom_points(std::vector<SupportPoint> &pts, float lvl);
@@ -14,6 +14,7 @@
 
 #include "Geometry.hpp"
 #include "Thread.hpp"
+#include "Utils.hpp"
 
 #include <unordered_set>
 #include <numeric>
@@ -706,7 +707,14 @@ std::string SLAPrint::validate(std::vector<std::string>*) const
 
 void SLAPrint::export_print(const std::string &fname, const ThumbnailsList &thumbnails, const std::string &projectname)
 {
-    if (m_archiver)
+    if (! m_streamed_fname.empty()) {
+        // The layers were not kept in memory, the archive is already written.
+        if (fname != m_streamed_fname) {
+            std::string error_message;
+            if (copy_file(m_streamed_fname, fname, error_message) != SUCCESS)
+                throw ExportError(error_message);
+        }
+    } else if (m_archiver)
         m_archiver->export_print(fname, *this, thumbnails, projectname);
     else {
         throw ExportError(format(_u8L("Unknown archive format: %s"), m_printer_config.sla_archive_format.value));
@@ -723,6 +731,15 @@ bool SLAPrint::is_prusa_print(const std::string& printer_model)
     return false;
 }
 
+void SLAPrint::set_streaming_export(const std::string &fname, const ThumbnailsList &thumbnails, const std::string &projectname)
+{
+    std::scoped_lock<std::mutex> lock(this->state_mutex());
+    if (fname != m_streaming_export.fname)
+        // The layers have to be rasterized again to be written into the new target.
+        this->invalidate_step(slapsRasterize);
+    m_streaming_export = { fname, thumbnails, projectname };
+}
+
 bool SLAPrint::invalidate_step(SLAPrintStep step)
 {
     bool invalidated = Inherited::invalidate_step(step);
@@ -886,6 +903,7 @@ bool SLAPrint::invalidate_state_by_config_options(const std::vector<t_config_opt
         "display_orientation"sv,
         "sla_archive_format"sv,
         "sla_output_precision"sv,
+        "sla_rasterizer"sv,
         // tilt params
         "delay_before_exposure"sv,
         "delay_after_exposure"sv,
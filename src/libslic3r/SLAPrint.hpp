@@ -420,6 +420,10 @@ private:
     };
     
     std::unique_ptr<HollowingData> m_hollowing_data;
+
+    // Signed distance field of the assembled mesh, kept while only the hollowing
+    // thickness or the closing distance changes.
+    sla::HollowingGrid             m_hollowing_grid;
 };
 
 using PrintObjects = std::vector<SLAPrintObject*>;
@@ -583,6 +587,14 @@ public:
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname = "");
 
+    // Write the archive into fname while rasterizing instead of keeping all
+    // the encoded layers in memory until export_print(). The archive is
+    // complete once process() finishes, export_print() into the same file is
+    // then a no-op. An empty fname switches back to the buffered export.
+    void set_streaming_export(const std::string    &fname,
+                              const ThumbnailsList &thumbnails  = {},
+                              const std::string    &projectname = "");
+
     static bool is_prusa_print(const std::string& printer_model);
     
 private:
@@ -605,6 +617,16 @@ private:
     
     // The archive object which collects the raster images after slicing
     std::unique_ptr<SLAArchiveWriter>     m_archiver;
+
+    // Target of the archive streamed by slapsRasterize, see set_streaming_export().
+    struct StreamingExport {
+        std::string    fname;
+        ThumbnailsList thumbnails;
+        std::string    projectname;
+    } m_streaming_export;
+
+    // The archive written by the last slapsRasterize, empty if it was not streamed.
+    std::string                           m_streamed_fname;
     
     // Estimated print time, material consumed.
     SLAPrintStatistics              m_print_statistics;
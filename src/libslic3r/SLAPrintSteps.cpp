@@ -36,6 +36,7 @@
 //#include <libslic3r/ShortEdgeCollapse.hpp>
 
 #include <boost/log/trivial.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "I18N.hpp"
 #include "format.hpp"
@@ -343,6 +344,7 @@ void SLAPrint::Steps::mesh_assembly(SLAPrintObject &po)
     po.m_mesh_to_slice.clear();
     po.m_supportdata.reset();
     po.m_hollowing_data.reset();
+    po.m_hollowing_grid = {};
 
     csg::model_to_csgmesh(*po.model_object(), po.trafo(),
                           csg_inserter{po.m_mesh_to_slice, slaposAssembly},
@@ -360,6 +362,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
 
     if (! po.m_config.hollowing_enable.getBool()) {
         BOOST_LOG_TRIVIAL(info) << "Skipping hollowing step!";
+        po.m_hollowing_grid = {};
         return;
     }
 
@@ -373,8 +376,14 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
 
-    sla::InteriorPtr interior =
-        generate_interior(po.mesh_to_slice(), hlwcfg, ctl);
+    // The voxelization of the mesh is the most expensive part, reuse it unless
+    // the voxel scale changed. The mesh itself did not change, otherwise
+    // the field would be dropped by mesh_assembly().
+    sla::update_hollowing_grid(po.m_hollowing_grid, po.mesh_to_slice(), hlwcfg, ctl);
+
+    sla::InteriorPtr interior;
+    if (po.m_hollowing_grid.grid)
+        interior = generate_interior(po.m_hollowing_grid, hlwcfg, ctl);
 
     if (!interior || sla::get_mesh(*interior).empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
@@ -642,6 +651,8 @@ void SLAPrint::Steps::support_points(SLAPrintObject &po)
         // the density config value is in percents:
         config.density_relative = float(cfg.support_points_density_relative / 100.f);
         config.minimal_distance = float(cfg.support_points_minimal_distance);
+        // Plates of many small parts spend most of the time here, process them concurrently.
+        config.parallel_island_stacks = true;
         switch (cfg.support_tree_type) {
         case sla::SupportTreeType::Default:
         case sla::SupportTreeType::Organic:
@@ -1364,9 +1375,36 @@ void SLAPrint::Steps::rasterize()
     // last minute escape
     if(canceled()) return;
 
+    m_print->m_streamed_fname.clear();
+    const SLAPrint::StreamingExport &streaming = m_print->m_streaming_export;
+    bool stream = ! streaming.fname.empty() &&
+                  m_print->m_archiver->start_streaming(streaming.fname, *m_print, streaming.thumbnails,
+                                                       streaming.projectname, m_print->m_printer_input.size());
+    // Remove the incomplete archive if the rasterization did not finish.
+    auto abort_streaming = [this, &streaming]() {
+        m_print->m_archiver->abort_streaming();
+        boost::system::error_code ec;
+        boost::filesystem::remove(streaming.fname, ec);
+    };
+
     // Print all the layers in parallel
-    m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
-                                    [this]() { return canceled(); }, ex_tbb);
+    try {
+        m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
+                                        [this]() { return canceled(); }, ex_tbb);
+    } catch (...) {
+        if (stream)
+            abort_streaming();
+        throw;
+    }
+
+    if (stream) {
+        if (canceled()) {
+            abort_streaming();
+        } else {
+            m_print->m_archiver->finish_streaming();
+            m_print->m_streamed_fname = streaming.fname;
+        }
+    }
 }
 
 std::string SLAPrint::Steps::label(SLAPrintObjectStep step)
@@ -13,6 +13,7 @@
 #include <iterator>
 #include <limits>
 #include <algorithm>
+#include <array>
 
 #include "ShortestPath.hpp"
 #include "KDTreeIndirect.hpp"
@@ -1590,11 +1591,45 @@ static inline void do_crossover(const std::vector<FlipEdge> &edges_in, std::vect
 }
 #endif
 
+// Chains with up to this number of edges search all the connections for the second crossover.
+static constexpr size_t two_exchanges_exhaustive_max_edges = 256;
+// For longer chains, the second crossover is only searched for at the connections adjacent to the end points,
+// which are closest to the end points of the first crossover connection.
+static constexpr size_t two_exchanges_num_neighbors        = 8;
+// Upper bound of the number of crossover costs evaluated. Limiting the number of evaluations instead of the run time
+// keeps the resulting order deterministic.
+static constexpr size_t two_exchanges_max_evaluations      = 20000000;
+
+// For each end point of each edge, find the end points of the other edges closest to it.
+// End point of an edge is indexed as (2 * source_index) for FlipEdge::p1 of the edge as passed in, (2 * source_index + 1) for FlipEdge::p2.
+static std::vector<std::array<size_t, two_exchanges_num_neighbors>> two_exchanges_neighbors(const std::vector<FlipEdge> &edges, const size_t num_sources)
+{
+	std::vector<Vec2d> end_points(2 * num_sources, Vec2d::Zero());
+	std::vector<char>  valid(num_sources, false);
+	for (const FlipEdge &edge : edges) {
+		end_points[2 * edge.source_index]     = edge.p1;
+		end_points[2 * edge.source_index + 1] = edge.p2;
+		valid[edge.source_index] = true;
+	}
+	auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx][dimension]; };
+	KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+	std::vector<std::array<size_t, two_exchanges_num_neighbors>> out(end_points.size());
+	for (size_t idx = 0; idx < end_points.size(); ++ idx) {
+		out[idx].fill(KDTreeIndirect<2, double, decltype(coordinate_fn)>::npos);
+		if (valid[idx / 2])
+			out[idx] = find_closest_points<two_exchanges_num_neighbors>(kdtree, end_points[idx],
+				[idx, &valid](size_t other) { return (other ^ idx) > 1 && valid[other / 2]; });
+	}
+	return out;
+}
+
 // Worst time complexity:    O(min(n, 100) * (n * log n + n^2)
 // Expected time complexity: O(min(n, 100) * (n * log n + k * n)
 // where n is the number of edges and k is the number of connection_lengths candidates after the first one
 // is found that improves the total cost.
-//FIXME there are likley better heuristics to lower the time complexity.
+// For n > two_exchanges_exhaustive_max_edges the second crossover is only searched for next to the end points closest
+// to the first crossover, lowering the worst time complexity to O(min(n, 100) * n * log n), and the total number
+// of crossover cost evaluations is bounded by two_exchanges_max_evaluations.
 static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges)
 {
 	if (edges.size() < 2)
@@ -1605,7 +1640,32 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 	std::vector<std::pair<double, size_t>>	connection_lengths(edges.size() - 1, std::pair<double, size_t>(0., 0));
 	std::vector<char>						connection_tried(edges.size(), false);
 	const size_t 							max_iterations = std::min(edges.size(), size_t(100));
-	for (size_t iter = 0; iter < max_iterations; ++ iter) {
+	size_t                                  num_evaluations = 0;
+
+	// Neighbor lists of the end points indexed by end point index, see two_exchanges_neighbors().
+	const bool                              use_neighbors = edges.size() > two_exchanges_exhaustive_max_edges;
+	std::vector<std::array<size_t, two_exchanges_num_neighbors>> neighbors;
+	// Initial end points of the edges indexed by source_index, current position of an edge in edges indexed by source_index.
+	std::vector<Vec2d>                      source_p1;
+	std::vector<size_t>                     source_position;
+	std::vector<size_t>                     candidates;
+	if (use_neighbors) {
+		size_t num_sources = 0;
+		for (const FlipEdge &edge : edges)
+			num_sources = std::max(num_sources, edge.source_index + 1);
+		neighbors = two_exchanges_neighbors(edges, num_sources);
+		source_p1.assign(num_sources, Vec2d::Zero());
+		source_position.assign(num_sources, 0);
+		for (const FlipEdge &edge : edges)
+			source_p1[edge.source_index] = edge.p1;
+	}
+	// End point index of an end point of an edge, which may have been flipped since the neighbor lists were calculated.
+	auto end_point_index = [&source_p1](const FlipEdge &edge, bool second) {
+		const Vec2d &pt = second ? edge.p2 : edge.p1;
+		return 2 * edge.source_index + (pt == source_p1[edge.source_index] ? 0 : 1);
+	};
+
+	for (size_t iter = 0; iter < max_iterations && num_evaluations < two_exchanges_max_evaluations; ++ iter) {
 		// Initialize connection costs and connection lengths.
 		for (size_t i = 1; i < edges.size(); ++ i) {
 			const FlipEdge   	 &e1 = edges[i - 1];
@@ -1617,6 +1677,9 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 			c.cost_flipped += (e2.p2 - e1.p1).norm();
 			connection_lengths[i - 1] = std::make_pair(l, i);
 		}
+		if (use_neighbors)
+			for (size_t i = 0; i < edges.size(); ++ i)
+				source_position[edges[i].source_index] = i;
 		std::sort(connection_lengths.begin(), connection_lengths.end(), [](const std::pair<double, size_t> &l, const std::pair<double, size_t> &r) { return l.first > r.first; });
 		std::fill(connection_tried.begin(), connection_tried.end(), false);
 		size_t crossover1_pos_final = std::numeric_limits<size_t>::max();
@@ -1629,28 +1692,50 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 			size_t crossover_pos_min  = std::numeric_limits<size_t>::max();
 			double crossover_cost_min = connections.back().cost;
 			size_t crossover_flip_min = 0;
-			for (size_t j = 1; j < connections.size(); ++ j)
-				if (! connection_tried[j]) {
-					size_t a = j;
-					size_t b = longest_connection_idx;
-					if (a > b)
-						std::swap(a, b);
-					std::pair<double, size_t> cost_and_flip = minimum_crossover_cost(edges, 
-						std::make_pair(size_t(0), a), connections[a - 1], std::make_pair(a, b), connections[b - 1] - connections[a], std::make_pair(b, edges.size()), connections.back() - connections[b],
-						connections.back().cost);
-					if (cost_and_flip.second > 0 && cost_and_flip.first < crossover_cost_min) {
-						crossover_pos_min  = j;
-						crossover_cost_min = cost_and_flip.first;
-						crossover_flip_min = cost_and_flip.second;
-						assert(crossover_cost_min < connections.back().cost + EPSILON);
-					}
+			auto   try_second_crossover = [&](size_t j) {
+				size_t a = j;
+				size_t b = longest_connection_idx;
+				if (a > b)
+					std::swap(a, b);
+				std::pair<double, size_t> cost_and_flip = minimum_crossover_cost(edges, 
+					std::make_pair(size_t(0), a), connections[a - 1], std::make_pair(a, b), connections[b - 1] - connections[a], std::make_pair(b, edges.size()), connections.back() - connections[b],
+					connections.back().cost);
+				++ num_evaluations;
+				if (cost_and_flip.second > 0 && cost_and_flip.first < crossover_cost_min) {
+					crossover_pos_min  = j;
+					crossover_cost_min = cost_and_flip.first;
+					crossover_flip_min = cost_and_flip.second;
+					assert(crossover_cost_min < connections.back().cost + EPSILON);
 				}
+			};
+			if (use_neighbors) {
+				// Connections adjacent to the end points closest to the two end points of the first crossover connection.
+				candidates.clear();
+				for (size_t end_point : { end_point_index(edges[longest_connection_idx - 1], true), end_point_index(edges[longest_connection_idx], false) })
+					for (size_t neighbor : neighbors[end_point])
+						if (neighbor < 2 * source_position.size()) {
+							size_t pos = source_position[neighbor / 2];
+							for (size_t j : { pos, pos + 1 })
+								if (j > 0 && j < connections.size() && ! connection_tried[j])
+									candidates.emplace_back(j);
+						}
+				sort_remove_duplicates(candidates);
+				for (size_t j : candidates)
+					try_second_crossover(j);
+			} else {
+				for (size_t j = 1; j < connections.size(); ++ j)
+					if (! connection_tried[j])
+						try_second_crossover(j);
+			}
 			if (crossover_cost_min < connections.back().cost) {
 				// The cost of the chain with the proposed two crossovers has a lower total cost than the current chain. Apply the crossover.
 				crossover1_pos_final = longest_connection_idx;
 				crossover2_pos_final = crossover_pos_min;
 				crossover_flip_final = crossover_flip_min;
 				break;
+			} else if (num_evaluations >= two_exchanges_max_evaluations) {
+				// Out of budget.
+				break;
 			} else {
 				// Continue with another long candidate edge.
 			}
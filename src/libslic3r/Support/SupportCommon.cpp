@@ -1256,12 +1256,18 @@ static void modulate_extrusion_by_overlapping_layers(
     // This will be the destination for the new paths.
     extrusions_in_out.clear();
 
+    // The trimming polygons of the overlapping layers are independent of each other, calculate them in a batch.
+    std::vector<Polygons> overlapping_layers_trimming(n_overlapping_layers);
+    ClipperUtils::batch(n_overlapping_layers, [&overlapping_layers, &overlapping_layers_trimming, extrusion_width](size_t i) {
+        overlapping_layers_trimming[i] = offset(union_ex(overlapping_layers[i]->polygons), float(scale_(0.5*extrusion_width)));
+    });
+
     // Fragment the path segments by overlapping layers. The overlapping layers are sorted by an increasing print_z.
     // Trim by the highest overlapping layer first.
     for (int i_overlapping_layer = int(n_overlapping_layers) - 1; i_overlapping_layer >= 0; -- i_overlapping_layer) {
         const SupportGeneratorLayer &overlapping_layer = *overlapping_layers[i_overlapping_layer];
         ExtrusionPathFragment &frag = path_fragments[i_overlapping_layer];
-        Polygons polygons_trimming = offset(union_ex(overlapping_layer.polygons), float(scale_(0.5*extrusion_width)));
+        const Polygons &polygons_trimming = overlapping_layers_trimming[i_overlapping_layer];
         frag.polylines = intersection_pl(path_fragments.back().polylines, polygons_trimming);
         path_fragments.back().polylines = diff_pl(path_fragments.back().polylines, polygons_trimming);
         // Adjust the extrusion parameters for a reduced layer height and a non-bridging flow (nozzle_dmr = -1, does not matter).
@@ -18,8 +18,10 @@
 #include <oneapi/tbb/task_arena.h>
 #include <oneapi/tbb/task_group.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <limits>
+#include <map>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -221,37 +223,53 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
 
     // Append additional radiis needed for collision.
     // To calculate collision holefree for every radius, the collision of radius m_increase_until_radius will be required.
-    radius_until_layer[ceilRadius(m_increase_until_radius + m_current_min_xy_dist_delta)] = max_layer;
     // Collision for radius 0 needs to be calculated everywhere, as it will be used to ensure valid xy_distance in drawAreas.
-    radius_until_layer[0] = max_layer;
+    std::map<coord_t, LayerIndex> collision_radius_until_layer{ { ceilRadius(m_increase_until_radius + m_current_min_xy_dist_delta), max_layer }, { 0, max_layer } };
     if (m_current_min_xy_dist_delta != 0)
-        radius_until_layer[m_current_min_xy_dist_delta] = max_layer;
-
-    // Now that required_avoidance_limit contains the maximum of ild and regular required radius just copy.
-    std::vector<RadiusLayerPair> relevant_collision_radiis{ radius_until_layer.begin(), radius_until_layer.end() };
-
-    // Calculate the relevant collisions
-    calculateCollision(relevant_collision_radiis, throw_on_cancel);
-
-    // calculate a separate Collisions with all holes removed. These are relevant for some avoidances that try to avoid holes (called safe)
-    std::vector<RadiusLayerPair> relevant_hole_collision_radiis;
-    for (RadiusLayerPair key : relevant_avoidance_radiis)
-        if (key.first < m_increase_until_radius + m_current_min_xy_dist_delta)
-            relevant_hole_collision_radiis.emplace_back(key);
-
-    // Calculate collisions without holes, built from regular collision
-    calculateCollisionHolefree(relevant_hole_collision_radiis, throw_on_cancel);
-    // Let placables be calculated from calculateAvoidance() for better parallelization.
-    if (m_support_rests_on_model)
-        calculatePlaceables(relevant_avoidance_radiis, throw_on_cancel);
+        collision_radius_until_layer.emplace(m_current_min_xy_dist_delta, max_layer);
+    // Avoidances, placeable areas and wall restrictions of a radius query the collisions of ceilRadius(radius + m_current_min_xy_dist_delta),
+    // which is a different radius if the delta is not zero. All the collisions are calculated first, so that no collision is calculated
+    // on demand by the tasks of another radius.
+    for (const RadiusLayerPair &key : relevant_avoidance_radiis)
+        for (coord_t radius : { key.first, ceilRadius(key.first, true) }) {
+            LayerIndex &max_layer_idx = collision_radius_until_layer.emplace(radius, key.second).first->second;
+            max_layer_idx = std::max(max_layer_idx, key.second);
+        }
+    calculateCollision(std::vector<RadiusLayerPair>{ collision_radius_until_layer.begin(), collision_radius_until_layer.end() }, throw_on_cancel);
 
     auto t_coll = std::chrono::high_resolution_clock::now();
 
-    // Calculate the relevant avoidances in parallel as far as possible
+    // Wall clock time spent calculating the individual caches, summed over all radii.
+    // As the radii are processed concurrently, the sum may exceed the wall clock time of the whole precalculation.
+    std::atomic<int64_t> dur_collision_holefree_us { 0 }, dur_placeable_us { 0 }, dur_avoidance_us { 0 }, dur_wall_restrictions_us { 0 };
+    auto measure = [](std::atomic<int64_t> &duration_us, auto &&fn) {
+        auto t_start = std::chrono::high_resolution_clock::now();
+        fn();
+        duration_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t_start).count();
+    };
+
+    // The caches of each radius are calculated as one task:
+    // collision without holes -> placeable areas -> avoidances and wall restrictions,
+    // without waiting for the other radii to finish.
+    // Avoidance of a layer depends on the avoidance of the layer below, thus the avoidance of a single radius is serial,
+    // while the radii are independent of each other. The radii with the longest chains of layers are started first.
+    std::sort(relevant_avoidance_radiis.begin(), relevant_avoidance_radiis.end(), [](const RadiusLayerPair &l, const RadiusLayerPair &r) { return l.second > r.second; });
     {
         tbb::task_group task_group;
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateAvoidance(relevant_avoidance_radiis, true, m_support_rests_on_model, throw_on_cancel); });
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateWallRestrictions(relevant_avoidance_radiis, throw_on_cancel); });
+        for (const RadiusLayerPair &key : relevant_avoidance_radiis)
+            task_group.run([this, key, &measure, &dur_collision_holefree_us, &dur_placeable_us, &dur_avoidance_us, &dur_wall_restrictions_us, throw_on_cancel]{
+                // calculate a separate Collisions with all holes removed. These are relevant for some avoidances that try to avoid holes (called safe)
+                if (key.first < m_increase_until_radius + m_current_min_xy_dist_delta)
+                    measure(dur_collision_holefree_us, [this, key, &throw_on_cancel]{ calculateCollisionHolefree({ key }, throw_on_cancel); });
+                if (m_support_rests_on_model)
+                    measure(dur_placeable_us, [this, key, &throw_on_cancel]{ calculatePlaceables(key.first, key.second, throw_on_cancel); });
+                tbb::task_group radius_task_group;
+                radius_task_group.run([this, key, &measure, &dur_avoidance_us, &throw_on_cancel]{
+                    measure(dur_avoidance_us, [this, key, &throw_on_cancel]{ calculateAvoidance({ key }, true, m_support_rests_on_model, throw_on_cancel); }); });
+                radius_task_group.run([this, key, &measure, &dur_wall_restrictions_us, &throw_on_cancel]{
+                    measure(dur_wall_restrictions_us, [this, key, &throw_on_cancel]{ calculateWallRestrictions({ key }, throw_on_cancel); }); });
+                radius_task_group.wait();
+            });
         task_group.wait();
     }
     auto t_end = std::chrono::high_resolution_clock::now();
@@ -259,7 +277,9 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     auto dur_avo = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_coll).count();
 
 //    m_precalculated = true;
-    BOOST_LOG_TRIVIAL(info) << "Precalculating collision took" << dur_col << " ms. Precalculating avoidance took " << dur_avo << " ms.";
+    BOOST_LOG_TRIVIAL(info) << "Precalculating collisions of " << collision_radius_until_layer.size() << " radii took " << dur_col << " ms. Precalculating caches of " << relevant_avoidance_radiis.size() << " radii took " << dur_avo << " ms.";
+    BOOST_LOG_TRIVIAL(info) << "Precalculation summed over radii: m_collision_cache_holefree " << 0.001 * dur_collision_holefree_us <<
+        " ms, m_placeable_areas_cache " << 0.001 * dur_placeable_us << " ms, avoidance caches " << 0.001 * dur_avoidance_us << " ms, wall restrictions caches " << 0.001 * dur_wall_restrictions_us << " ms.";
 
 #if 0
     // Paint caches into SVGs:
@@ -658,6 +678,7 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
         for (size_t task_idx = range.begin(); task_idx < range.end(); ++ task_idx) {
             const AvoidanceTask &task = avoidance_tasks[task_idx];
             assert(! task.holefree() || task.radius < m_increase_until_radius + m_current_min_xy_dist_delta);
+            auto t_start = std::chrono::high_resolution_clock::now();
             if (task.to_model)
                 // ensuring Placeableareas are calculated
                 //FIXME pass throw_on_cancel
@@ -710,6 +731,9 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
             }
 #endif
             avoidance_cache(task.type, task.to_model).insert(std::move(data));
+            BOOST_LOG_TRIVIAL(debug) << "Avoidance " << (task.slow() ? "slow" : task.holefree() ? "holefree" : "fast") << (task.to_model ? " to model" : "") <<
+                " of radius " << task.radius << ", layers " << task.start_layer << " to " << task.max_required_layer << " took " <<
+                0.001 * std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - t_start).count() << " ms";
         }
     });
 }
@@ -862,10 +886,13 @@ coord_t TreeModelVolumes::ceilRadius(const coord_t radius) const
 
 void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layers)
 {
-    if (num_layers > m_data.size()) {
-        if (num_layers > m_data.capacity())
-            reserve_power_of_2(m_data, num_layers);
-        m_data.resize(num_layers, {});
+    if (num_layers > m_num_layers.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> guard(m_grow_mutex);
+        if (num_layers > m_num_layers.load(std::memory_order_relaxed)) {
+            m_data.grow_to_at_least(num_layers);
+            // Publish the new layers only after they were constructed.
+            m_num_layers.store(num_layers, std::memory_order_release);
+        }
     }
 }
 
@@ -873,11 +900,9 @@ void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layer
 std::vector<std::pair<TreeModelVolumes::RadiusLayerPair, std::reference_wrapper<const Polygons>>> TreeModelVolumes::RadiusLayerPolygonCache::sorted() const
 {
     std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> out;
-    for (auto &layer : m_data) {
-        auto layer_idx = LayerIndex(&layer - m_data.data());
-        for (auto &radius_polygons : layer)
-            out.emplace_back(std::make_pair(radius_polygons.first, layer_idx), radius_polygons.second);
-    }
+    for (size_t layer_idx = 0; layer_idx < m_num_layers; ++ layer_idx)
+        for (auto &radius_polygons : m_data[layer_idx].radii)
+            out.emplace_back(std::make_pair(radius_polygons.first, LayerIndex(layer_idx)), radius_polygons.second);
     assert(std::is_sorted(out.begin(), out.end(), [](auto &l, auto &r){ return l.first.second < r.first.second || (l.first.second == r.first.second) && l.first.first < r.first.first; }));
     return out;
 }
@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <functional>
@@ -28,6 +29,9 @@
 #include <cinttypes>
 #include <cstddef>
 
+#include <oneapi/tbb/concurrent_vector.h>
+#include <oneapi/tbb/spin_rw_mutex.h>
+
 #include "TreeSupportCommon.hpp"
 #include "../Point.hpp"
 #include "../Polygon.hpp"
@@ -209,43 +213,66 @@ private:
      * \brief Convenience typedef for the keys to the caches
      */
     using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
+    // Cache of polygons indexed by layer and radius, accessed concurrently by TBB worker threads.
+    // Each layer is guarded by its own reader / writer lock, thus lookups never block each other and lookups / inserts
+    // block each other only if they access the same layer. Layers are stored in a tbb::concurrent_vector, which
+    // does not move its items when growing, thus the layers are accessed while another thread grows the cache.
     class RadiusLayerPolygonCache {
         // Map from radius to Polygons. Cache of one layer collision regions.
-        using LayerData = std::map<coord_t, Polygons>;
+        struct LayerData {
+            LayerData() = default;
+            // Required by tbb::concurrent_vector, the mutex is not copied.
+            LayerData(const LayerData &rhs) : radii(rhs.radii) {}
+            LayerData(LayerData &&rhs) : radii(std::move(rhs.radii)) {}
+            LayerData& operator=(const LayerData &rhs) { radii = rhs.radii; return *this; }
+            LayerData& operator=(LayerData &&rhs) { radii = std::move(rhs.radii); return *this; }
+
+            std::map<coord_t, Polygons>     radii;
+            mutable tbb::spin_rw_mutex      mutex;
+        };
         // Vector of layers, at each layer map of radius to Polygons.
         // Reference to Polygons returned shall be stable to insertion.
-        using Layers = std::vector<LayerData>;
+        using Layers = tbb::concurrent_vector<LayerData>;
     public:
         RadiusLayerPolygonCache() = default;
-        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)) {}
-        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { m_data = std::move(rhs.m_data); return *this; }
+        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)), m_num_layers(rhs.m_num_layers.load()) { rhs.m_num_layers = 0; }
+        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) 
+            { m_data = std::move(rhs.m_data); m_num_layers = rhs.m_num_layers.load(); rhs.m_num_layers = 0; return *this; }
 
         RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
         RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
 
         void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            for (auto &d : in)
-                this->get_allocate_layer_data(d.first.second).emplace(d.first.first, std::move(d.second));
+            for (auto &d : in) {
+                LayerData &layer = this->get_allocate_layer_data(d.first.second);
+                tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, true);
+                layer.radii.emplace(d.first.first, std::move(d.second));
+            }
         }
         // by layer
         void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            for (auto &d : in)
-                this->get_allocate_layer_data(d.first).emplace(radius, std::move(d.second));
+            for (auto &d : in) {
+                LayerData &layer = this->get_allocate_layer_data(d.first);
+                tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, true);
+                layer.radii.emplace(radius, std::move(d.second));
+            }
         }
         void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             allocate_layers(first_layer_idx + in.size());
-            for (auto &d : in)
-                m_data[first_layer_idx ++].emplace(radius, std::move(d));
+            for (auto &d : in) {
+                LayerData &layer = m_data[first_layer_idx ++];
+                tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, true);
+                layer.radii.emplace(radius, std::move(d));
+            }
         }
         void insert(LayerPolygonCache &&in, coord_t radius) {
-            std::lock_guard<std::mutex> guard(m_mutex);
             LayerIndex i = in.begin();
             allocate_layers(i + LayerIndex(in.size()));
-            for (auto &d : in.polygons_mutable())
-                m_data[i ++].emplace(radius, std::move(d));
+            for (auto &d : in.polygons_mutable()) {
+                LayerData &layer = m_data[i ++];
+                tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, true);
+                layer.radii.emplace(radius, std::move(d));
+            }
         }
         /*!
          * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
@@ -253,29 +280,28 @@ private:
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
         std::optional<std::reference_wrapper<const Polygons>> getArea(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-
-            if (key.second >= LayerIndex(m_data.size()))
+            if (key.second >= LayerIndex(m_num_layers.load(std::memory_order_acquire)))
                 return std::nullopt;
 
             const LayerData &layer = m_data[key.second];
-            auto it = layer.find(key.first);
-            if (it == layer.end())
+            tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, false);
+            auto it = layer.radii.find(key.first);
+            if (it == layer.radii.end())
                 return std::nullopt;
 
             return std::optional<std::reference_wrapper<const Polygons>>{it->second};
         }
         // Get a collision area at a given layer for a radius that is a lower or equial to the key radius.
         std::optional<std::pair<coord_t, std::reference_wrapper<const Polygons>>> get_lower_bound_area(const TreeModelVolumes::RadiusLayerPair &key) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if (key.second >= LayerIndex(m_data.size()))
+            if (key.second >= LayerIndex(m_num_layers.load(std::memory_order_acquire)))
                 return {};
-            const auto &layer = m_data[key.second];
-            if (layer.empty())
+            const LayerData &layer = m_data[key.second];
+            tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, false);
+            if (layer.radii.empty())
                 return {};
-            auto it = layer.lower_bound(key.first);
-            if (it == layer.end() || it->first != key.first) {
-                if (it == layer.begin())
+            auto it = layer.radii.lower_bound(key.first);
+            if (it == layer.radii.end() || it->first != key.first) {
+                if (it == layer.radii.begin())
                     return {};
                 -- it;
             }
@@ -289,11 +315,13 @@ private:
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
         LayerIndex getMaxCalculatedLayer(coord_t radius) const {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            auto layer_idx = LayerIndex(m_data.size()) - 1;
-            for (; layer_idx > 0; -- layer_idx)
-                if (const auto &layer = m_data[layer_idx]; layer.find(radius) != layer.end())
+            auto layer_idx = LayerIndex(m_num_layers.load(std::memory_order_acquire)) - 1;
+            for (; layer_idx > 0; -- layer_idx) {
+                const LayerData &layer = m_data[layer_idx];
+                tbb::spin_rw_mutex::scoped_lock lock(layer.mutex, false);
+                if (layer.radii.find(radius) != layer.radii.end())
                     break;
+            }
             // The placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
             return layer_idx == 0 ? -1 : layer_idx;
         }
@@ -301,13 +329,15 @@ private:
         // For debugging purposes, sorted by layer index, then by radius.
         [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
 
-        void clear() { m_data.clear(); }
+        // Not thread safe.
+        void clear() { m_data.clear(); m_num_layers = 0; }
+        // Not thread safe.
         void clear_all_but_radius0() { 
             for (LayerData &l : m_data) {
-                auto begin = l.begin();
-                auto end = l.end();
+                auto begin = l.radii.begin();
+                auto end = l.radii.end();
                 if (begin != end && ++ begin != end)
-                    l.erase(begin, end);
+                    l.radii.erase(begin, end);
             }
         }
 
@@ -319,7 +349,11 @@ private:
         void                allocate_layers(size_t num_layers);
 
         Layers              m_data;
-        mutable std::mutex  m_mutex;
+        // Number of layers of m_data, which have been fully constructed. Layers below m_num_layers are accessed without
+        // taking m_grow_mutex, m_data.size() may include layers being constructed by another thread.
+        std::atomic<size_t> m_num_layers { 0 };
+        // Serializes growing of m_data.
+        std::mutex          m_grow_mutex;
     };
 
 
@@ -16,6 +16,8 @@
 #include <libqhullcpp/Qhull.h>
 #include <libqhullcpp/QhullFacetList.h>
 #include <libqhullcpp/QhullVertexSet.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
@@ -26,6 +28,8 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/parallel_sort.h>
 #include <cmath>
 #include <vector>
 #include <utility>
@@ -215,10 +219,82 @@ void TriangleMesh::from_facets(std::vector<stl_facet> &&facets, bool repair)
     fill_initial_stats(this->its, this->m_stats);
 }
 
+// Binary STL consists of fixed size facet records, therefore the file is memory mapped and the facets are converted
+// in parallel. Returns false if the file is not a binary STL file or if it could not be mapped, then the file shall be
+// read by admesh stl_open(), which also reports the errors.
+static bool stl_open_binary_parallel(stl_file &stl, const char *path)
+{
+#if BOOST_ENDIAN_BIG_BYTE
+    // stl_open() converts the little endian data.
+    return false;
+#else // BOOST_ENDIAN_BIG_BYTE
+    boost::iostreams::mapped_file_source mapped;
+    try {
+        boost::system::error_code ec;
+        const boost::filesystem::path file_path(path);
+        if (boost::filesystem::file_size(file_path, ec) < STL_MIN_FILE_SIZE || ec)
+            return false;
+        mapped.open(file_path);
+    } catch (const std::exception &) {
+        return false;
+    }
+    if (! mapped.is_open())
+        return false;
+
+    const char   *data = mapped.data();
+    const size_t  size = mapped.size();
+    // The same test for a binary file as in stl_open(): A binary STL contains a byte > 127 following the header.
+    if (std::none_of(data + HEADER_SIZE, data + HEADER_SIZE + 128, [](char c) { return (unsigned char)c > 127; }) ||
+        (size - HEADER_SIZE) % SIZEOF_STL_FACET != 0)
+        return false;
+
+    const auto num_facets = uint32_t((size - HEADER_SIZE) / SIZEOF_STL_FACET);
+    uint32_t   header_num_facets;
+    memcpy(&header_num_facets, data + LABEL_SIZE, sizeof(uint32_t));
+    if (num_facets != header_num_facets)
+        BOOST_LOG_TRIVIAL(info) << "stl_open_binary_parallel: Warning: File size doesn't match number of facets in the header: " << path;
+
+    stl.clear();
+    stl.stats.type                = binary;
+    memcpy(stl.stats.header, data, LABEL_SIZE);
+    stl.stats.number_of_facets    = num_facets;
+    stl.stats.original_num_facets = int(num_facets);
+    stl_allocate(&stl);
+
+    // Copy the facets and calculate their bounding box.
+    using Bounds = std::pair<stl_vertex, stl_vertex>;
+    const char *facets = data + HEADER_SIZE;
+    Bounds bounds = tbb::parallel_reduce(tbb::blocked_range<size_t>(0, num_facets, 16384),
+        Bounds{ stl_vertex::Constant(std::numeric_limits<float>::max()), stl_vertex::Constant(std::numeric_limits<float>::lowest()) },
+        [&stl, facets](const tbb::blocked_range<size_t> &range, Bounds bounds) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                stl_facet &facet = stl.facet_start[i];
+                memcpy(&facet, facets + i * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+                for (const stl_vertex &v : facet.vertex) {
+                    bounds.first  = bounds.first.cwiseMin(v);
+                    bounds.second = bounds.second.cwiseMax(v);
+                }
+            }
+            return bounds;
+        },
+        [](const Bounds &l, const Bounds &r) { return Bounds{ l.first.cwiseMin(r.first), l.second.cwiseMax(r.second) }; });
+
+    // Statistics as calculated by stl_facet_stats().
+    const stl_facet &first = stl.facet_start.front();
+    stl_vertex diff = (first.vertex[1] - first.vertex[0]).cwiseAbs();
+    stl.stats.shortest_edge     = std::max(diff(0), std::max(diff(1), diff(2)));
+    stl.stats.min               = bounds.first;
+    stl.stats.max               = bounds.second;
+    stl.stats.size              = stl.stats.max - stl.stats.min;
+    stl.stats.bounding_diameter = stl.stats.size.norm();
+    return true;
+#endif // BOOST_ENDIAN_BIG_BYTE
+}
+
 bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
 { 
     stl_file stl;
-    if (! stl_open(&stl, input_file))
+    if (! stl_open_binary_parallel(stl, input_file) && ! stl_open(&stl, input_file))
         return false;
     if (repair)
         trianglemesh_repair_on_import(stl);
@@ -725,7 +801,7 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
     auto sorted = reserve_vector<int>(its.vertices.size());
     for (int i = 0; i < int(its.vertices.size()); ++ i)
         sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
+    tbb::parallel_sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
         const Vec3f &l = its.vertices[il];
         const Vec3f &r = its.vertices[ir];
         // Sort lexicographically by coordinates AND vertex index.
@@ -770,9 +846,13 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
         // Shrink the vertices.
         its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
         // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 65536), [&its, &map_vertices](const tbb::blocked_range<size_t> &range) {
+            for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
+                stl_triangle_vertex_indices &face = its.indices[face_idx];
+                for (int i = 0; i < 3; ++ i)
+                    face(i) = map_vertices[face(i)];
+            }
+        });
         // Optionally shrink to fit (reallocate) vertices.
         if (shrink_to_fit)
             its.vertices.shrink_to_fit();
@@ -8,6 +8,7 @@
 #include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/scalable_allocator.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <mutex>
 #include <utility>
@@ -39,6 +40,13 @@
 
 #include <boost/thread/lock_guard.hpp>
 
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
 #if defined(__cpp_lib_hardware_interference_size) && ! defined(__APPLE__)
     using std::hardware_destructive_interference_size;
 #else
@@ -404,6 +412,233 @@ inline FacetSliceType slice_facet(
     return FacetSliceType::NoSlice;
 }
 
+#if defined(__x86_64__) || defined(_M_X64)
+    // The SIMD kernels use the same sequence of IEEE double operations as slice_facet() to produce bit identical results.
+    // They are enabled on x86-64 only, where the scalar code is compiled without fused multiply-add. Other platforms
+    // (aarch64) may contract the scalar expressions into fused multiply-adds, therefore they use the scalar path.
+    #define SLIC3R_SLICING_SIMD
+#endif
+
+static std::atomic<SlicingKernel> s_slicing_kernel { SlicingKernel::Auto };
+
+#ifdef SLIC3R_SLICING_SIMD
+static bool cpu_supports_avx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // OSXSAVE and AVX supported, YMM state enabled by the OS.
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else // _MSC_VER
+    return __builtin_cpu_supports("avx2");
+#endif // _MSC_VER
+}
+#endif // SLIC3R_SLICING_SIMD
+
+void set_slicing_kernel(SlicingKernel kernel)
+{
+    s_slicing_kernel.store(kernel, std::memory_order_relaxed);
+}
+
+SlicingKernel slicing_kernel()
+{
+#ifdef SLIC3R_SLICING_SIMD
+    static const bool has_avx2 = cpu_supports_avx2();
+    switch (SlicingKernel kernel = s_slicing_kernel.load(std::memory_order_relaxed)) {
+    case SlicingKernel::Auto:
+    case SlicingKernel::AVX2:
+        return has_avx2 ? SlicingKernel::AVX2 : SlicingKernel::SSE2;
+    default:
+        return kernel;
+    }
+#else // SLIC3R_SLICING_SIMD
+    return SlicingKernel::Scalar;
+#endif // SLIC3R_SLICING_SIMD
+}
+
+// Intersection of a triangle edge with a slicing plane as calculated by slice_facet() before clamping to the edge end points.
+inline void slice_edge_at_z(const stl_vertex &a, const stl_vertex &b, const float z, double &t, coord_t &x, coord_t &y)
+{
+    t = (double(z) - double(a.z())) / (double(b.z()) - double(a.z()));
+    x = coord_t(std::floor(double(a.x()) * (1. - t) + double(b.x()) * t + 0.5 + 0.5));
+    y = coord_t(std::floor(double(a.y()) * (1. - t) + double(b.y()) * t + 0.5 + 0.5));
+}
+
+#ifdef SLIC3R_SLICING_SIMD
+// Intersect a triangle edge with planes zs[0, n), 2 planes at once.
+static void slice_edge_at_zs_sse2(const stl_vertex &a, const stl_vertex &b, const float *zs, const size_t n, double *t, coord_t *x, coord_t *y)
+{
+    const __m128d ax   = _mm_set1_pd(double(a.x()));
+    const __m128d ay   = _mm_set1_pd(double(a.y()));
+    const __m128d az   = _mm_set1_pd(double(a.z()));
+    const __m128d bx   = _mm_set1_pd(double(b.x()));
+    const __m128d by   = _mm_set1_pd(double(b.y()));
+    const __m128d dz   = _mm_set1_pd(double(b.z()) - double(a.z()));
+    const __m128d one  = _mm_set1_pd(1.);
+    const __m128d half = _mm_set1_pd(0.5);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d ti = _mm_div_pd(_mm_sub_pd(_mm_set_pd(double(zs[i + 1]), double(zs[i])), az), dz);
+        const __m128d ui = _mm_sub_pd(one, ti);
+        alignas(16) double px[2], py[2];
+        _mm_store_pd(px, _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(ax, ui), _mm_mul_pd(bx, ti)), half), half));
+        _mm_store_pd(py, _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(ay, ui), _mm_mul_pd(by, ti)), half), half));
+        _mm_storeu_pd(t + i, ti);
+        // SSE2 has no rounding instruction.
+        x[i]     = coord_t(std::floor(px[0]));
+        x[i + 1] = coord_t(std::floor(px[1]));
+        y[i]     = coord_t(std::floor(py[0]));
+        y[i + 1] = coord_t(std::floor(py[1]));
+    }
+    for (; i < n; ++ i)
+        slice_edge_at_z(a, b, zs[i], t[i], x[i], y[i]);
+}
+
+// Intersect a triangle edge with planes zs[0, n), 4 planes at once.
+// FMA is not enabled for this function, so that the compiler does not contract the multiply-adds.
+#ifndef _MSC_VER
+__attribute__((target("avx2")))
+#endif // _MSC_VER
+static void slice_edge_at_zs_avx2(const stl_vertex &a, const stl_vertex &b, const float *zs, const size_t n, double *t, coord_t *x, coord_t *y)
+{
+    const __m256d ax   = _mm256_set1_pd(double(a.x()));
+    const __m256d ay   = _mm256_set1_pd(double(a.y()));
+    const __m256d az   = _mm256_set1_pd(double(a.z()));
+    const __m256d bx   = _mm256_set1_pd(double(b.x()));
+    const __m256d by   = _mm256_set1_pd(double(b.y()));
+    const __m256d dz   = _mm256_set1_pd(double(b.z()) - double(a.z()));
+    const __m256d one  = _mm256_set1_pd(1.);
+    const __m256d half = _mm256_set1_pd(0.5);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d ti = _mm256_div_pd(_mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(zs + i)), az), dz);
+        const __m256d ui = _mm256_sub_pd(one, ti);
+        alignas(32) double px[4], py[4];
+        _mm256_store_pd(px, _mm256_floor_pd(_mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ax, ui), _mm256_mul_pd(bx, ti)), half), half)));
+        _mm256_store_pd(py, _mm256_floor_pd(_mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ay, ui), _mm256_mul_pd(by, ti)), half), half)));
+        _mm256_storeu_pd(t + i, ti);
+        for (size_t j = 0; j < 4; ++ j) {
+            x[i + j] = coord_t(px[j]);
+            y[i + j] = coord_t(py[j]);
+        }
+    }
+    for (; i < n; ++ i)
+        slice_edge_at_z(a, b, zs[i], t[i], x[i], y[i]);
+}
+#endif // SLIC3R_SLICING_SIMD
+
+static inline void slice_edge_at_zs(const SlicingKernel kernel, const stl_vertex &a, const stl_vertex &b, const float *zs, const size_t n, double *t, coord_t *x, coord_t *y)
+{
+    switch (kernel) {
+#ifdef SLIC3R_SLICING_SIMD
+    case SlicingKernel::AVX2: slice_edge_at_zs_avx2(a, b, zs, n, t, x, y); break;
+    case SlicingKernel::SSE2: slice_edge_at_zs_sse2(a, b, zs, n, t, x, y); break;
+#endif // SLIC3R_SLICING_SIMD
+    default:
+        for (size_t i = 0; i < n; ++ i)
+            slice_edge_at_z(a, b, zs[i], t[i], x[i], y[i]);
+    }
+}
+
+// Slice a non-horizontal facet with a sorted run of planes zs[0, num_zs) spanning the facet, producing the same lines as slice_facet() does.
+// The intersections of planes in a general position with the facet edges are calculated by the vectorized edge kernels
+// in batches of planes, planes passing through a facet vertex are sliced by slice_facet().
+// emit_line(plane index, line) is called in the order of the planes.
+template<typename EmitLine>
+static void slice_facet_at_zs_batched(
+    const SlicingKernel                kernel,
+    const stl_vertex                  *vertices,
+    const stl_triangle_vertex_indices &indices,
+    const Vec3i                       &edge_ids,
+    const int                          idx_vertex_lowest,
+    const ColorPolygon::Color          facet_color,
+    const float                       *zs,
+    const size_t                       num_zs,
+    EmitLine                         &&emit_line)
+{
+    static constexpr const size_t batch_size = 64;
+    struct EdgeIntersections {
+        // Edge end points sorted by their vertex indices, the same way slice_facet() sorts them.
+        const stl_vertex *a;
+        const stl_vertex *b;
+        // Intersections clamped to the end points.
+        Point             a_clamped;
+        Point             b_clamped;
+        float             min_z;
+        float             max_z;
+        int               edge_id;
+        // Range of the current batch of planes intersecting the edge in a general position.
+        size_t            begin;
+        size_t            end;
+        double            t[batch_size];
+        coord_t           x[batch_size];
+        coord_t           y[batch_size];
+    } edges[3];
+
+    // Edges in the order slice_facet() visits them.
+    for (int j = 0; j < 3; ++ j) {
+        EdgeIntersections &edge = edges[j];
+        int k = (idx_vertex_lowest + j) % 3;
+        int l = (k + 1) % 3;
+        edge.edge_id   = edge_ids(k);
+        if (indices[k] > indices[l])
+            std::swap(k, l);
+        edge.a         = vertices + k;
+        edge.b         = vertices + l;
+        edge.a_clamped = v3f_scaled_to_contour_point(*edge.a);
+        edge.b_clamped = v3f_scaled_to_contour_point(*edge.b);
+        edge.min_z     = std::min(edge.a->z(), edge.b->z());
+        edge.max_z     = std::max(edge.a->z(), edge.b->z());
+    }
+
+    for (size_t batch_begin = 0; batch_begin < num_zs; batch_begin += batch_size) {
+        const float *batch     = zs + batch_begin;
+        const size_t batch_len = std::min(batch_size, num_zs - batch_begin);
+        for (EdgeIntersections &edge : edges) {
+            // Planes strictly between the edge end points.
+            edge.begin = std::upper_bound(batch, batch + batch_len, edge.min_z) - batch;
+            edge.end   = std::lower_bound(batch + edge.begin, batch + batch_len, edge.max_z) - batch;
+            if (edge.begin < edge.end)
+                slice_edge_at_zs(kernel, *edge.a, *edge.b, batch + edge.begin, edge.end - edge.begin, edge.t + edge.begin, edge.x + edge.begin, edge.y + edge.begin);
+        }
+        for (size_t i = 0; i < batch_len; ++ i) {
+            const float      slice_z = batch[i];
+            IntersectionLine il;
+            if (slice_z == vertices[0].z() || slice_z == vertices[1].z() || slice_z == vertices[2].z()) {
+                // The plane passes through a facet vertex.
+                if (slice_facet(slice_z, vertices, indices, edge_ids, idx_vertex_lowest, false, facet_color, il) == FacetSliceType::Slicing)
+                    emit_line(batch_begin + i, il);
+                continue;
+            }
+            // General position, the plane intersects exactly two edges.
+            IntersectionPoint points[2];
+            size_t            num_points = 0;
+            for (const EdgeIntersections &edge : edges)
+                if (i >= edge.begin && i < edge.end) {
+                    assert(num_points < 2);
+                    IntersectionPoint &point = points[num_points ++];
+                    const double t = edge.t[i];
+                    static_cast<Point&>(point) = t <= 0. ? edge.a_clamped : t >= 1. ? edge.b_clamped : Point(edge.x[i], edge.y[i]);
+                    point.edge_id = edge.edge_id;
+                }
+            assert(num_points == 2);
+            il.edge_type  = IntersectionLine::FacetEdgeType::General;
+            il.a          = static_cast<const Point&>(points[1]);
+            il.b          = static_cast<const Point&>(points[0]);
+            il.edge_a_id  = points[1].edge_id;
+            il.edge_b_id  = points[0].edge_id;
+            il.color      = facet_color;
+            emit_line(batch_begin + i, il);
+        }
+    }
+}
+
 class LinesMutexes {
 public:
     std::mutex& operator()(size_t slice_id) {
@@ -429,6 +664,7 @@ void slice_facet_at_zs(
     const ColorPolygon::Color                         facet_color,
     // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
     const std::vector<float>                         &zs,
+    const SlicingKernel                               kernel,
     std::vector<IntersectionLines>                   &lines,
     LinesMutexes                                     &lines_mutex)
 {
@@ -442,6 +678,18 @@ void slice_facet_at_zs(
     auto min_layer = std::lower_bound(zs.begin(), zs.end(), min_z); // first layer whose slice_z is >= min_z
     auto max_layer = std::upper_bound(min_layer, zs.end(), max_z); // first layer whose slice_z is > max_z
     int  idx_vertex_lowest = (vertices[1].z() == min_z) ? 1 : ((vertices[2].z() == min_z) ? 2 : 0);
+
+    if (kernel != SlicingKernel::Scalar && max_layer - min_layer > 1) {
+        // Ignore horizontal triangles, see below.
+        if (min_z != max_z)
+            slice_facet_at_zs_batched(kernel, vertices, indices, edge_ids, idx_vertex_lowest, facet_color, &*min_layer, max_layer - min_layer,
+                [&zs, &min_layer, &lines, &lines_mutex](size_t idx, const IntersectionLine &il) {
+                    size_t slice_id = min_layer - zs.begin() + idx;
+                    boost::lock_guard<std::mutex> l(lines_mutex(slice_id));
+                    lines[slice_id].emplace_back(il);
+                });
+        return;
+    }
     
     for (auto it = min_layer; it != max_layer; ++ it) {
         IntersectionLine il;
@@ -467,13 +715,14 @@ static inline std::vector<IntersectionLines> slice_make_lines(
 {
     std::vector<IntersectionLines> lines(zs.size(), IntersectionLines{});
     LinesMutexes                   lines_mutex;
+    const SlicingKernel            kernel = slicing_kernel();
     tbb::parallel_for(
         tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &facet_color_fn, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &facet_color_fn, &zs, kernel, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
             for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
                 if ((face_idx & 0x0ffff) == 0)
                     throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], facet_color_fn(face_idx), zs, lines, lines_mutex);
+                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], facet_color_fn(face_idx), zs, kernel, lines, lines_mutex);
             }
         }
     );
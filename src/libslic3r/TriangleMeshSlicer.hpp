@@ -63,6 +63,27 @@ struct MeshSlicingParamsEx : public MeshSlicingParams
     double        resolution { 0 };
 };
 
+// Implementation of the intersection of triangles with multiple slicing planes used by slice_mesh() and slice_mesh_ex().
+// All the kernels produce the same intersection lines, they differ in speed only. The lines are bit identical unless
+// the compiler contracts the scalar expressions into fused multiply-adds (-ffp-contract, -march with FMA),
+// then they may differ by a rounding of a single scaled unit.
+enum class SlicingKernel : uint32_t {
+    // Select the fastest kernel supported by the CPU at runtime.
+    Auto,
+    // Intersect each triangle with each plane by slice_facet().
+    Scalar,
+    // Intersect the triangle edges with runs of slicing planes, 2 planes at once (x86-64 only).
+    SSE2,
+    // Intersect the triangle edges with runs of slicing planes, 4 planes at once (x86-64 CPUs supporting AVX2 only).
+    AVX2,
+};
+
+// Select the slicing kernel for the following calls to slice_mesh(), mainly for benchmarking and testing.
+// A kernel not supported by the CPU is replaced with the best supported one.
+void                            set_slicing_kernel(SlicingKernel kernel);
+// Kernel used by slice_mesh(), never returns SlicingKernel::Auto.
+SlicingKernel                   slicing_kernel();
+
 // All the following slicing functions shall produce consistent results with the same mesh, same transformation matrix and slicing parameters.
 // Namely, slice_mesh_slabs() shall produce consistent results with slice_mesh() and slice_mesh_ex() in the sense, that projections made by 
 // slice_mesh_slabs() shall fall onto slicing planes produced by slice_mesh().
@@ -1577,27 +1577,7 @@ template<AdditionalMeshInfo facet_info>
 typename IndexedTriangleSetType<facet_info>::type TriangleSelector::get_facets_strict(const std::function<bool(const Triangle &)> &facet_filter) const {
     using IndexedTriangleSetType = typename IndexedTriangleSetType<facet_info>::type;
 
-    auto get_vertices_count = [&vertices = std::as_const(m_vertices)]() -> size_t {
-        size_t vertices_cnt = 0;
-        for (const Vertex &v : vertices) {
-            if (v.ref_cnt > 0)
-                ++vertices_cnt;
-        }
-
-        return vertices_cnt;
-    };
-
     IndexedTriangleSetType out;
-    out.vertices.reserve(get_vertices_count());
-
-    std::vector<int> vertex_map(m_vertices.size(), -1);
-    for (size_t i = 0; i < m_vertices.size(); ++i) {
-        if (const Vertex &v = m_vertices[i]; v.ref_cnt > 0) {
-            vertex_map[i] = int(out.vertices.size());
-            out.vertices.emplace_back(v.v);
-        }
-    }
-
     std::vector<uint8_t> out_colors;
     for (int itriangle = 0; itriangle < m_orig_size_indices; ++ itriangle)
         this->get_facets_strict_recursive<facet_info>(m_triangles[itriangle], m_neighbors[itriangle], facet_filter, out.indices, out_colors);
@@ -1606,6 +1586,23 @@ typename IndexedTriangleSetType<facet_info>::type TriangleSelector::get_facets_s
         out.colors = std::move(out_colors);
     }
 
+    // Export just the vertices referenced by the exported facets, keeping their order.
+    // With just a few facets passing the filter, most of the vertices of the source mesh are not referenced.
+    std::vector<int> vertex_map(m_vertices.size(), -1);
+    for (const auto &triangle : out.indices)
+        for (int i = 0; i < 3; ++i)
+            vertex_map[triangle(i)] = 0;
+
+    size_t vertices_cnt = 0;
+    for (int &mapped : vertex_map)
+        if (mapped == 0)
+            mapped = int(vertices_cnt ++);
+
+    out.vertices.reserve(vertices_cnt);
+    for (size_t i = 0; i < m_vertices.size(); ++i)
+        if (vertex_map[i] != -1)
+            out.vertices.emplace_back(m_vertices[i].v);
+
     for (auto &triangle : out.indices) {
         for (int i = 0; i < 3; ++i) {
             triangle(i) = vertex_map[triangle(i)];
@@ -1869,6 +1866,51 @@ TriangleSelector::TriangleSplittingData TriangleSelector::serialize() const {
     return out.data;
 }
 
+// Test whether the division tree of a single source triangle starting at bit ibit of the bitstream contains a face of test_state.
+// parents_children is a depth-first queue of a number of unvisited children, passed in to avoid re-allocating it for each triangle.
+static bool bitstream_has_state(const std::vector<bool> &bitstream, int ibit, const TriangleStateType test_state, std::vector<int> &parents_children)
+{
+    assert(ibit < int(bitstream.size()));
+    auto next_nibble = [&bitstream, &ibit]() {
+        int n = 0;
+        for (int i = 0; i < 4; ++ i)
+            n |= bitstream[ibit ++] << i;
+        return n;
+    };
+    // < 0 -> negative of a number of children
+    // >= 0 -> state
+    auto num_children_or_state = [&next_nibble]() -> int {
+        int code               = next_nibble();
+        int num_of_split_sides = code & 0b11;
+        return num_of_split_sides == 0 ?
+            ((code & 0b1100) == 0b1100 ? next_nibble() + 3 : code >> 2) :
+            - num_of_split_sides - 1;
+    };
+
+    int state = num_children_or_state();
+    if (state < 0) {
+        // Root is split.
+        parents_children.clear();
+        parents_children.emplace_back(- state);
+        do {
+            if (-- parents_children.back() >= 0) {
+                int state = num_children_or_state();
+                if (state < 0)
+                    // Child is split.
+                    parents_children.emplace_back(- state);
+                else if (state == int(test_state))
+                    // Child is not split and a face of test_state was found.
+                    return true;
+            } else
+                parents_children.pop_back();
+        } while (! parents_children.empty());
+        return false;
+    }
+
+    // Root is not split.
+    return state == int(test_state);
+}
+
 void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs_reset) {
     if (needs_reset)
         reset(); // dump any current state
@@ -1880,6 +1922,39 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
     // Here the triangles count account for both the nodes and leaves, thus the following line may overestimate.
     m_vertices.reserve(std::max(m_mesh.its.vertices.size(), m_triangles.size() / 2));
 
+    this->deserialize_source_triangles(data, nullptr);
+}
+
+void TriangleSelector::deserialize(const TriangleSplittingData &data, const TriangleStateType state, bool needs_reset) {
+    assert(state != TriangleStateType::NONE);
+    if (needs_reset)
+        reset(); // dump any current state
+
+    // Expand the source triangles containing a facet of the given state.
+    std::vector<bool> expand_source_triangle(m_orig_size_indices, false);
+    std::vector<int>  parents_children;
+    for (const TriangleBitStreamMapping &triangle_id_and_ibit : data.triangles_to_split)
+        if (bitstream_has_state(data.bitstream, triangle_id_and_ibit.bitstream_start_idx, state, parents_children)) {
+            expand_source_triangle[triangle_id_and_ibit.triangle_idx] = true;
+            // Splitting of a neighbor defines the T-joints along the shared edge, thus expand the neighbors as well.
+            for (int i = 0; i < 3; ++ i)
+                if (int neighbor_idx = m_neighbors[triangle_id_and_ibit.triangle_idx](i); neighbor_idx != -1)
+                    expand_source_triangle[neighbor_idx] = true;
+        }
+
+    // Reserve as deserialize() does, though just for the bits of the expanded source triangles.
+    size_t num_bits = 0;
+    for (size_t i = 0; i < data.triangles_to_split.size(); ++ i)
+        if (expand_source_triangle[data.triangles_to_split[i].triangle_idx])
+            num_bits += (i + 1 < data.triangles_to_split.size() ? size_t(data.triangles_to_split[i + 1].bitstream_start_idx) : data.bitstream.size()) -
+                size_t(data.triangles_to_split[i].bitstream_start_idx);
+    m_triangles.reserve(m_mesh.its.indices.size() + num_bits / 4);
+    m_vertices.reserve(m_mesh.its.vertices.size() + num_bits / 8);
+
+    this->deserialize_source_triangles(data, &expand_source_triangle);
+}
+
+void TriangleSelector::deserialize_source_triangles(const TriangleSplittingData &data, const std::vector<bool> *expand_source_triangle) {
     // Vector to store all parents that have offsprings.
     struct ProcessingInfo {
         int facet_id = 0;
@@ -1894,6 +1969,8 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
     for (auto [triangle_id, ibit] : data.triangles_to_split) {
         assert(triangle_id < int(m_triangles.size()));
         assert(ibit < int(data.bitstream.size()));
+        if (expand_source_triangle != nullptr && ! (*expand_source_triangle)[triangle_id])
+            continue;
         auto next_nibble = [&data, &ibit = ibit]() {
             int n = 0;
             for (int i = 0; i < 4; ++ i)
@@ -2009,46 +2086,9 @@ bool TriangleSelector::has_facets(const TriangleSplittingData &data, const Trian
     std::vector<int> parents_children;
     parents_children.reserve(64);
 
-    for (const TriangleBitStreamMapping &triangle_id_and_ibit : data.triangles_to_split) {
-        int ibit = triangle_id_and_ibit.bitstream_start_idx;
-        assert(ibit < int(data.bitstream.size()));
-        auto next_nibble = [&data, &ibit = ibit]() {
-            int n = 0;
-            for (int i = 0; i < 4; ++ i)
-                n |= data.bitstream[ibit ++] << i;
-            return n;
-        };
-        // < 0 -> negative of a number of children
-        // >= 0 -> state
-        auto num_children_or_state = [&next_nibble]() -> int {
-            int code               = next_nibble();
-            int num_of_split_sides = code & 0b11;
-            return num_of_split_sides == 0 ?
-                ((code & 0b1100) == 0b1100 ? next_nibble() + 3 : code >> 2) :
-                - num_of_split_sides - 1;
-        };
-
-        int state = num_children_or_state();
-        if (state < 0) {
-            // Root is split.
-            parents_children.clear();
-            parents_children.emplace_back(- state);
-            do {
-                if (-- parents_children.back() >= 0) {
-                    int state = num_children_or_state();
-                    if (state < 0)
-                        // Child is split.
-                        parents_children.emplace_back(- state);
-                    else if (state == int(test_state))
-                        // Child is not split and a face of test_state was found.
-                        return true;
-                } else
-                    parents_children.pop_back();
-            } while (! parents_children.empty());
-        } else if (state == int(test_state))
-            // Root is not split and a face of test_state was found.
+    for (const TriangleBitStreamMapping &triangle_id_and_ibit : data.triangles_to_split)
+        if (bitstream_has_state(data.bitstream, triangle_id_and_ibit.bitstream_start_idx, test_state, parents_children))
             return true;
-    }
 
     return false;
 }
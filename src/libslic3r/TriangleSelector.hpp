@@ -394,6 +394,11 @@ public:
 
     // Load serialized data. Assumes that correct mesh is loaded.
     void deserialize(const TriangleSplittingData &data, bool needs_reset = true);
+    // Load serialized data of just the source triangles containing a facet of the given state, and of their neighbors,
+    // which are needed to triangulate T-joints by get_facets_strict(). The other source triangles are left unsplit
+    // in TriangleStateType::NONE state, thus the state must not be TriangleStateType::NONE.
+    // Much cheaper than a full deserialization for querying a single state of a model painted with many states.
+    void deserialize(const TriangleSplittingData &data, TriangleStateType state, bool needs_reset = true);
 
     // Extract all used facet states from the given TriangleSplittingData.
     static std::vector<TriangleStateType> extract_used_facet_states(const TriangleSplittingData &data);
@@ -507,6 +512,8 @@ protected:
 
     // Private functions:
 private:
+    // Deserialize source triangles of data, only those marked in expand_source_triangle if not null.
+    void deserialize_source_triangles(const TriangleSplittingData &data, const std::vector<bool> *expand_source_triangle);
     bool select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting);
     bool select_triangle_recursive(int facet_idx, const Vec3i &neighbors, TriangleStateType type, bool triangle_splitting);
     void undivide_triangle(int facet_idx);
@@ -20,11 +20,13 @@
 
 #define CLIPPERLIB_NAMESPACE_PREFIX		Slic3r
 #define CLIPPERLIB_INTPOINT_TYPE    	Slic3r::Point
+#define CLIPPERLIB_ALLOCATOR        	Slic3r::PointsAllocator
 
 #include <clipper/clipper.hpp>
 
 #undef clipper_hpp
 #undef CLIPPERLIB_NAMESPACE_PREFIX
 #undef CLIPPERLIB_INTPOINT_TYPE
+#undef CLIPPERLIB_ALLOCATOR
 
 #endif // slic3r_clipper_hpp
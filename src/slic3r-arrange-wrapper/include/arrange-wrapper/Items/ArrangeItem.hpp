@@ -26,10 +26,12 @@
 #include <libslic3r/Point.hpp>
 #include <libslic3r/Polygon.hpp>
 #include <libslic3r/libslic3r.h>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 #include <arrange/PackingContext.hpp>
 #include <arrange/NFP/NFPArrangeItemTraits.hpp>
 #include <arrange/NFP/NFP.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeItemTraits.hpp>
 #include <arrange/DataStoreTraits.hpp>
@@ -62,7 +64,9 @@ inline bool check_polygons_are_convex(const Polygons &pp) {
 // appying a the transformations. The caching is not thread safe!
 class DecomposedShape
 {
-    Polygons m_shape;
+    // Shared by the copies of the shape, the contours are never modified.
+    std::shared_ptr<const Polygons> m_shape = std::make_shared<const Polygons>();
+    size_t                          m_id    = shape_id({});
 
     Vec2crd m_translation{0, 0}; // The translation of the poly
     double  m_rotation{0.0};     // The rotation of the poly in radians
@@ -86,21 +90,24 @@ public:
     DecomposedShape() = default;
 
     explicit DecomposedShape(Polygon sh)
-    {
-        m_shape.emplace_back(std::move(sh));
-        assert(check_polygons_are_convex(m_shape));
-    }
+        : DecomposedShape(Polygons{std::move(sh)})
+    {}
 
     explicit DecomposedShape(std::initializer_list<Point> pts)
         : DecomposedShape(Polygon{pts})
     {}
 
-    explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
+    explicit DecomposedShape(Polygons sh)
+        : m_shape{std::make_shared<const Polygons>(std::move(sh))}, m_id{shape_id(*m_shape)}
     {
-        assert(check_polygons_are_convex(m_shape));
+        assert(check_polygons_are_convex(*m_shape));
     }
 
-    const Polygons &contours() const { return m_shape; }
+    const Polygons &contours() const { return *m_shape; }
+    const std::shared_ptr<const Polygons> &contours_ptr() const { return m_shape; }
+
+    // Equal for shapes with equal contours, see arr2::shape_id().
+    size_t id() const { return m_id; }
 
     const Vec2crd &translation() const { return m_translation; }
     double         rotation() const { return m_rotation; }
@@ -310,59 +317,75 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
     }
 };
 
+// No-fit polygons of the movable shape around the fixed shape, for the fixed
+// shape placed at the origin. Only the rotations of the shapes are considered,
+// the translation of the movable shape does not change the result.
+Polygons calculate_nfp_unnormalized(const DecomposedShape &fixed,
+                                    const DecomposedShape &movable);
+
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
                                            StopCond &&stop_cond = {})
 {
-    size_t cap = 0;
-
-    for (const ArrangeItem &fixitem : fixed_items) {
-        const Polygons &outlines = fixitem.shape().transformed_outline();
-        cap += outlines.size();
-    }
+    const DecomposedShape &movable = item.envelope();
+    NFPCache              &cache   = NFPCache::global();
+
+    auto nfp_key = [&movable](const ArrangeItem &fixed) {
+        return NFPCache::Key{fixed.shape().contours_ptr(), fixed.shape().id(), fixed.shape().rotation(),
+                             movable.contours_ptr(), movable.id(), movable.rotation()};
+    };
+
+    // Look up the no-fit polygons of all the fixed items, the missing ones
+    // are calculated in parallel, each distinct shape and rotation just once.
+    std::vector<const ArrangeItem *>  fixed_ptrs;
+    std::vector<NFPCache::NFPPtr>     fixed_nfps;
+    std::vector<size_t>               missing;
+    std::vector<NFPCache::Key>        missing_keys;
+    for (const ArrangeItem &fixed : fixed_items) {
+        NFPCache::Key key = nfp_key(fixed);
 
-    const Polygons &item_outlines = item.envelope().transformed_outline();
+        NFPCache::NFPPtr nfp = cache.find(key);
+        if (!nfp && std::find(missing_keys.begin(), missing_keys.end(), key) == missing_keys.end()) {
+            missing.emplace_back(fixed_ptrs.size());
+            missing_keys.emplace_back(key);
+        }
 
-    auto nfps = reserve_polygons(cap * item_outlines.size());
+        fixed_ptrs.emplace_back(&fixed);
+        fixed_nfps.emplace_back(std::move(nfp));
+    }
 
-    Vec2crd ref_whole = item.envelope().reference_vertex();
-    Polygon subnfp;
+    // The cached transformations of the shape are not thread safe,
+    // update them before the parallel part.
+    movable.reference_vertex();
 
-    for (const ArrangeItem &fixed : fixed_items) {
-        // fixed_polys should already be a set of strictly convex polygons,
-        // as ArrangeItem stores convex-decomposed polygons
-        const Polygons & fixed_polys = fixed.shape().transformed_outline();
-
-        for (const Polygon &fixed_poly : fixed_polys) {
-            Point max_fixed = Slic3r::reference_vertex(fixed_poly);
-            for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
-                const Polygon &movable = item_outlines[mi];
-                const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
-
-                Vec2crd min_movable = item.envelope().min_vertex(mi);
-
-                Vec2crd dtouch = max_fixed - min_movable;
-                Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
-
-                auto d = ref_whole - mref + dnfp;
-                subnfp.translate(d);
-                nfps.emplace_back(subnfp);
-            }
+    // Note that stop_cond is called from the TBB worker threads here.
+    std::vector<NFPCache::NFPPtr> missing_nfps(missing.size());
+    execution::for_each(ex_tbb, size_t(0), missing.size(), [&](size_t i) {
+        if (!stop_cond())
+            missing_nfps[i] = cache.insert(
+                missing_keys[i],
+                calculate_nfp_unnormalized(fixed_ptrs[missing[i]]->shape(), movable));
+    }, 1);
 
-            if (stop_cond())
-                break;
+    if (std::any_of(missing_nfps.begin(), missing_nfps.end(), [](auto &nfp) { return !nfp; }))
+        return {};
 
-            nfps = union_(nfps);
+    size_t cap = 0;
+    for (size_t i = 0; i < fixed_nfps.size(); ++i) {
+        if (!fixed_nfps[i]) {
+            auto it = std::find(missing_keys.begin(), missing_keys.end(), nfp_key(*fixed_ptrs[i]));
+            assert(it != missing_keys.end());
+            fixed_nfps[i] = missing_nfps[it - missing_keys.begin()];
         }
+        cap += fixed_nfps[i]->size();
+    }
 
-        if (stop_cond()) {
-            nfps.clear();
-            break;
-        }
+    auto nfps = reserve_polygons(cap);
+    for (size_t i = 0; i < fixed_nfps.size(); ++i) {
+        const Vec2crd &d = fixed_ptrs[i]->shape().translation();
+        for (const Polygon &p : *fixed_nfps[i])
+            nfps.emplace_back(p).translate(d);
     }
 
     return nfps;
@@ -16,6 +16,7 @@ namespace Slic3r {
 
 class Model;
 class ModelInstance;
+class DynamicPrintConfig;
 
 namespace arr2 {
 class ArrangeSettingsView;
@@ -30,6 +31,10 @@ bool arrange_objects(Model &model,
                      const arr2::ArrangeBed &bed,
                      const arr2::ArrangeSettingsView &settings);
 
+// Arrange on the bed of the printer config, keeping the minimum object distance
+// of the print config, as the command line slicer does.
+bool arrange_objects(Model &model, const DynamicPrintConfig &config);
+
 void duplicate_objects(Model &              model,
                        size_t               copies_num,
                        const arr2::ArrangeBed &bed,
@@ -117,6 +117,45 @@ Vec2crd DecomposedShape::centroid() const
     return m_centroid;
 }
 
+Polygons calculate_nfp_unnormalized(const DecomposedShape &fixed,
+                                    const DecomposedShape &movable)
+{
+    DecomposedShape fixed_at_origin = fixed;
+    fixed_at_origin.translation({0, 0});
+
+    const Polygons &fixed_polys   = fixed_at_origin.transformed_outline();
+    const Polygons &item_outlines = movable.transformed_outline();
+
+    auto nfps = reserve_polygons(fixed_polys.size() * item_outlines.size());
+
+    Vec2crd ref_whole = movable.reference_vertex();
+    Polygon subnfp;
+
+    // fixed_polys should already be a set of strictly convex polygons,
+    // as ArrangeItem stores convex-decomposed polygons
+    for (const Polygon &fixed_poly : fixed_polys) {
+        Point max_fixed = Slic3r::reference_vertex(fixed_poly);
+        for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
+            const Polygon &movable_poly = item_outlines[mi];
+            const Vec2crd &mref = movable.reference_vertex(mi);
+            subnfp = nfp_convex_convex_legacy(fixed_poly, movable_poly);
+
+            Vec2crd min_movable = movable.min_vertex(mi);
+
+            Vec2crd dtouch = max_fixed - min_movable;
+            Vec2crd top_other = mref + dtouch;
+            Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
+            auto dnfp = top_other - max_nfp;
+
+            auto d = ref_whole - mref + dnfp;
+            subnfp.translate(d);
+            nfps.emplace_back(subnfp);
+        }
+    }
+
+    return union_(nfps);
+}
+
 DecomposedShape decompose(const ExPolygons &shape)
 {
     return DecomposedShape{convex_decomposition_tess(shape)};
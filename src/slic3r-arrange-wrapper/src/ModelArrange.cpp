@@ -4,6 +4,8 @@
 ///|/
 
 #include <libslic3r/Model.hpp>
+#include <libslic3r/MultipleBeds.hpp>
+#include <libslic3r/PrintConfig.hpp>
 #include <utility>
 
 #include <arrange-wrapper/ModelArrange.hpp>
@@ -37,6 +39,16 @@ bool arrange_objects(Model &model,
                        .set_model(model));
 }
 
+bool arrange_objects(Model &model, const DynamicPrintConfig &config)
+{
+    arr2::ArrangeSettings settings;
+    settings.set_distance_from_objects(min_object_distance(config));
+
+    return arrange_objects(model,
+                           arr2::to_arrange_bed(get_bed_shape(config), s_multiple_beds.get_bed_gap()),
+                           settings);
+}
+
 void duplicate_objects(Model &model,
                        size_t copies_num,
                        const arr2::ArrangeBed &bed,
@@ -0,0 +1,85 @@
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+
+#include "libslic3r/Polygon.hpp"
+
+namespace Slic3r { namespace arr2 {
+
+// Identifier of a set of polygons, equal for polygons with equal coordinates.
+// Duplicated instances of an object share it, thus they can share the no-fit
+// polygons calculated for them.
+size_t shape_id(const Polygons &polys);
+
+// Cache of the no-fit polygons calculated for pairs of a fixed and a movable
+// shape. The no-fit polygon of a pair depends on the shapes and their rotations,
+// the translation of the fixed shape only translates it and the translation of
+// the movable shape does not change it at all. The cached polygons are thus
+// stored for the fixed shape at the origin and reused for all the placements
+// of the same pair, also by the following arrange calls. Thread safe.
+class NFPCache
+{
+public:
+    // The contours of both shapes are stored with the key, the shape ids only
+    // speed up the look up. Keys with colliding ids are told apart by comparing
+    // the contours, which is cheap for the shared contours of duplicated shapes.
+    struct Key
+    {
+        std::shared_ptr<const Polygons> fixed;
+        size_t                          fixed_id;
+        double                          fixed_rotation;
+        std::shared_ptr<const Polygons> movable;
+        size_t                          movable_id;
+        double                          movable_rotation;
+
+        bool operator==(const Key &k) const
+        {
+            return fixed_id == k.fixed_id && fixed_rotation == k.fixed_rotation &&
+                   movable_id == k.movable_id && movable_rotation == k.movable_rotation &&
+                   same_contours(fixed, k.fixed) && same_contours(movable, k.movable);
+        }
+
+    private:
+        static bool same_contours(const std::shared_ptr<const Polygons> &l, const std::shared_ptr<const Polygons> &r)
+        {
+            return l == r || (l && r && *l == *r);
+        }
+    };
+
+    using NFPPtr = std::shared_ptr<const Polygons>;
+
+    // Returns nullptr if the no-fit polygon of the pair was not cached yet.
+    NFPPtr find(const Key &key) const;
+
+    // Returns the cached no-fit polygon, which is the one already stored
+    // if another thread inserted the same key in the meantime.
+    NFPPtr insert(const Key &key, Polygons nfp);
+
+    void   clear();
+    size_t size() const;
+
+    // The cache shared by all the arrange calls.
+    static NFPCache &global();
+
+private:
+    struct KeyHash { size_t operator()(const Key &key) const; };
+
+    // The cache is dropped as a whole once it holds more points.
+    static constexpr size_t MaxPoints = 4000000;
+
+    mutable std::mutex                         m_mutex;
+    std::unordered_map<Key, NFPPtr, KeyHash>   m_nfps;
+    size_t                                     m_points = 0;
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
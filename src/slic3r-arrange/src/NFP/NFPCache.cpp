@@ -0,0 +1,81 @@
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include <arrange/NFP/NFPCache.hpp>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+size_t shape_id(const Polygons &polys)
+{
+    size_t seed = polys.size();
+    for (const Polygon &poly : polys) {
+        boost::hash_combine(seed, poly.size());
+        for (const Point &p : poly.points) {
+            boost::hash_combine(seed, p.x());
+            boost::hash_combine(seed, p.y());
+        }
+    }
+
+    return seed;
+}
+
+size_t NFPCache::KeyHash::operator()(const Key &key) const
+{
+    size_t seed = key.fixed_id;
+    boost::hash_combine(seed, key.fixed_rotation);
+    boost::hash_combine(seed, key.movable_id);
+    boost::hash_combine(seed, key.movable_rotation);
+
+    return seed;
+}
+
+NFPCache::NFPPtr NFPCache::find(const Key &key) const
+{
+    std::lock_guard lk{m_mutex};
+    auto it = m_nfps.find(key);
+
+    return it == m_nfps.end() ? nullptr : it->second;
+}
+
+NFPCache::NFPPtr NFPCache::insert(const Key &key, Polygons nfp)
+{
+    size_t npoints = count_points(nfp);
+    auto   ptr     = std::make_shared<const Polygons>(std::move(nfp));
+
+    std::lock_guard lk{m_mutex};
+    if (m_points + npoints > MaxPoints) {
+        m_nfps.clear();
+        m_points = 0;
+    }
+
+    auto [it, inserted] = m_nfps.emplace(key, ptr);
+    if (inserted)
+        m_points += npoints;
+
+    return it->second;
+}
+
+void NFPCache::clear()
+{
+    std::lock_guard lk{m_mutex};
+    m_nfps.clear();
+    m_points = 0;
+}
+
+size_t NFPCache::size() const
+{
+    std::lock_guard lk{m_mutex};
+
+    return m_nfps.size();
+}
+
+NFPCache &NFPCache::global()
+{
+    static NFPCache cache;
+
+    return cache;
+}
+
+}} // namespace Slic3r::arr2
@@ -10,6 +10,7 @@
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/NFPConcave_Tesselate.hpp>
+#include <arrange/NFP/NFPCache.hpp>
 
 #include <arrange-wrapper/Items/SimpleArrangeItem.hpp>
 #include <arrange-wrapper/Items/ArrangeItem.hpp>
@@ -459,6 +460,66 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("NFP of duplicated fixed items is calculated once", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::NFPCache::global().clear();
+
+    arr2::InfiniteBed bed;
+    const ItemPair   &td = nfp_testdata.front();
+
+    std::vector<ArrangeItem> fixed(3, td.stationary);
+    for (size_t i = 0; i < fixed.size(); ++i)
+        arr2::translate(fixed[i], Vec2crd{scaled(100. * i), scaled(50. * i)});
+
+    auto nfp_around = [&td, &bed](const ArrangeItem &fixed_item) {
+        std::vector<ArrangeItem> fixed_items = {fixed_item};
+        return arr2::calculate_nfp(td.orbiter, arr2::default_context(fixed_items), bed);
+    };
+
+    ExPolygons nfp_first = nfp_around(fixed.front());
+    REQUIRE(!nfp_first.empty());
+    REQUIRE(arr2::NFPCache::global().size() == 1);
+
+    // The cached polygons are only translated with the fixed item.
+    for (const ArrangeItem &fixed_item : fixed) {
+        ExPolygons nfp = nfp_around(fixed_item);
+        BoundingBox bb = get_extents(nfp_first);
+        bb.translate(fixed_item.translation() - fixed.front().translation());
+        REQUIRE(get_extents(nfp) == bb);
+        REQUIRE(area(nfp) == Approx(area(nfp_first)));
+    }
+
+    auto nfp_all = arr2::calculate_nfp(td.orbiter, arr2::default_context(fixed), bed);
+    REQUIRE(nfp_all.size() == fixed.size());
+    REQUIRE(arr2::NFPCache::global().size() == 1);
+
+    // A different rotation of the movable item is a different pair of shapes.
+    ArrangeItem rotated = td.orbiter;
+    arr2::rotate(rotated, PI / 2.);
+    std::vector<ArrangeItem> fixed_items = {fixed.front()};
+    arr2::calculate_nfp(rotated, arr2::default_context(fixed_items), bed);
+    REQUIRE(arr2::NFPCache::global().size() == 2);
+}
+
+TEST_CASE("NFP cache tells apart shapes with colliding ids", "[arrange2]") {
+    using namespace Slic3r;
+
+    auto square = [](coord_t size) {
+        return std::make_shared<const Polygons>(Polygons{Polygon{{0, 0}, {size, 0}, {size, size}, {0, size}}});
+    };
+
+    arr2::NFPCache cache;
+    auto small = square(10), big = square(20);
+    cache.insert({small, 1, 0., small, 2, 0.}, Polygons{});
+    REQUIRE(cache.find({small, 1, 0., small, 2, 0.}));
+    // Equal contours stored separately are the same shape.
+    REQUIRE(cache.find({square(10), 1, 0., square(10), 2, 0.}));
+    // Equal ids of different contours are a hash collision.
+    REQUIRE(!cache.find({big, 1, 0., small, 2, 0.}));
+    REQUIRE(!cache.find({small, 1, 0., big, 2, 0.}));
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
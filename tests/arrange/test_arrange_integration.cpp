@@ -1088,3 +1088,42 @@ TEST_CASE("Testing duplicate function to really duplicate the whole Model",
     REQUIRE(is_collision_free(range(task->selected)));
 }
 
+
+TEST_CASE("Arranging by a print config uses its bed and object distance", "[arrange2][integration]")
+{
+    using namespace Slic3r;
+
+    // The same model arranged for two printers, like by consecutive jobs of the command line batch slicing.
+    Model model = get_example_model_with_20mm_cube();
+    for (int i = 0; i < 3; ++ i)
+        model.objects.front()->add_instance();
+
+    auto make_config = [](const std::string &bed_shape, double duplicate_distance) {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({ { "bed_shape", bed_shape }, { "duplicate_distance", duplicate_distance } });
+        return config;
+    };
+    for (const DynamicPrintConfig &config : { make_config("0x0,250x0,250x210,0x210", 6.), make_config("300x300,450x300,450x450,300x450", 20.) }) {
+        REQUIRE(arrange_objects(model, config));
+
+        BoundingBoxf bed;
+        for (const Vec2d &pt : config.opt<ConfigOptionPoints>("bed_shape")->values)
+            bed.merge(pt);
+        std::vector<BoundingBoxf> boxes;
+        const ModelObject &object = *model.objects.front();
+        for (size_t i = 0; i < object.instances.size(); ++ i) {
+            BoundingBoxf3 bb = object.instance_bounding_box(i);
+            boxes.emplace_back(to_2d(bb.min), to_2d(bb.max));
+            REQUIRE(bed.contains(boxes.back().min));
+            REQUIRE(bed.contains(boxes.back().max));
+        }
+        const double distance = min_object_distance(config);
+        for (size_t i = 0; i < boxes.size(); ++ i)
+            for (size_t j = i + 1; j < boxes.size(); ++ j) {
+                // Gap between the axis aligned cubes along the axis they are separated by.
+                const double gap = std::max({ boxes[j].min.x() - boxes[i].max.x(), boxes[i].min.x() - boxes[j].max.x(),
+                                              boxes[j].min.y() - boxes[i].max.y(), boxes[i].min.y() - boxes[j].max.y() });
+                REQUIRE(gap >= distance - 0.01);
+            }
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include "benchmark_utils.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("AABB tree build and ray casting by single rays and packets", "[AABBIndirect][.Benchmarks]") {
+    // Fine tessellation, so that the tree is built in parallel.
+    const indexed_triangle_set its = its_make_sphere(25., PI / 360.);
+
+    Slic3r::Test::benchmark_thread_scaling("build_aabb_tree_over_indexed_triangle_set(), " + std::to_string(its.indices.size()) + " triangles",
+        [&its]() { return AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices); });
+
+    const AABBTreeIndirect::Tree3f tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+
+    // Coherent rays: a grid of parallel rays shot from below the object, as used by the SLA hollowing and support point generator.
+    std::vector<Vec3d> origins_coherent;
+    std::vector<Vec3d> dirs_coherent;
+    const int grid = 300;
+    for (int i = 0; i < grid; ++ i)
+        for (int j = 0; j < grid; ++ j) {
+            origins_coherent.emplace_back(-25. + 50. * (i + 0.5) / grid, -25. + 50. * (j + 0.5) / grid, -30.);
+            dirs_coherent.emplace_back(0., 0., 1.);
+        }
+    // Incoherent rays: rays shot from the mesh vertices in random directions, as used for the ambient occlusion.
+    std::vector<Vec3d> origins_incoherent;
+    std::vector<Vec3d> dirs_incoherent;
+    std::mt19937 rng(42);
+    std::normal_distribution<double> normal;
+    for (size_t ivertex = 0; ivertex < its.vertices.size() && origins_incoherent.size() < size_t(grid * grid); ivertex += 3)
+        for (int s = 0; s < 10; ++ s) {
+            const Vec3d d = Vec3d(normal(rng), normal(rng), normal(rng)).normalized();
+            origins_incoherent.emplace_back(its.vertices[ivertex].cast<double>() + 1e-4 * d);
+            dirs_incoherent.emplace_back(d);
+        }
+
+    // The number of rays is part of the benchmark names to read the throughput from the reported times.
+    auto cast_rays = [&its, &tree](const std::string &name, const std::vector<Vec3d> &origins, const std::vector<Vec3d> &dirs) {
+        const std::string prefix = name + " " + std::to_string(origins.size()) + " rays, ";
+        BENCHMARK(prefix + "single rays") {
+            size_t   num_hits = 0;
+            igl::Hit hit;
+            for (size_t i = 0; i < origins.size(); ++ i)
+                if (AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit))
+                    ++ num_hits;
+            return num_hits;
+        };
+        Slic3r::Test::benchmark_thread_scaling(prefix + "packets of 4", [&]() {
+            std::vector<igl::Hit> hits;
+            return AABBTreeIndirect::intersect_rays_first_hit<4>(its.vertices, its.indices, tree, origins, dirs, hits);
+        });
+        Slic3r::Test::benchmark_thread_scaling(prefix + "packets of 8", [&]() {
+            std::vector<igl::Hit> hits;
+            return AABBTreeIndirect::intersect_rays_first_hit<8>(its.vertices, its.indices, tree, origins, dirs, hits);
+        });
+    };
+    cast_rays("Coherent", origins_coherent, dirs_coherent);
+    cast_rays("Incoherent", origins_incoherent, dirs_incoherent);
+}
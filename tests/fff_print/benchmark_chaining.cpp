@@ -0,0 +1,61 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include "libslic3r/ShortestPath.hpp"
+#include "libslic3r/ExtrusionEntity.hpp"
+
+using namespace Slic3r;
+
+// Short randomly oriented lines scattered over a print bed, resembling gap fill or support lines of a large layer.
+static Polylines random_short_lines(size_t count)
+{
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<double> pos(0., scaled<double>(250.));
+    std::uniform_real_distribution<double> len(scaled<double>(0.2), scaled<double>(2.));
+    std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+    Polylines out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++ i) {
+        const Point  a(coord_t(pos(rng)), coord_t(pos(rng)));
+        const double l   = len(rng);
+        const double phi = angle(rng);
+        out.emplace_back(a, a + Point(coord_t(l * cos(phi)), coord_t(l * sin(phi))));
+    }
+    return out;
+}
+
+static double travel_length(const Polylines &polylines)
+{
+    double out = 0.;
+    for (size_t i = 1; i < polylines.size(); ++ i)
+        out += (polylines[i].first_point() - polylines[i - 1].last_point()).cast<double>().norm();
+    return out;
+}
+
+TEST_CASE("Chaining of many short lines", "[ShortestPath][.Benchmarks]") {
+    for (size_t count : { size_t(1000), size_t(10000), size_t(50000) }) {
+        const Polylines lines = random_short_lines(count);
+        const Polylines chained = chain_polylines(lines);
+        REQUIRE(chained.size() == lines.size());
+        CHECK(travel_length(chained) < travel_length(lines));
+
+        BENCHMARK("chain_polylines() " + std::to_string(count)) {
+            return chain_polylines(lines);
+        };
+        BENCHMARK("chain_polylines() with a start point " + std::to_string(count)) {
+            const Point start_near(0, 0);
+            return chain_polylines(lines, &start_near);
+        };
+
+        ExtrusionEntitiesPtr entities;
+        entities.reserve(lines.size());
+        for (const Polyline &line : lines)
+            entities.emplace_back(new ExtrusionPath(line, ExtrusionAttributes{ ExtrusionRole::GapFill, ExtrusionFlow{ 0.1, 0.4f, 0.2f } }));
+        BENCHMARK("chain_extrusion_entities() " + std::to_string(count)) {
+            return chain_extrusion_entities(entities);
+        };
+        for (ExtrusionEntity *entity : entities)
+            delete entity;
+    }
+}
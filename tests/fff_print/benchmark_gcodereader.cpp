@@ -0,0 +1,62 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+
+using namespace Slic3r;
+
+namespace {
+
+// Writes about 100MB of G-code resembling the output of PrusaSlicer.
+boost::filesystem::path write_test_gcode()
+{
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcodereader-benchmark-%%%%-%%%%.gcode");
+    std::ofstream file(path.string(), std::ios::binary);
+    char line[128];
+    for (int layer = 0; layer < 1000; ++ layer) {
+        file << ";LAYER_CHANGE\n;Z:" << 0.2 * (layer + 1) << "\n;HEIGHT:0.2\nG1 Z" << 0.2 * (layer + 1) << " F720\n";
+        for (int i = 0; i < 3000; ++ i) {
+            snprintf(line, sizeof(line), "G1 X%.3f Y%.3f E%.5f\n", 100. + (i % 400) * 0.125, 80. + (i / 400) * 0.45, 0.03125 + (i % 13) * 0.001);
+            file << line;
+            if (i % 500 == 0)
+                file << ";TYPE:Solid infill\n;WIDTH:0.45\nG1 F3600\n";
+        }
+    }
+    return path;
+}
+
+} // namespace
+
+TEST_CASE("GCodeReader benchmarks", "[GCodeReader][.Benchmarks]") {
+    const boost::filesystem::path path = write_test_gcode();
+    size_t cnt_lines = 0;
+    auto count_lines = [&cnt_lines](GCodeReader &, const GCodeReader::GCodeLine &) { ++ cnt_lines; };
+
+    auto parse_buffered = [&path, &count_lines]() {
+        GCodeReader reader;
+        reader.set_memory_mapped(false);
+        reader.parse_file(path.string(), count_lines);
+    };
+    auto parse_mapped = [&path, &count_lines]() {
+        GCodeReader reader;
+        reader.parse_file(path.string(), count_lines);
+    };
+    auto parse_mapped_parallel = [&path, &count_lines]() {
+        GCodeReader reader;
+        std::vector<std::vector<size_t>> lines_ends;
+        reader.parse_file_parallel(path.string(), count_lines, lines_ends);
+    };
+
+    // The file size in the name divided by the mean time gives the throughput in MB/s.
+    const std::string name = "Parse " + std::to_string(boost::filesystem::file_size(path) / (1024 * 1024)) + " MB of G-code";
+    BENCHMARK(name + ", buffered") { parse_buffered(); return cnt_lines; };
+    BENCHMARK(name + ", memory mapped") { parse_mapped(); return cnt_lines; };
+    BENCHMARK(name + ", memory mapped parallel") { parse_mapped_parallel(); return cnt_lines; };
+
+    boost::filesystem::remove(path);
+}
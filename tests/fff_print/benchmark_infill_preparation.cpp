@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Print.hpp"
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+// Infill preparation of the test models: the per-layer surface classification, vertical shell discovery
+// and bridge over infill steps, all of which create and destroy many Polygons temporaries.
+// The models are sliced once, then posPrepareInfill is invalidated by toggling solid_infill_below_area.
+// Print::process() then reruns posPrepareInfill and posInfill, thus the cost of posInfill alone is measured
+// as well by toggling fill_angle.
+TEST_CASE("Preparation of infill surfaces of test models", "[PrintObject][.Benchmarks]") {
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "layer_height", 0.1 },
+        { "fill_density", "15%" },
+        { "ensure_vertical_shell_thickness", "enabled" },
+        { "top_solid_layers", 5 },
+        { "bottom_solid_layers", 5 },
+        { "skirts", 0 },
+    });
+
+    for (TestMesh mesh : { TestMesh::ipadstand, TestMesh::sphere_50mm, TestMesh::overhang, TestMesh::bridge_with_hole, TestMesh::sloping_hole }) {
+        Print print;
+        Model model;
+        init_print({ mesh }, print, model, config);
+        print.process();
+
+        // Invalidates the step by alternating the value of an option, which only the step and the following steps depend on.
+        auto reprocess = [&print, &model, config](const char *opt_key, double value1, double value2) mutable {
+            ConfigOptionFloat *opt = config.option<ConfigOptionFloat>(opt_key);
+            opt->value = opt->value == value1 ? value2 : value1;
+            print.apply(model, config);
+            print.process();
+        };
+        auto prepare_infill = [&reprocess]() { reprocess("solid_infill_below_area", 15., 15.01); };
+        auto infill         = [&reprocess]() { reprocess("fill_angle", 45., 45.01); };
+
+        // Allocations of Points, Polygons and the Clipper paths, which make the bulk of the temporaries.
+        size_t num_allocations_prepare_infill;
+        size_t num_allocations_infill;
+        {
+            PointsAllocationCounter counter;
+            prepare_infill();
+            num_allocations_prepare_infill = counter.count();
+        }
+        {
+            PointsAllocationCounter counter;
+            infill();
+            num_allocations_infill = counter.count();
+        }
+        WARN(mesh_names.at(mesh) << ", " << print.objects().front()->layer_count() << " layers: " <<
+            num_allocations_prepare_infill << " allocations by posPrepareInfill and posInfill, " << num_allocations_infill << " by posInfill");
+
+        BENCHMARK(std::string("posPrepareInfill and posInfill of ") + mesh_names.at(mesh)) {
+            prepare_infill();
+        };
+        BENCHMARK(std::string("posInfill of ") + mesh_names.at(mesh)) {
+            infill();
+        };
+    }
+}
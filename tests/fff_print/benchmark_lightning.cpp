@@ -0,0 +1,32 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Fill/FillLightning.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include "benchmark_utils.hpp"
+#include "test_data.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Lightning infill tree generation", "[Lightning][.Benchmarks]") {
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "layer_height", 0.2 },
+        { "fill_pattern", "lightning" },
+        { "fill_density", "15%" },
+    });
+    Print print;
+    Model model;
+    // 300 mm tall part with 1500 layers.
+    Slic3r::Test::init_print({ make_cylinder(30., 300.) }, print, model, config);
+    print.process();
+    const PrintObject &print_object = *print.objects().front();
+
+    auto generate = [&print_object]() {
+        return FillLightning::build_generator(print_object, 15., []() {});
+    };
+
+    // How the tree generation scales with the number of threads.
+    Slic3r::Test::benchmark_thread_scaling("FillLightning::Generator", generate);
+}
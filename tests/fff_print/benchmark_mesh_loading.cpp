@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "libslic3r/Model.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/Format/STL.hpp"
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+
+// Tile copies of a mesh from the test data into a grid to get a mesh of a size of a 3D scan.
+static TriangleMesh scaled_up_mesh(const char *name, size_t min_facets)
+{
+    TriangleMesh mesh;
+    REQUIRE(load_obj((std::string(TEST_DATA_DIR) + "/" + name).c_str(), &mesh));
+    const Vec3d  size   = mesh.size() + Vec3d(1., 1., 1.);
+    const auto   copies = size_t(std::ceil(std::sqrt(double(min_facets) / double(mesh.facets_count()))));
+    TriangleMesh out;
+    for (size_t i = 0; i < copies; ++ i)
+        for (size_t j = 0; j < copies; ++ j) {
+            TriangleMesh copy = mesh;
+            copy.translate(float(i * size.x()), float(j * size.y()), 0.f);
+            out.merge(copy);
+        }
+    return out;
+}
+
+TEST_CASE("Loading of large STL and OBJ files", "[MeshLoading][.Benchmarks]") {
+    const TriangleMesh mesh     = scaled_up_mesh("extruder_idler.obj", 2000000);
+    const std::string  stl_file = (boost::filesystem::temp_directory_path() / "benchmark_mesh_loading.stl").string();
+    const std::string  obj_file = (boost::filesystem::temp_directory_path() / "benchmark_mesh_loading.obj").string();
+    TriangleMesh       mesh_copy = mesh;
+    REQUIRE(store_stl(stl_file.c_str(), &mesh_copy, true));
+    REQUIRE(store_obj(obj_file.c_str(), &mesh_copy));
+
+    BENCHMARK("Load binary STL") {
+        TriangleMesh loaded;
+        loaded.ReadSTLFile(stl_file.c_str());
+        return loaded;
+    };
+    BENCHMARK("Load OBJ") {
+        TriangleMesh loaded;
+        load_obj(obj_file.c_str(), &loaded);
+        return loaded;
+    };
+
+    // Triangle soup with each facet referencing its own three vertices.
+    indexed_triangle_set soup;
+    soup.vertices.reserve(mesh.its.indices.size() * 3);
+    soup.indices.reserve(mesh.its.indices.size());
+    for (const stl_triangle_vertex_indices &face : mesh.its.indices) {
+        const auto idx = int(soup.vertices.size());
+        for (int i = 0; i < 3; ++ i)
+            soup.vertices.emplace_back(mesh.its.vertices[face(i)]);
+        soup.indices.emplace_back(idx, idx + 1, idx + 2);
+    }
+    BENCHMARK("its_merge_vertices()") {
+        indexed_triangle_set its = soup;
+        its_merge_vertices(its);
+        return its;
+    };
+
+    boost::filesystem::remove(stl_file);
+    boost::filesystem::remove(obj_file);
+}
@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "libslic3r/Model.hpp"
+#include "libslic3r/MultiMaterialSegmentation.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleSelector.hpp"
+
+#include "benchmark_utils.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Multi-material segmentation of a painted sphere", "[MultiMaterialSegmentation][.Benchmarks]") {
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "layer_height", 0.1 },
+        { "nozzle_diameter", "0.4,0.4,0.4,0.4,0.4" },
+        { "top_solid_layers", 5 },
+        { "bottom_solid_layers", 5 },
+        { "wipe_tower", 0 },
+    });
+
+    // Sphere with a fine tessellation, painted with five colors in horizontal bands split into angular sectors,
+    // so that both the side segmentation and the segmentation of top and bottom layers have a lot of work to do.
+    Model        model;
+    ModelObject *object = model.add_object();
+    ModelVolume *volume = object->add_volume(make_sphere(25., PI / 360.));
+    object->add_instance();
+    {
+        TriangleSelector           selector(volume->mesh());
+        const indexed_triangle_set &its = volume->mesh().its;
+        for (int facet_idx = 0; facet_idx < int(its.indices.size()); ++ facet_idx) {
+            const stl_triangle_vertex_indices &face     = its.indices[facet_idx];
+            const Vec3f                        centroid = (its.vertices[face(0)] + its.vertices[face(1)] + its.vertices[face(2)]) / 3.f;
+            const int band   = int(std::floor((centroid.z() + 25.f) / 2.f));
+            const int sector = int(std::floor((std::atan2(centroid.y(), centroid.x()) + PI) / (PI / 6.)));
+            selector.set_facet(facet_idx, TriangleStateType(int(TriangleStateType::Extruder1) + (band + sector) % 5));
+        }
+        volume->mm_segmentation_facets.set(selector);
+    }
+    model.center_instances_around_point({ 100, 100 });
+    object->ensure_on_bed();
+
+    Print print;
+    print.apply(model, config);
+    print.set_status_silent();
+    print.process();
+    const PrintObject &print_object = *print.objects().front();
+
+    auto segmentation = [&print_object]() {
+        return multi_material_segmentation_by_painting(print_object, []() {});
+    };
+
+    // How the segmentation scales with the number of threads.
+    Slic3r::Test::benchmark_thread_scaling("multi_material_segmentation_by_painting()", segmentation);
+}
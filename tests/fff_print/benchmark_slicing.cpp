@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+using namespace Slic3r;
+
+static const char* kernel_name(SlicingKernel kernel)
+{
+    switch (kernel) {
+    case SlicingKernel::Scalar: return "Scalar";
+    case SlicingKernel::SSE2:   return "SSE2";
+    case SlicingKernel::AVX2:   return "AVX2";
+    default:                    return "Auto";
+    }
+}
+
+TEST_CASE("Slicing of a large mesh by scalar and SIMD kernels", "[TriangleMeshSlicer][.Benchmarks]") {
+    // Grid of finely tesselated spheres, about 2M triangles.
+    const TriangleMesh sphere = make_sphere(10., 2. * PI / 360.);
+    TriangleMesh mesh;
+    for (int i = 0; i < 4; ++ i)
+        for (int j = 0; j < 4; ++ j) {
+            TriangleMesh copy = sphere;
+            copy.translate(float(i) * 25.f, float(j) * 25.f, 10.f);
+            mesh.merge(copy);
+        }
+
+    set_slicing_kernel(SlicingKernel::Auto);
+    const SlicingKernel simd_kernel = slicing_kernel();
+    for (double layer_height : { 0.2, 0.1, 0.05 }) {
+        std::vector<float> zs;
+        for (double z = 0.5 * layer_height; z < 20.; z += layer_height)
+            zs.emplace_back(float(z));
+
+        // The triangle count in the name divided by the mean time gives the triangles per second.
+        std::string name = "slice_mesh() of " + std::to_string(mesh.facets_count()) + " triangles at layer height " + std::to_string(layer_height);
+        set_slicing_kernel(SlicingKernel::Scalar);
+        BENCHMARK(name + ", " + kernel_name(SlicingKernel::Scalar)) {
+            return slice_mesh(mesh.its, zs, MeshSlicingParams{});
+        };
+        set_slicing_kernel(simd_kernel);
+        BENCHMARK(name + ", " + kernel_name(simd_kernel)) {
+            return slice_mesh(mesh.its, zs, MeshSlicingParams{});
+        };
+    }
+    set_slicing_kernel(SlicingKernel::Auto);
+}
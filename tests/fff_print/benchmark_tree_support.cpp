@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/BuildVolume.hpp"
+#include "libslic3r/Support/TreeModelVolumes.hpp"
+#include "libslic3r/Support/TreeSupportCommon.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include "benchmark_utils.hpp"
+#include "test_data.hpp"
+
+using namespace Slic3r;
+using namespace Slic3r::FFFTreeSupport;
+
+TEST_CASE("Tree support collision and avoidance precalculation", "[TreeSupport][.Benchmarks]") {
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "layer_height", 0.2 },
+        { "support_material_style", "organic" },
+    });
+    Print print;
+    Model model;
+    // Tall model with many layers to fill the caches of TreeModelVolumes.
+    Slic3r::Test::init_print({ make_cylinder(15., 150.) }, print, model, config);
+    print.process();
+    const PrintObject &print_object = *print.objects().front();
+
+    const TreeSupportSettings settings{ TreeSupportMeshGroupSettings{ print_object }, print_object.slicing_parameters() };
+    const BuildVolume build_volume{ config.opt<ConfigOptionPoints>("bed_shape")->values, config.opt_float("max_print_height") };
+    const auto max_layer = LayerIndex(print_object.layer_count()) - 1;
+
+    auto precalculate = [&]() {
+        TreeModelVolumes volumes{ print_object, build_volume, settings.maximum_move_distance, settings.maximum_move_distance_slow, 0,
+#ifdef SLIC3R_TREESUPPORTS_PROGRESS
+            1., 0.,
+#endif // SLIC3R_TREESUPPORTS_PROGRESS
+            {} };
+        volumes.precalculate(print_object, max_layer, []() {});
+        return volumes;
+    };
+
+    // How the precalculation scales with the number of threads.
+    Slic3r::Test::benchmark_thread_scaling("TreeModelVolumes::precalculate()", precalculate);
+}
@@ -0,0 +1,30 @@
+#ifndef SLIC3R_BENCHMARK_UTILS_HPP
+#define SLIC3R_BENCHMARK_UTILS_HPP
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <oneapi/tbb/task_arena.h>
+
+namespace Slic3r { namespace Test {
+
+// Benchmarks fn in task arenas of 1, 2, 4 ... threads up to the maximum concurrency
+// to show how fn scales with the number of threads. To be called from a TEST_CASE.
+template<typename Fn>
+void benchmark_thread_scaling(const std::string &name, Fn &&fn)
+{
+    for (int num_threads = 1;; num_threads = std::min(2 * num_threads, tbb::this_task_arena::max_concurrency())) {
+        tbb::task_arena arena(num_threads);
+        BENCHMARK(name + ", " + std::to_string(num_threads) + " threads") {
+            return arena.execute([&fn]() { return fn(); });
+        };
+        if (num_threads == tbb::this_task_arena::max_concurrency())
+            break;
+    }
+}
+
+}} // namespace Slic3r::Test
+
+#endif // SLIC3R_BENCHMARK_UTILS_HPP
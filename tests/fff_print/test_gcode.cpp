@@ -8,7 +8,10 @@
 #include <regex>
 #include <fstream>
 
+#include <boost/filesystem.hpp>
+
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "test_data.hpp"
 
@@ -328,3 +331,51 @@ TEST_CASE("M201 for acceleation reset", "[GCode]") {
     INFO("M204 is not generated for repetier firmware");
     CHECK(!has_m204);
 }
+
+TEST_CASE("Memory mapped and parallel parsing of G-code file", "[GCode]") {
+    // Longer than a single chunk of GCodeReader::parse_file_parallel(), with mixed line endings,
+    // empty lines, comments and without EOL at the end of the last line.
+    std::string gcode;
+    for (int i = 0; i < 100000; ++ i) {
+        gcode += "G1 X" + std::to_string(i % 200) + " Y" + std::to_string(i % 150) + " E0.05 ; extrude\n";
+        if (i % 7 == 0)
+            gcode += "G1 Z" + std::to_string(i / 7) + "\r\n";
+        if (i % 11 == 0)
+            gcode += "\n;comment\n";
+    }
+    gcode += "G1 F1200 X1";
+
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcodereader-%%%%-%%%%.gcode");
+    {
+        std::ofstream file(path.string(), std::ios::binary);
+        file << gcode;
+    }
+
+    struct ParsedLine {
+        std::string raw;
+        float       position[4];
+        bool operator==(const ParsedLine &rhs) const { return raw == rhs.raw && memcmp(position, rhs.position, sizeof(position)) == 0; }
+    };
+    auto collect = [](std::vector<ParsedLine> &out) {
+        return [&out](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+            out.push_back({ line.raw(), { reader.x(), reader.y(), reader.z(), reader.e() } });
+        };
+    };
+
+    std::vector<ParsedLine>          buffered, serial, parallel;
+    std::vector<std::vector<size_t>> lines_ends_buffered, lines_ends_serial, lines_ends_parallel;
+    GCodeReader reader_buffered, reader_serial, reader_parallel;
+    reader_buffered.set_memory_mapped(false);
+    REQUIRE(reader_buffered.parse_file(path.string(), collect(buffered), lines_ends_buffered));
+    REQUIRE(reader_serial.parse_file(path.string(), collect(serial), lines_ends_serial));
+    REQUIRE(reader_parallel.parse_file_parallel(path.string(), collect(parallel), lines_ends_parallel));
+    boost::filesystem::remove(path);
+
+    CHECK(serial.size() > 100000);
+    CHECK(serial == buffered);
+    CHECK(serial == parallel);
+    CHECK(lines_ends_serial == lines_ends_buffered);
+    CHECK(lines_ends_serial == lines_ends_parallel);
+    CHECK(reader_parallel.x() == reader_serial.x());
+    CHECK(reader_parallel.f() == reader_serial.f());
+}
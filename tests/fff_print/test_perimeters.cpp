@@ -3,6 +3,8 @@
 #include <numeric>
 #include <sstream>
 
+#include <oneapi/tbb/task_arena.h>
+
 #include "libslic3r/Config.hpp"
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Layer.hpp"
@@ -630,3 +632,34 @@ SCENARIO("Seam alignment", "[Perimeters]")
         test(Slic3r::Test::TestMesh::small_dorito);
     }
 }
+
+TEST_CASE("Arachne perimeters generated in parallel are the same as the serial ones", "[Perimeters]")
+{
+    auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "perimeter_generator", "arachne" },
+        { "perimeters",          3 }
+    });
+
+    // Perimeters and fill areas of all layer regions, islands and walls processed with the given number of threads.
+    auto make_perimeters = [&config](int num_threads) {
+        std::vector<std::pair<Polylines, ExPolygons>> out;
+        Print print;
+        tbb::task_arena arena(num_threads);
+        // two_hollow_squares has two islands in a layer, gt2_teeth has walls of varying width.
+        arena.execute([&]() { Test::init_and_process_print({ Test::TestMesh::two_hollow_squares, Test::TestMesh::gt2_teeth }, print, config); });
+        for (const PrintObject *object : print.objects())
+            for (const Layer *layer : object->layers())
+                for (const LayerRegion *layerm : layer->regions())
+                    out.emplace_back(layerm->perimeters().as_polylines(), layerm->fill_expolygons());
+        return out;
+    };
+    const std::vector<std::pair<Polylines, ExPolygons>> serial   = make_perimeters(1);
+    const std::vector<std::pair<Polylines, ExPolygons>> parallel = make_perimeters(tbb::this_task_arena::max_concurrency());
+
+    REQUIRE(! serial.empty());
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++ i) {
+        REQUIRE(parallel[i].first == serial[i].first);
+        REQUIRE(parallel[i].second == serial[i].second);
+    }
+}
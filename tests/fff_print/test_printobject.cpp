@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 
+#include <boost/filesystem.hpp>
+
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
@@ -87,3 +89,199 @@ SCENARIO("PrintObject: object layer heights", "[PrintObject]") {
 #endif
     }
 }
+
+SCENARIO("PrintObject: slice cache", "[PrintObject]") {
+    GIVEN("20mm cube sliced with the slice cache enabled") {
+        const boost::filesystem::path cache_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("prusaslicer-slice-cache-%%%%-%%%%");
+        auto process = [&cache_dir](Print &print, double first_layer_height) {
+            Model model;
+            init_print({TestMesh::cube_20x20x20}, print, model, { { "fill_density", 0.2 }, { "top_solid_layers", 3 }, { "first_layer_height", first_layer_height } });
+            print.set_slice_cache_dir(cache_dir.string());
+            print.process();
+        };
+        auto num_cache_entries = [&cache_dir]() {
+            return std::distance(boost::filesystem::directory_iterator(cache_dir), boost::filesystem::directory_iterator());
+        };
+        auto same_extrusions = [](const ExtrusionEntityCollection &a, const ExtrusionEntityCollection &b) {
+            ExtrusionEntityCollection flat_a = a.flatten();
+            ExtrusionEntityCollection flat_b = b.flatten();
+            if (flat_a.entities.size() != flat_b.entities.size())
+                return false;
+            for (size_t i = 0; i < flat_a.entities.size(); ++ i)
+                if (flat_a.entities[i]->role() != flat_b.entities[i]->role() ||
+                    flat_a.entities[i]->as_polyline() != flat_b.entities[i]->as_polyline())
+                    return false;
+            return true;
+        };
+        Print print_computed;
+        process(print_computed, 0.2);
+        THEN("A cache entry is stored") {
+            REQUIRE(num_cache_entries() == 1);
+        }
+        WHEN("The same object is sliced again") {
+            Print print_cached;
+            process(print_cached, 0.2);
+            THEN("No new cache entry is stored") {
+                REQUIRE(num_cache_entries() == 1);
+            }
+            THEN("The restored layers match the computed layers") {
+                SpanOfConstPtrs<Layer> computed = print_computed.objects().front()->layers();
+                SpanOfConstPtrs<Layer> cached   = print_cached.objects().front()->layers();
+                REQUIRE(cached.size() == computed.size());
+                for (size_t i = 0; i < computed.size(); ++ i) {
+                    REQUIRE(cached[i]->print_z == computed[i]->print_z);
+                    REQUIRE(cached[i]->lslices == computed[i]->lslices);
+                    REQUIRE(cached[i]->region_count() == computed[i]->region_count());
+                    for (size_t region_id = 0; region_id < computed[i]->region_count(); ++ region_id) {
+                        const LayerRegion &a = *computed[i]->get_region(int(region_id));
+                        const LayerRegion &b = *cached[i]->get_region(int(region_id));
+                        REQUIRE(b.slices().size() == a.slices().size());
+                        for (size_t surface_id = 0; surface_id < a.slices().size(); ++ surface_id) {
+                            REQUIRE(b.slices().surfaces[surface_id].surface_type == a.slices().surfaces[surface_id].surface_type);
+                            REQUIRE(b.slices().surfaces[surface_id].expolygon == a.slices().surfaces[surface_id].expolygon);
+                        }
+                        REQUIRE(same_extrusions(b.perimeters(), a.perimeters()));
+                        REQUIRE(same_extrusions(b.fills(), a.fills()));
+                    }
+                }
+            }
+            AND_THEN("The exported G-code is not empty") {
+                REQUIRE(! gcode(print_cached).empty());
+            }
+        }
+        WHEN("The object is sliced again with a different first layer height") {
+            Print print_modified;
+            process(print_modified, 0.3);
+            THEN("The cache is missed and a new cache entry is stored") {
+                REQUIRE(num_cache_entries() == 2);
+                REQUIRE(print_modified.objects().front()->layers().front()->print_z == Approx(0.3));
+            }
+        }
+        boost::filesystem::remove_all(cache_dir);
+    }
+}
+
+SCENARIO("PrintObject: perimeters are regenerated for a modified layer range only", "[PrintObject]") {
+    GIVEN("20mm cube with a layer range modifier up to 5mm") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({ { "perimeters", 2 }, { "enable_dynamic_overhang_speeds", 0 } });
+        Print print;
+        Model model;
+        init_print({TestMesh::cube_20x20x20}, print, model, config);
+        ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 0., 5. }];
+        range_config.set("layer_height", config.opt_float("layer_height"));
+        range_config.set("perimeters", 3);
+        print.apply(model, config);
+        print.process();
+
+        // Collect pointers to the perimeter extrusions in place, flatten() would clone them.
+        auto collect_leaves = [](const ExtrusionEntityCollection &collection, std::vector<const ExtrusionEntity*> &out, auto &self) -> void {
+            for (const ExtrusionEntity *ee : collection.entities)
+                if (ee->is_collection())
+                    self(*static_cast<const ExtrusionEntityCollection*>(ee), out, self);
+                else
+                    out.emplace_back(ee);
+        };
+        auto layer_perimeters = [&collect_leaves](const Print &print) {
+            std::vector<std::vector<const ExtrusionEntity*>> out;
+            for (const Layer *layer : print.objects().front()->layers()) {
+                std::vector<const ExtrusionEntity*> &entities = out.emplace_back();
+                for (const LayerRegion *layerm : layer->regions())
+                    collect_leaves(layerm->perimeters(), entities, collect_leaves);
+            }
+            return out;
+        };
+        const std::vector<std::vector<const ExtrusionEntity*>> perimeters_before = layer_perimeters(print);
+        std::vector<size_t> perimeter_counts_before;
+        for (const std::vector<const ExtrusionEntity*> &entities : perimeters_before)
+            perimeter_counts_before.emplace_back(entities.size());
+
+        WHEN("The number of perimeters of the layer range is changed") {
+            range_config.set("perimeters", 4);
+            print.apply(model, config);
+            print.process();
+            const std::vector<std::vector<const ExtrusionEntity*>> perimeters_after = layer_perimeters(print);
+            SpanOfConstPtrs<Layer> layers = print.objects().front()->layers();
+            REQUIRE(perimeters_after.size() == perimeters_before.size());
+            THEN("Perimeters above the layer range are kept, perimeters inside the layer range are regenerated") {
+                for (size_t i = 0; i < layers.size(); ++ i) {
+                    if (layers[i]->slice_z < 5. - EPSILON)
+                        REQUIRE(perimeters_after[i].size() > perimeter_counts_before[i]);
+                    else if (layers[i]->slice_z > 5. + EPSILON)
+                        REQUIRE(perimeters_after[i] == perimeters_before[i]);
+                }
+            }
+            THEN("Perimeters match a print processed from scratch") {
+                Print print_new;
+                print_new.apply(model, config);
+                print_new.process();
+                SpanOfConstPtrs<Layer> layers_new = print_new.objects().front()->layers();
+                REQUIRE(layers_new.size() == layers.size());
+                for (size_t i = 0; i < layers.size(); ++ i) {
+                    REQUIRE(layers_new[i]->region_count() == layers[i]->region_count());
+                    for (size_t region_id = 0; region_id < layers[i]->region_count(); ++ region_id) {
+                        REQUIRE(layers_new[i]->get_region(int(region_id))->perimeters().items_count() == layers[i]->get_region(int(region_id))->perimeters().items_count());
+                        REQUIRE(layers_new[i]->get_region(int(region_id))->fills().items_count() == layers[i]->get_region(int(region_id))->fills().items_count());
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: perimeters are regenerated for all layer ranges sharing a modified region", "[PrintObject]") {
+    GIVEN("20mm cube with two layer range modifiers of the same configuration") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({ { "perimeters", 2 }, { "enable_dynamic_overhang_speeds", 0 } });
+        Print print;
+        Model model;
+        init_print({TestMesh::cube_20x20x20}, print, model, config);
+        // Both layer ranges produce the same PrintRegion.
+        std::vector<ModelConfig*> range_configs;
+        for (const t_layer_height_range &range : { t_layer_height_range(0., 5.), t_layer_height_range(10., 15.) }) {
+            ModelConfig &range_config = model.objects.front()->layer_config_ranges[range];
+            range_config.set("layer_height", config.opt_float("layer_height"));
+            range_config.set("perimeters", 3);
+            range_configs.emplace_back(&range_config);
+        }
+        print.apply(model, config);
+        print.process();
+        auto in_modified_range = [](double z) { return z < 5. - EPSILON || (z > 10. + EPSILON && z < 15. - EPSILON); };
+        auto in_unmodified_range = [](double z) { return (z > 5. + EPSILON && z < 10. - EPSILON) || z > 15. + EPSILON; };
+        auto perimeter_counts = [](const Print &print) {
+            std::vector<size_t> out;
+            for (const Layer *layer : print.objects().front()->layers()) {
+                size_t cnt = 0;
+                for (const LayerRegion *layerm : layer->regions())
+                    cnt += layerm->perimeters().items_count();
+                out.emplace_back(cnt);
+            }
+            return out;
+        };
+        const std::vector<size_t> perimeter_counts_before = perimeter_counts(print);
+
+        WHEN("The number of perimeters of both layer ranges is changed") {
+            for (ModelConfig *range_config : range_configs)
+                range_config->set("perimeters", 4);
+            print.apply(model, config);
+            print.process();
+            const std::vector<size_t> perimeter_counts_after = perimeter_counts(print);
+            SpanOfConstPtrs<Layer> layers = print.objects().front()->layers();
+            REQUIRE(perimeter_counts_after.size() == perimeter_counts_before.size());
+            THEN("Perimeters of layers of both layer ranges are regenerated") {
+                for (size_t i = 0; i < layers.size(); ++ i) {
+                    if (in_modified_range(layers[i]->slice_z))
+                        REQUIRE(perimeter_counts_after[i] > perimeter_counts_before[i]);
+                    else if (in_unmodified_range(layers[i]->slice_z))
+                        REQUIRE(perimeter_counts_after[i] == perimeter_counts_before[i]);
+                }
+            }
+            THEN("Perimeters match a print processed from scratch") {
+                Print print_new;
+                print_new.apply(model, config);
+                print_new.process();
+                REQUIRE(perimeter_counts(print_new) == perimeter_counts_after);
+            }
+        }
+    }
+}
@@ -1,7 +1,12 @@
 #include <catch2/catch.hpp>
 
+#include <oneapi/tbb/task_arena.h>
+
+#include "libslic3r/BuildVolume.hpp"
 #include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Support/TreeModelVolumes.hpp"
+#include "libslic3r/Support/TreeSupportCommon.hpp"
 
 #include "test_data.hpp" // get access to init_print, etc
 
@@ -495,3 +500,50 @@ Old Perl tests, which were disabled by Vojtech at the time of first Support Gene
 }
 
 */
+
+TEST_CASE("SupportMaterial: parallel tree support precalculation matches the serial one", "[SupportMaterial]")
+{
+    using namespace Slic3r::FFFTreeSupport;
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "support_material_style", "organic" },
+        // Make xy_distance differ from xy_min_distance, so that the avoidances of a radius query the collisions of another radius.
+        { "support_material_xy_spacing", 1. },
+    });
+    Print print;
+    Model model;
+    init_print({ TestMesh::cube_with_hole }, print, model, config);
+    print.process();
+    const PrintObject &print_object = *print.objects().front();
+
+    const TreeSupportSettings settings{ TreeSupportMeshGroupSettings{ print_object }, print_object.slicing_parameters() };
+    const BuildVolume build_volume{ config.opt<ConfigOptionPoints>("bed_shape")->values, config.opt_float("max_print_height") };
+    const auto max_layer = LayerIndex(print_object.layer_count()) - 1;
+    REQUIRE(settings.xy_distance != settings.xy_min_distance);
+
+    auto precalculate = [&](int num_threads) {
+        TreeModelVolumes volumes{ print_object, build_volume, settings.maximum_move_distance, settings.maximum_move_distance_slow, 0,
+#ifdef SLIC3R_TREESUPPORTS_PROGRESS
+            1., 0.,
+#endif // SLIC3R_TREESUPPORTS_PROGRESS
+            {} };
+        tbb::task_arena arena(num_threads);
+        arena.execute([&]() { volumes.precalculate(print_object, max_layer, []() {}); });
+        return volumes;
+    };
+    const TreeModelVolumes serial   = precalculate(1);
+    const TreeModelVolumes parallel = precalculate(tbb::this_task_arena::max_concurrency());
+
+    // Query the radii of the tree tips and of the branches for the layers they are precalculated for.
+    for (LayerIndex distance_to_top = 0; distance_to_top <= LayerIndex(settings.tip_layers) + 2; ++ distance_to_top) {
+        const coord_t radius = settings.getRadius(distance_to_top);
+        for (LayerIndex layer_idx = 0; layer_idx <= max_layer - distance_to_top; ++ layer_idx) {
+            REQUIRE(parallel.getCollision(radius, layer_idx, true) == serial.getCollision(radius, layer_idx, true));
+            REQUIRE(parallel.getCollision(radius, layer_idx, false) == serial.getCollision(radius, layer_idx, false));
+            for (TreeModelVolumes::AvoidanceType type : { TreeModelVolumes::AvoidanceType::Slow, TreeModelVolumes::AvoidanceType::FastSafe, TreeModelVolumes::AvoidanceType::Fast })
+                REQUIRE(parallel.getAvoidance(radius, layer_idx, type, false, true) == serial.getAvoidance(radius, layer_idx, type, false, true));
+            if (layer_idx > 0)
+                REQUIRE(parallel.getWallRestriction(radius, layer_idx, true) == serial.getWallRestriction(radius, layer_idx, true));
+        }
+    }
+}
@@ -177,6 +177,61 @@ SCENARIO( "TriangleMesh: slice behavior.") {
     }
 }
 
+TEST_CASE("Slicing kernels produce the same slices", "[TriangleMeshSlicer]") {
+    TriangleMesh sphere = make_sphere(10., 2. * PI / 180.);
+    sphere.rotate(float(PI / 7.), Vec3d(1., 1., 0.).normalized());
+    TriangleMesh cube = make_cube();
+    // Planes passing through vertices of the cube, planes in general positions, multiple batches of planes per facet.
+    std::vector<float> zs;
+    for (float z = -10.f; z <= 20.f; z += 0.05f)
+        zs.emplace_back(z);
+    for (float z = 0.f; z <= 20.f; z += 1.f)
+        zs.emplace_back(z);
+    std::sort(zs.begin(), zs.end());
+
+    // The order of intersection lines depends on scheduling of the slicing threads, thus the loops may start at different points.
+    // Compare the sorted points of the slices. The vectorized kernels may round differently (FMA contraction),
+    // thus the points are matched with a tolerance of a single scaled unit.
+    auto slice_points = [&zs](const TriangleMesh &mesh) {
+        std::vector<Points> out;
+        for (const Polygons &slice : slice_mesh(mesh.its, zs, MeshSlicingParams{})) {
+            Points pts = to_points(slice);
+            std::sort(pts.begin(), pts.end(), [](const Point &l, const Point &r) { return l.x() < r.x() || (l.x() == r.x() && l.y() < r.y()); });
+            out.emplace_back(std::move(pts));
+        }
+        return out;
+    };
+
+    auto same_points = [](const Points &pts, const Points &reference) {
+        if (pts.size() != reference.size())
+            return false;
+        for (const Point &pt : pts) {
+            auto it = std::lower_bound(reference.begin(), reference.end(), pt.x() - 1, [](const Point &l, coord_t x) { return l.x() < x; });
+            for (; it != reference.end() && it->x() <= pt.x() + 1; ++ it)
+                if (std::abs(it->y() - pt.y()) <= 1)
+                    break;
+            if (it == reference.end() || it->x() > pt.x() + 1)
+                return false;
+        }
+        return true;
+    };
+
+    for (const TriangleMesh *mesh : { &sphere, &cube }) {
+        set_slicing_kernel(SlicingKernel::Scalar);
+        REQUIRE(slicing_kernel() == SlicingKernel::Scalar);
+        std::vector<Points> reference = slice_points(*mesh);
+        for (SlicingKernel kernel : { SlicingKernel::SSE2, SlicingKernel::AVX2 }) {
+            set_slicing_kernel(kernel);
+            // Unsupported kernels are replaced by supported ones.
+            std::vector<Points> slices = slice_points(*mesh);
+            REQUIRE(slices.size() == reference.size());
+            for (size_t i = 0; i < slices.size(); ++ i)
+                REQUIRE(same_points(slices[i], reference[i]));
+        }
+    }
+    set_slicing_kernel(SlicingKernel::Auto);
+}
+
 SCENARIO( "make_xxx functions produce meshes.") {
     GIVEN("make_cube() function") {
         WHEN("make_cube() is called with arguments 20,20,20") {
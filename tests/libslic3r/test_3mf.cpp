@@ -133,3 +133,53 @@ SCENARIO("2D convex hull of sinking object", "[3mf]") {
     }
 }
 
+
+SCENARIO("Export+Import of multiple objects and volumes to/from 3mf file cycle", "[3mf]") {
+    GIVEN("model with a multi-volume object and a large mesh") {
+        // Meshes are written and read in chunks in parallel, the sphere spans multiple chunks.
+        Model src_model;
+        ModelObject *src_object = src_model.add_object();
+        src_object->add_volume(make_sphere(20., 2. * PI / 360.));
+        src_object->add_volume(make_cube(10., 20., 30.));
+        src_object->add_instance();
+        src_model.add_object()->add_volume(make_cube(5., 5., 5.));
+        src_model.objects.back()->add_instance();
+
+        WHEN("model is saved+loaded to/from 3mf file") {
+            std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/multiple_volumes.3mf";
+            REQUIRE(store_3mf(test_file.c_str(), &src_model, nullptr, false));
+
+            Model dst_model;
+            DynamicPrintConfig dst_config;
+            bool ret;
+            {
+                ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+                boost::optional<Semver> version;
+                ret = load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false, version);
+            }
+            boost::filesystem::remove(test_file);
+
+            THEN("load should succeed") {
+                REQUIRE(ret);
+            }
+            THEN("objects and volumes match") {
+                REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                for (size_t i = 0; i < src_model.objects.size(); ++ i) {
+                    const ModelObject &src = *src_model.objects[i];
+                    const ModelObject &dst = *dst_model.objects[i];
+                    REQUIRE(dst.volumes.size() == src.volumes.size());
+                    for (size_t j = 0; j < src.volumes.size(); ++ j) {
+                        const indexed_triangle_set &src_its = src.volumes[j]->mesh().its;
+                        const indexed_triangle_set &dst_its = dst.volumes[j]->mesh().its;
+                        REQUIRE(dst_its.indices == src_its.indices);
+                        REQUIRE(dst_its.vertices.size() == src_its.vertices.size());
+                        bool res = true;
+                        for (size_t k = 0; k < src_its.vertices.size(); ++ k)
+                            res &= dst_its.vertices[k].isApprox(src_its.vertices[k]);
+                        REQUIRE(res);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -2,6 +2,8 @@
 #include <catch2/catch.hpp>
 #include <test_utils.hpp>
 
+#include <oneapi/tbb/task_arena.h>
+
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
@@ -61,6 +63,67 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Parallel tree build and packet ray caster match the serial ones", "[AABBIndirect]")
+{
+    // Large enough for the tree to be built in parallel.
+    indexed_triangle_set its = its_make_sphere(10., PI / 200.);
+    REQUIRE(its.indices.size() > 50000);
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    AABBTreeIndirect::Tree3f tree_serial;
+    tbb::task_arena(1).execute([&its, &tree_serial]() {
+        tree_serial = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    });
+    REQUIRE(tree.nodes().size() == tree_serial.nodes().size());
+    size_t num_different_nodes = 0;
+    for (size_t i = 0; i < tree.nodes().size(); ++ i)
+        if (tree.node(i).idx != tree_serial.node(i).idx || (tree.node(i).is_valid() && ! tree.node(i).bbox.isApprox(tree_serial.node(i).bbox, 0.f)))
+            ++ num_different_nodes;
+    REQUIRE(num_different_nodes == 0);
+
+    // Rays shot from inside and outside of the sphere, including rays parallel to the coordinate axes.
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (int i = -20; i < 20; ++ i)
+        for (int j = -20; j < 20; ++ j) {
+            origins.emplace_back(0.3 * i, 0.3 * j, -20.);
+            dirs.emplace_back(0., 0., 1.);
+            origins.emplace_back(0.3 * i, 0.3 * j, 1.);
+            dirs.emplace_back(0.01 * j, 0.01 * i, -1.);
+            origins.emplace_back(0., 0., 0.);
+            dirs.emplace_back(std::cos(0.05 * i) * std::cos(0.1 * j), std::sin(0.05 * i) * std::cos(0.1 * j), std::sin(0.1 * j));
+        }
+    // The last packet is incomplete.
+    origins.pop_back();
+    dirs.pop_back();
+
+    std::vector<igl::Hit> hits4;
+    std::vector<igl::Hit> hits8;
+    size_t num_hits4 = AABBTreeIndirect::intersect_rays_first_hit<4>(its.vertices, its.indices, tree, origins, dirs, hits4);
+    size_t num_hits8 = AABBTreeIndirect::intersect_rays_first_hit<8>(its.vertices, its.indices, tree, origins, dirs, hits8);
+    REQUIRE(hits4.size() == origins.size());
+    REQUIRE(hits8.size() == origins.size());
+
+    size_t num_hits = 0;
+    size_t num_mismatches = 0;
+    auto   same_hit = [](const igl::Hit &hit1, const igl::Hit &hit2) {
+        return hit1.id == hit2.id && (hit1.id == -1 || (hit1.t == hit2.t && hit1.u == hit2.u && hit1.v == hit2.v));
+    };
+    for (size_t i = 0; i < origins.size(); ++ i) {
+        igl::Hit hit;
+        if (AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit))
+            ++ num_hits;
+        else
+            hit.id = -1;
+        if (! same_hit(hit, hits4[i]) || ! same_hit(hit, hits8[i]))
+            ++ num_mismatches;
+    }
+    REQUIRE(num_hits > 0);
+    REQUIRE(num_hits4 == num_hits);
+    REQUIRE(num_hits8 == num_hits);
+    REQUIRE(num_mismatches == 0);
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
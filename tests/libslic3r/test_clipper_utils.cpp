@@ -382,3 +382,32 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Batched Clipper operations match the serial ones", "[ClipperUtils]") {
+    // Squares with holes of varying sizes, each one clipped and offsetted independently.
+    std::vector<ExPolygon> subjects;
+    for (int i = 0; i < 64; ++ i) {
+        const coord_t s = 1000 + 37 * i;
+        subjects.emplace_back(Polygon{ { 0, 0 }, { s, 0 }, { s, s }, { 0, s } }, Polygon{ { s / 4, s / 4 }, { s / 4, 3 * s / 4 }, { 3 * s / 4, 3 * s / 4 }, { 3 * s / 4, s / 4 } });
+    }
+    const Polygons clip { Polygon{ { 500, -100 }, { 700, -100 }, { 700, 5000 }, { 500, 5000 } } };
+
+    std::vector<ExPolygons> batched(subjects.size());
+    ClipperUtils::batch(subjects.size(), [&](size_t i) {
+        batched[i] = offset_ex(diff_ex(subjects[i], clip), -50.f);
+    });
+
+    for (size_t i = 0; i < subjects.size(); ++ i)
+        REQUIRE(batched[i] == offset_ex(diff_ex(subjects[i], clip), -50.f));
+}
+
+TEST_CASE("Offset parameters do not leak into the next offset", "[ClipperUtils]") {
+    // Round ends of a polyline offsetted with miter joins use the default arc tolerance.
+    const Polyline polyline { { 0, 0 }, { scaled<coord_t>(10.), 0 }, { scaled<coord_t>(10.), scaled<coord_t>(10.) } };
+    const Polygons reference = offset(polyline, scaled<float>(1.), ClipperLib::jtMiter, 3., ClipperLib::etOpenRound);
+    // Offset with a coarse arc tolerance, which is set to the thread local ClipperOffset.
+    const Polygons square { Polygon{ { 0, 0 }, { scaled<coord_t>(10.), 0 }, { scaled<coord_t>(10.), scaled<coord_t>(10.) }, { 0, scaled<coord_t>(10.) } } };
+    const Polygons rounded = offset(square, scaled<float>(1.), ClipperLib::jtRound, scaled<double>(0.5));
+    REQUIRE(! rounded.empty());
+    REQUIRE(offset(polyline, scaled<float>(1.), ClipperLib::jtMiter, 3., ClipperLib::etOpenRound) == reference);
+}
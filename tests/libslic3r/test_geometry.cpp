@@ -16,6 +16,7 @@
 
 #include "../data/prusaparts.hpp"
 
+#include <random>
 #include <unordered_set>
 
 using namespace Slic3r;
@@ -458,6 +459,44 @@ SCENARIO("Path chaining", "[Geometry]") {
 			}
 		}
 	}
+	GIVEN("More short lines than optimized exhaustively") {
+		// Over 256 lines the crossovers are only searched for between neighbor end points.
+		std::mt19937                           rng(42);
+		std::uniform_real_distribution<double> pos(0., scaled<double>(100.));
+		std::uniform_real_distribution<double> len(scaled<double>(0.2), scaled<double>(2.));
+		std::uniform_real_distribution<double> angle(0., 2. * M_PI);
+		Polylines polylines;
+		for (size_t i = 0; i < 1000; ++ i) {
+			const Point  p(coord_t(pos(rng)), coord_t(pos(rng)));
+			const double l   = len(rng);
+			const double phi = angle(rng);
+			polylines.push_back({ p, p + Point(coord_t(l * cos(phi)), coord_t(l * sin(phi))) });
+		}
+		auto connection_length = [](const Polylines &polylines) {
+			double out = 0.;
+			for (size_t i = 1; i < polylines.size(); ++ i)
+				out += (polylines[i].first_point() - polylines[i - 1].last_point()).cast<double>().norm();
+			return out;
+		};
+		Polylines chained = chain_polylines(polylines);
+		THEN("Each line is chained exactly once, possibly reversed") {
+			REQUIRE(chained.size() == polylines.size());
+			auto less = [](const Point &l, const Point &r) { return l.x() < r.x() || (l.x() == r.x() && l.y() < r.y()); };
+			auto sorted_lines = [&less](const Polylines &polylines) {
+				std::vector<std::pair<Point, Point>> out;
+				for (const Polyline &pl : polylines)
+					out.emplace_back(std::minmax(pl.first_point(), pl.last_point(), less));
+				std::sort(out.begin(), out.end(), [&less](const auto &l, const auto &r) {
+					return less(l.first, r.first) || (l.first == r.first && less(l.second, r.second));
+				});
+				return out;
+			};
+			REQUIRE(sorted_lines(chained) == sorted_lines(polylines));
+		}
+		THEN("The chain is shorter than the input order") {
+			REQUIRE(connection_length(chained) < connection_length(polylines));
+		}
+	}
 }
 
 SCENARIO("Line distances", "[Geometry]"){
@@ -3,6 +3,8 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 using namespace Slic3r;
 
 static inline std::string stl_path(const char* path)
@@ -55,3 +57,25 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+SCENARIO("Binary STL file cycle", "[stl]") {
+	GIVEN("a mesh stored to a binary STL file") {
+		// Large enough for the facets to be converted by multiple threads.
+		TriangleMesh src_mesh = make_sphere(10., 2. * PI / 360.);
+		src_mesh.translate(1.f, 2.f, 3.f);
+		std::string path = stl_path("sphere_binary.stl");
+		REQUIRE(Slic3r::store_stl(path.c_str(), &src_mesh, true));
+		WHEN("STL file is read") {
+			TriangleMesh mesh;
+			bool ret = mesh.ReadSTLFile(path.c_str());
+			boost::filesystem::remove(path);
+			THEN("the mesh matches the stored mesh") {
+				REQUIRE(ret);
+				REQUIRE(mesh.facets_count() == src_mesh.facets_count());
+				REQUIRE(is_approx(mesh.stats().min, src_mesh.stats().min));
+				REQUIRE(is_approx(mesh.stats().max, src_mesh.stats().max));
+				REQUIRE(mesh.volume() == Approx(src_mesh.volume()));
+			}
+		}
+	}
+}
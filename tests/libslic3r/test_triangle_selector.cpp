@@ -0,0 +1,49 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleSelector.hpp"
+
+using namespace Slic3r;
+
+// Paint spots of several states on a sphere by the sphere cursor, splitting the triangles of the mesh.
+static TriangleSelector::TriangleSplittingData paint_sphere(const TriangleMesh &mesh)
+{
+    TriangleSelector selector(mesh);
+    selector.set_edge_limit(0.5f);
+    const indexed_triangle_set &its    = mesh.its;
+    const int                   facets = int(its.indices.size());
+    for (auto [facet_idx, state] : { std::make_pair(0, TriangleStateType::ENFORCER),
+                                     std::make_pair(facets / 3, TriangleStateType::BLOCKER),
+                                     std::make_pair(facets / 2, TriangleStateType::Extruder3),
+                                     std::make_pair(2 * facets / 3, TriangleStateType::ENFORCER) }) {
+        const stl_triangle_vertex_indices &face   = its.indices[facet_idx];
+        const Vec3f                        center = (its.vertices[face(0)] + its.vertices[face(1)] + its.vertices[face(2)]) / 3.f;
+        selector.select_patch(facet_idx,
+            TriangleSelector::SinglePointCursor::cursor_factory(center, 2.f * center, 2.f, TriangleSelector::CursorType::SPHERE, Transform3d::Identity(), TriangleSelector::ClippingPlane()),
+            state, Transform3d::Identity(), true);
+    }
+    return selector.serialize();
+}
+
+TEST_CASE("Deserialization of a single state matches the full deserialization", "[TriangleSelector]") {
+    const TriangleMesh                            mesh = make_sphere(10., PI / 20.);
+    const TriangleSelector::TriangleSplittingData data = paint_sphere(mesh);
+    REQUIRE(! data.triangles_to_split.empty());
+
+    for (TriangleStateType state : { TriangleStateType::ENFORCER, TriangleStateType::BLOCKER, TriangleStateType::Extruder3, TriangleStateType::Extruder5 }) {
+        TriangleSelector full(mesh);
+        full.deserialize(data);
+        TriangleSelector partial(mesh);
+        partial.deserialize(data, state);
+
+        const indexed_triangle_set facets_full    = full.get_facets_strict(state);
+        const indexed_triangle_set facets_partial = partial.get_facets_strict(state);
+        REQUIRE(facets_full.indices.size() == facets_partial.indices.size());
+        REQUIRE(facets_full.vertices.size() == facets_partial.vertices.size());
+        REQUIRE(facets_full.indices.empty() == ! TriangleSelector::has_facets(data, state));
+        // Both facets are emitted in the same order, thus they have to match vertex by vertex.
+        for (size_t facet_idx = 0; facet_idx < facets_full.indices.size(); ++ facet_idx)
+            for (int i = 0; i < 3; ++ i)
+                REQUIRE(facets_full.vertices[facets_full.indices[facet_idx](i)] == facets_partial.vertices[facets_partial.indices[facet_idx](i)]);
+    }
+}
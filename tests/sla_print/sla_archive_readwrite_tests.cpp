@@ -6,8 +6,13 @@
 #include "libslic3r/Format/SLAArchiveFormatRegistry.hpp"
 #include "libslic3r/Format/SLAArchiveWriter.hpp"
 #include "libslic3r/Format/SLAArchiveReader.hpp"
+#include "libslic3r/Format/ZipperArchiveImport.hpp"
+
+#include <fstream>
+#include <iterator>
 
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 using namespace Slic3r;
 
@@ -68,3 +73,68 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+static std::string read_file(const std::string &fname)
+{
+    std::ifstream in(fname, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+TEST_CASE("Streamed archive matches the buffered export", "[sla_archives]") {
+    auto registry = registered_sla_archives();
+
+    for (const ArchiveEntry &entry : registry) {
+        INFO(std::string("Testing archive type: ") + entry.id);
+        SLAPrint print;
+        SLAFullPrintConfig fullcfg;
+
+        auto m = Model::read_from_file(TEST_DATA_DIR PATH_SEPARATOR + std::string("extruder_idler.obj"), nullptr);
+
+        fullcfg.printer_technology.setInt(ptSLA);
+        fullcfg.set("sla_archive_format", entry.id);
+        fullcfg.set("supports_enable", false);
+        fullcfg.set("pad_enable", false);
+
+        DynamicPrintConfig cfg;
+        cfg.apply(fullcfg);
+
+        // Thumbnail of the size expected by the Anycubic preview.
+        ThumbnailsList thumbnails(1);
+        thumbnails.front().set(224, 168);
+        for (size_t i = 0; i < thumbnails.front().pixels.size(); ++ i)
+            thumbnails.front().pixels[i] = (unsigned char)(i % 251);
+
+        print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+        print.apply(m, cfg);
+        print.process();
+
+        const std::string buffered = std::string("output_buffered.") + entry.ext;
+        const std::string streamed = std::string("output_streamed.") + entry.ext;
+        print.export_print(buffered, thumbnails, "extruder_idler");
+
+        print.set_streaming_export(streamed, thumbnails, "extruder_idler");
+        print.process();
+        REQUIRE(boost::filesystem::exists(streamed));
+        // The archive is already written, exporting into the same file does nothing.
+        print.export_print(streamed, thumbnails, "extruder_idler");
+
+        const std::string data_buffered = read_file(buffered);
+        const std::string data_streamed = read_file(streamed);
+        REQUIRE(! data_buffered.empty());
+
+        if (boost::starts_with(data_buffered, "PK")) {
+            // The zip headers and config.ini / config.json carry the time of
+            // the export, compare the contents of the other entries.
+            ZipperArchive arch_buffered = read_zipper_archive(buffered, {""}, {"config"});
+            ZipperArchive arch_streamed = read_zipper_archive(streamed, {""}, {"config"});
+            REQUIRE(arch_buffered.profile == arch_streamed.profile);
+            REQUIRE(arch_buffered.entries.size() == arch_streamed.entries.size());
+            REQUIRE(arch_buffered.entries.size() > 1);
+            for (size_t i = 0; i < arch_buffered.entries.size(); ++ i) {
+                REQUIRE(arch_buffered.entries[i].fname == arch_streamed.entries[i].fname);
+                REQUIRE(arch_buffered.entries[i].buf == arch_streamed.entries[i].buf);
+            }
+        } else
+            REQUIRE(data_buffered == data_streamed);
+    }
+}
@@ -6,6 +6,7 @@
 #include "sla_test_utils.hpp"
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
+#include <libslic3r/SLA/ScanlineRaster.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
 
@@ -252,6 +253,133 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
 }
 
 
+TEST_CASE("ScanlineRasterShouldMatchAGG", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+
+    // Many small rings and two large squares with holes, partially out of the display.
+    ExPolygons layer;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(-70., 70.), rad(.05, 2.);
+    for (int i = 0; i < 500; ++ i) {
+        ExPolygon ring = square_with_hole(rad(rng));
+        ring.rotate(pos(rng));
+        ring.translate(scaled(pos(rng)), scaled(pos(rng)));
+        layer.emplace_back(std::move(ring));
+    }
+    layer.emplace_back(square_with_hole(30.));
+    layer.back().translate(scaled(-50.), scaled(20.));
+    layer.emplace_back(square_with_hole(40.));
+    layer.back().rotate(.3);
+
+    // Gamma 1 is the default, zero gamma means thresholding at half coverage, see create_raster_grayscale_aa().
+    for (double gamma : {1., 0., .5, 2.})
+        for (auto orientation : {sla::RasterBase::roLandscape, sla::RasterBase::roPortrait})
+            for (const auto &mirror : {sla::RasterBase::NoMirror, sla::RasterBase::MirrorXY}) {
+                sla::RasterBase::Trafo trafo{orientation, mirror};
+                trafo.center_x = bb.center().x();
+                trafo.center_y = bb.center().y();
+
+                std::unique_ptr<sla::RasterGrayscaleAA> raster_agg;
+                if (gamma > 0)
+                    raster_agg = std::make_unique<sla::RasterGrayscaleAAGammaPower>(res, pixdim, trafo, gamma);
+                else
+                    raster_agg = std::make_unique<sla::RasterGrayscaleAA>(res, pixdim, trafo, agg::gamma_threshold(.5));
+                sla::RasterGrayscaleAAScanline raster_scanline(res, pixdim, trafo, gamma);
+                for (const ExPolygon &expoly : layer) {
+                    raster_agg->draw(expoly);
+                    raster_scanline.draw(expoly);
+                }
+
+                // AGG computes the coverage at 1/256 of a pixel, the scanline
+                // rasterizer exactly, thus only the edge pixels may differ slightly
+                // before the gamma is applied. The gamma function scales the difference.
+                auto apply_gamma = [gamma](int cover) {
+                    double v = double(cover) / 255.;
+                    return int((gamma > 0 ? std::pow(v, gamma) : (v < .5 ? 0. : 1.)) * 255. + .5);
+                };
+                int max_diff_allowed = 0;
+                for (int cover = 0; cover + 4 < 256; ++ cover)
+                    max_diff_allowed = std::max(max_diff_allowed, apply_gamma(cover + 4) - apply_gamma(cover));
+
+                int  max_diff     = 0;
+                long sum_agg      = 0;
+                long sum_scanline = 0;
+                long num_lit      = 0;
+                long num_mismatch = 0;
+                for (size_t row = 0; row < res.height_px; ++ row)
+                    for (size_t col = 0; col < res.width_px; ++ col) {
+                        int px_agg      = raster_agg->read_pixel(col, row);
+                        int px_scanline = raster_scanline.read_pixel(col, row);
+                        int diff        = std::abs(px_agg - px_scanline);
+                        max_diff = std::max(max_diff, diff);
+                        sum_agg += px_agg;
+                        sum_scanline += px_scanline;
+                        if (px_agg > 0)
+                            ++ num_lit;
+                        if (diff > 4)
+                            ++ num_mismatch;
+                    }
+                REQUIRE(sum_agg > 0);
+                REQUIRE(max_diff <= std::max(max_diff_allowed, 4));
+                if (gamma == 1.) {
+                    REQUIRE(num_mismatch == 0);
+                    REQUIRE(std::abs(sum_agg - sum_scanline) < sum_agg / 1000);
+                } else {
+                    // Only the pixels close to the steep parts of the gamma function may differ more,
+                    // with thresholding these are the edge pixels covered by about a half.
+                    REQUIRE(num_mismatch < num_lit / 100);
+                    REQUIRE(std::abs(sum_agg - sum_scanline) < sum_agg / 100);
+                }
+            }
+}
+
+TEST_CASE("Hollowing grid is reused while the wall parameters change", "[Hollowing]") {
+    TriangleMesh mesh = load_model("20mm_cube.obj");
+    auto         csgmesh = std::array{ csg::CSGPart{&mesh.its} };
+
+    // Above 3.5mm, get_voxel_scale() does not depend on the thickness.
+    sla::HollowingConfig hcfg{4., 0.5, 2.};
+    sla::HollowingGrid   grid;
+    sla::update_hollowing_grid(grid, range(csgmesh), hcfg);
+    REQUIRE(grid.grid);
+    const double voxel_scale = grid.voxel_scale;
+
+    // Move the thickness back and forth like by the slider. The interior has to be
+    // the same as the one generated from scratch, whatever the order of the changes.
+    for (auto [thickness, closing] : { std::make_pair(5., 2.), std::make_pair(3.5, 0.), std::make_pair(4.5, 0.),
+                                       std::make_pair(3.6, 1.), std::make_pair(4., 2.) }) {
+        hcfg.min_thickness    = thickness;
+        hcfg.closing_distance = closing;
+        std::shared_ptr<VoxelGrid> gridptr = grid.grid;
+        // This is what SLAPrint::Steps::hollow_model() does.
+        sla::update_hollowing_grid(grid, range(csgmesh), hcfg);
+        REQUIRE(grid.grid == gridptr);
+        REQUIRE(grid.voxel_scale == voxel_scale);
+
+        sla::InteriorPtr reused = sla::generate_interior(grid, hcfg);
+        sla::InteriorPtr fresh  = sla::generate_interior(mesh.its, hcfg);
+        REQUIRE(reused);
+        REQUIRE(fresh);
+        REQUIRE(sla::get_mesh(*reused).vertices == sla::get_mesh(*fresh).vertices);
+        REQUIRE(sla::get_mesh(*reused).indices == sla::get_mesh(*fresh).indices);
+    }
+
+    // A thinner wall needs a finer grid, the mesh is voxelized again.
+    hcfg.min_thickness = 2.;
+    sla::update_hollowing_grid(grid, range(csgmesh), hcfg);
+    REQUIRE(grid.voxel_scale > voxel_scale);
+    REQUIRE(grid.voxel_scale == sla::get_voxel_scale(its_volume(mesh.its), hcfg));
+
+    // So does changing the quality.
+    const double thin_voxel_scale = grid.voxel_scale;
+    hcfg.quality = 0.8;
+    sla::update_hollowing_grid(grid, range(csgmesh), hcfg);
+    REQUIRE(grid.voxel_scale > thin_voxel_scale);
+}
+
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
 
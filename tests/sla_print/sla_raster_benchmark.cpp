@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+
+#include "libslic3r/SLA/AGGRaster.hpp"
+#include "libslic3r/SLA/ScanlineRaster.hpp"
+
+using namespace Slic3r;
+
+// Layer of a batch of small parts on a 12K display: thousands of thin rings
+// (dental shells, jewelry) of various sizes spread over the whole display.
+static ExPolygons generate_layer(double disp_w, double disp_h, int num_parts)
+{
+    ExPolygons layer;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> pos_x(-disp_w / 2., disp_w / 2.), pos_y(-disp_h / 2., disp_h / 2.), rad(.1, 1.5);
+    for (int i = 0; i < num_parts; ++ i) {
+        const double r     = rad(rng);
+        const Vec2d  c     = { pos_x(rng), pos_y(rng) };
+        const int    steps = 16 + int(64. * r);
+        ExPolygon    ring;
+        ring.holes.emplace_back();
+        for (int j = 0; j < steps; ++ j) {
+            const double a = 2. * PI * j / steps;
+            ring.contour.points.emplace_back(scaled(c.x() + r * std::cos(a)), scaled(c.y() + r * std::sin(a)));
+            ring.holes.front().points.emplace_back(scaled(c.x() + .6 * r * std::cos(-a)), scaled(c.y() + .6 * r * std::sin(-a)));
+        }
+        layer.emplace_back(std::move(ring));
+    }
+    return layer;
+}
+
+TEST_CASE("Rasterization of a layer with many small features", "[SLARasterOutput][.Benchmarks]") {
+    const double    disp_w = 218.88, disp_h = 122.88;
+    sla::Resolution res{11520, 5120};
+    sla::PixelDim   pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    sla::RasterBase::Trafo trafo;
+
+    const ExPolygons layer = generate_layer(disp_w, disp_h, 5000);
+
+    auto draw_agg = [&]() {
+        sla::RasterGrayscaleAAGammaPower raster(res, pixdim, trafo, 1.);
+        for (const ExPolygon &expoly : layer)
+            raster.draw(expoly);
+        return raster.read_pixel(0, 0);
+    };
+    auto draw_scanline = [&]() {
+        sla::RasterGrayscaleAAScanline raster(res, pixdim, trafo, 1.);
+        for (const ExPolygon &expoly : layer)
+            raster.draw(expoly);
+        return raster.read_pixel(0, 0);
+    };
+
+    {
+        // The two rasters may only differ in the antialiasing of the edges.
+        sla::RasterGrayscaleAAGammaPower raster_agg(res, pixdim, trafo, 1.);
+        sla::RasterGrayscaleAAScanline   raster_scanline(res, pixdim, trafo, 1.);
+        for (const ExPolygon &expoly : layer) {
+            raster_agg.draw(expoly);
+            raster_scanline.draw(expoly);
+        }
+
+        int max_diff = 0;
+        for (size_t row = 0; row < res.height_px; ++ row)
+            for (size_t col = 0; col < res.width_px; ++ col)
+                max_diff = std::max(max_diff, std::abs(int(raster_agg.read_pixel(col, row)) - int(raster_scanline.read_pixel(col, row))));
+        REQUIRE(max_diff <= 4);
+    }
+
+    BENCHMARK("AGG rasterizer") {
+        return draw_agg();
+    };
+    BENCHMARK("Scanline rasterizer") {
+        return draw_scanline();
+    };
+}
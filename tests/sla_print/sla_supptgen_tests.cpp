@@ -5,6 +5,8 @@
 #include <libslic3r/BoundingBox.hpp>
 #include <libslic3r/SLA/SpatIndex.hpp>
 
+#include <oneapi/tbb/task_arena.h>
+
 #include "sla_test_utils.hpp"
 
 namespace Slic3r { namespace sla {
@@ -139,4 +141,29 @@ TEST_CASE("Two parallel plates should be supported", "[SupGen][Hollowed]")
     REQUIRE(!pts.empty());
 }
 
+TEST_CASE("Island stacks processed in parallel give the same points for any thread count", "[SupGen]")
+{
+    // A plate of lifted plates of several sizes, some of them too close to each other to be processed separately.
+    TriangleMesh mesh;
+    for (int i = 0; i < 5; ++ i)
+        for (int j = 0; j < 5; ++ j) {
+            TriangleMesh plate = make_cube(4. + i, 4. + j, 1.);
+            plate.translate(float(10 * i), float(12 * j), float(2 + i + j));
+            mesh.merge(plate);
+        }
+
+    sla::SupportPointGenerator::Config cfg;
+    cfg.parallel_island_stacks = true;
+
+    sla::SupportPoints pts_single;
+    tbb::task_arena(1).execute([&]() { pts_single = calc_support_pts(mesh, cfg); });
+    sla::SupportPoints pts = calc_support_pts(mesh, cfg);
+
+    REQUIRE(!pts.empty());
+    REQUIRE(pts.size() == pts_single.size());
+    for (size_t i = 0; i < pts.size(); ++ i)
+        REQUIRE(pts[i] == pts_single[i]);
+    REQUIRE(min_point_distance(pts) >= cfg.minimal_distance);
+}
+
 }} // namespace Slic3r::sla